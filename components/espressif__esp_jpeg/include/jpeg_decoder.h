@@ -53,6 +53,10 @@ typedef struct esp_jpeg_image_cfg_s {
                                          Tjpgd does not use dynamic allocation, se we pass this buffer to Tjpgd that uses it as scratchpad */
         size_t working_buffer_size; /*!< Size of the working buffer. Must be set it working_buffer != NULL.
                                          Default size is 3.1kB or 65kB if JD_FASTDECODE == 2 */
+        void *fast_working_buffer;  /*!< Optional small buffer (ideally internal RAM) for the hot parts of the working memory:
+                                         input buffer, dequantizer tables, fast Huffman LUTs and the IDCT/MCU buffers.
+                                         Whatever does not fit is taken from working_buffer. Ignored with CONFIG_JD_USE_ROM */
+        size_t fast_working_buffer_size; /*!< Size of fast_working_buffer. About 9.5kB covers a 4:2:0 image if JD_FASTDECODE == 2 */
     } advanced;
 
     struct {
@@ -67,6 +71,11 @@ typedef struct esp_jpeg_image_output_s {
     uint16_t width;    /*!< Width of the output image */
     uint16_t height;   /*!< Height of the output image */
     size_t output_len; /*!< Length of the output image in bytes */
+    struct {
+        uint32_t prepare_us;    /*!< Time spent parsing headers and building tables (jd_prepare) */
+        uint32_t mcu_load_us;   /*!< Time spent in entropy decoding and IDCT */
+        uint32_t mcu_output_us; /*!< Time spent in colour conversion and copying to the output buffer */
+    } timing;           /*!< Filled by esp_jpeg_decode() only when CONFIG_JD_PROFILE is enabled, zero otherwise */
 } esp_jpeg_image_output_t;
 
 /**
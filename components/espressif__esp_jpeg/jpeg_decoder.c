@@ -12,6 +12,9 @@
 #include "esp_err.h"
 #include "esp_check.h"
 #include "jpeg_decoder.h"
+#if CONFIG_JD_PROFILE
+#include "esp_timer.h"
+#endif
 
 #if CONFIG_JD_USE_ROM
 /* When supported in ROM, use ROM functions */
@@ -23,12 +26,15 @@
 
 /* The ROM code of TJPGD is older and has different return type in decode callback */
 typedef unsigned int jpeg_decode_out_t;
+typedef unsigned int jpeg_decode_in_t;
 #else
 /* When Tiny JPG Decoder is not in ROM or selected external code */
 #include "tjpgd.h"
 
 /* The TJPGD outside the ROM code is newer and has different return type in decode callback */
 typedef int jpeg_decode_out_t;
+/* ... and uses size_t for the input callback (same as unsigned int on the device, not on 64-bit hosts) */
+typedef size_t jpeg_decode_in_t;
 #endif
 
 static const char *TAG = "JPEG";
@@ -36,7 +42,7 @@ static const char *TAG = "JPEG";
 #define LOBYTE(u16)     ((uint8_t)(((uint16_t)(u16)) & 0xff))
 #define HIBYTE(u16)     ((uint8_t)((((uint16_t)(u16))>>8) & 0xff))
 
-#if defined(JD_FASTDECODE) && (JD_FASTDECODE == 2)
+#if defined(JD_FASTDECODE) && (JD_FASTDECODE >= 2)
 #define JPEG_WORK_BUF_SIZE  65472
 #else
 #define JPEG_WORK_BUF_SIZE  3100    /* Recommended buffer size; Independent on the size of the image */
@@ -53,19 +59,32 @@ static const char *TAG = "JPEG";
 #elif  (JD_FORMAT==1)
 #define ESP_JPEG_COLOR_BYTES    2
 #elif  (JD_FORMAT==2)
-#error Grayscale image output format is not supported
 #define ESP_JPEG_COLOR_BYTES    1
 #endif
 
+/* Luminance output from tjpgd (grayscale format, or monochrome images with JD_MONO_LUMA), expanded through a table */
+#if !CONFIG_JD_USE_ROM && (JD_FORMAT == 2 || JD_MONO_LUMA)
+#define ESP_JPEG_LUMA_OUT       1
+#else
+#define ESP_JPEG_LUMA_OUT       0
+#endif
+
 /*******************************************************************************
 * Function definitions
 *******************************************************************************/
 static uint8_t jpeg_get_div_by_scale(esp_jpeg_image_scale_t scale);
 static uint8_t jpeg_get_color_bytes(esp_jpeg_image_format_t format);
 
-static unsigned int jpeg_decode_in_cb(JDEC *jd, uint8_t *buff, unsigned int nbyte);
+static jpeg_decode_in_t jpeg_decode_in_cb(JDEC *jd, uint8_t *buff, jpeg_decode_in_t nbyte);
 static jpeg_decode_out_t jpeg_decode_out_cb(JDEC *jd, void *bitmap, JRECT *rect);
 static inline uint16_t ldb_word(const void *ptr);
+#if ESP_JPEG_LUMA_OUT
+static jpeg_decode_out_t jpeg_decode_out_luma(JDEC *jd, esp_jpeg_image_cfg_t *cfg, const uint8_t *in, JRECT *rect);
+
+/* Grey RGB565 pixel of each luminance value, as stored in the output buffer: [0] native, [1] byte-swapped */
+static uint16_t s_luma_565[2][256];
+static bool s_luma_565_ready = false;
+#endif
 /*******************************************************************************
 * Public API functions
 *******************************************************************************/
@@ -92,10 +111,28 @@ esp_err_t esp_jpeg_decode(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *im
 
 
     cfg->priv.read = 0;
+    memset(&img->timing, 0, sizeof(img->timing));
 
     /* Prepare image */
+#if CONFIG_JD_PROFILE
+    const int64_t prepare_start = esp_timer_get_time();
+#endif
+#if CONFIG_JD_USE_ROM
     res = jd_prepare(&JDEC, jpeg_decode_in_cb, workbuf, workbuf_size, cfg);
+#else
+#if JD_TRACE
+    jd_trace(JD_TRACE_PREPARE, 1, 0);
+#endif
+    res = jd_prepare_ex(&JDEC, jpeg_decode_in_cb, workbuf, workbuf_size,
+                        cfg->advanced.fast_working_buffer, cfg->advanced.fast_working_buffer_size, cfg);
+#if JD_TRACE
+    jd_trace(JD_TRACE_PREPARE, 0, 0);
+#endif
+#endif
     ESP_GOTO_ON_FALSE((res == JDR_OK), ESP_FAIL, err, TAG, "Error in preparing JPEG image! %d", res);
+#if CONFIG_JD_PROFILE
+    img->timing.prepare_us = (uint32_t)(esp_timer_get_time() - prepare_start);
+#endif
 
     const uint8_t scale_div       = jpeg_get_div_by_scale(cfg->out_scale);
     const uint8_t out_color_bytes = jpeg_get_color_bytes(cfg->out_format);
@@ -109,9 +146,30 @@ esp_err_t esp_jpeg_decode(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *im
     img->width = JDEC.width / scale_div;
     img->output_len = outsize;
 
+#if ESP_JPEG_LUMA_OUT
+    if (JD_MONO_OUT(&JDEC) && !s_luma_565_ready) {
+        for (int l = 0; l < 256; l++) {
+            uint16_t color = ((l & 0xF8) << 8) | ((l & 0xFC) << 3) | (l >> 3);
+            s_luma_565[0][l] = color;
+            s_luma_565[1][l] = (uint16_t)(color << 8 | color >> 8);
+        }
+        s_luma_565_ready = true;
+    }
+#endif
+
     /* Decode JPEG */
+#if JD_TRACE
+    jd_trace(JD_TRACE_DECOMP, 1, 0);
+#endif
     res = jd_decomp(&JDEC, jpeg_decode_out_cb, cfg->out_scale);
+#if JD_TRACE
+    jd_trace(JD_TRACE_DECOMP, 0, 0);
+#endif
     ESP_GOTO_ON_FALSE((res == JDR_OK), ESP_FAIL, err, TAG, "Error in decoding JPEG image! %d", res);
+#if CONFIG_JD_PROFILE
+    img->timing.mcu_load_us = JDEC.t_load;
+    img->timing.mcu_output_us = JDEC.t_output;
+#endif
 
 err:
     if (workbuf && allocate_buffer) {
@@ -164,11 +222,18 @@ esp_err_t esp_jpeg_get_image_info(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_outp
     return ret;
 }
 
+#if JD_TRACE
+/* Default trace hook; the application provides its own to record decode spans */
+__attribute__((weak)) void jd_trace(uint8_t point, uint8_t begin, uint16_t arg)
+{
+}
+#endif
+
 /*******************************************************************************
 * Private API functions
 *******************************************************************************/
 
-static unsigned int jpeg_decode_in_cb(JDEC *dec, uint8_t *buff, unsigned int nbyte)
+static jpeg_decode_in_t jpeg_decode_in_cb(JDEC *dec, uint8_t *buff, jpeg_decode_in_t nbyte)
 {
     assert(dec != NULL);
 
@@ -202,6 +267,12 @@ static jpeg_decode_out_t jpeg_decode_out_cb(JDEC *dec, void *bitmap, JRECT *rect
     assert(bitmap != NULL);
     assert(rect != NULL);
 
+#if ESP_JPEG_LUMA_OUT
+    if (JD_MONO_OUT(dec)) {
+        return jpeg_decode_out_luma(dec, cfg, bitmap, rect);
+    }
+#endif
+
     uint8_t scale_div = jpeg_get_div_by_scale(cfg->out_scale);
     uint8_t out_color_bytes = jpeg_get_color_bytes(cfg->out_format);
 
@@ -246,6 +317,36 @@ static jpeg_decode_out_t jpeg_decode_out_cb(JDEC *dec, void *bitmap, JRECT *rect
     return 1;
 }
 
+#if ESP_JPEG_LUMA_OUT
+/* One luminance byte per pixel: grey RGB565 from the table, or the byte three times for RGB888 */
+static jpeg_decode_out_t jpeg_decode_out_luma(JDEC *dec, esp_jpeg_image_cfg_t *cfg, const uint8_t *in, JRECT *rect)
+{
+    const uint32_t line = dec->width / jpeg_get_div_by_scale(cfg->out_scale);
+    const unsigned int w = rect->right - rect->left + 1;
+
+    if (cfg->out_format == JPEG_IMAGE_FORMAT_RGB565) {
+        const uint16_t *lut = s_luma_565[cfg->flags.swap_color_bytes ? 1 : 0];
+        for (int y = rect->top; y <= rect->bottom; y++) {
+            uint16_t *dst = (uint16_t *)cfg->outbuf + y * line + rect->left;
+            for (unsigned int x = 0; x < w; x++) {
+                dst[x] = lut[in[x]];
+            }
+            in += w;
+        }
+    } else {
+        for (int y = rect->top; y <= rect->bottom; y++) {
+            uint8_t *dst = cfg->outbuf + (y * line + rect->left) * 3;
+            for (unsigned int x = 0; x < w; x++) {
+                dst[0] = dst[1] = dst[2] = in[x];
+                dst += 3;
+            }
+            in += w;
+        }
+    }
+    return 1;
+}
+#endif
+
 static uint8_t jpeg_get_div_by_scale(esp_jpeg_image_scale_t scale)
 {
     switch (scale) {
@@ -22,12 +22,17 @@
 / Jun 11, 2021 R0.02a Some performance improvement.
 / Jul 01, 2021 R0.03  Added JD_FASTDECODE option.
 /                     Some performance improvement.
+/                     JD_FASTDECODE 3: 64-bit bit reservoir and AC table resolving the value bits.
 /----------------------------------------------------------------------------*/
 
 #include "tjpgd.h"
 
+#if JD_PROFILE
+#include "esp_timer.h"
+#define JD_TIMESTAMP()  ((uint32_t)esp_timer_get_time())   /* Microsecond time stamp for stage profiling */
+#endif
 
-#if JD_FASTDECODE == 2
+#if JD_FASTDECODE >= 2
 #define HUFF_BIT    10  /* Bit length to apply fast huffman decode */
 #define HUFF_LEN    (1 << HUFF_BIT)
 #define HUFF_MASK   (HUFF_LEN - 1)
@@ -153,6 +158,31 @@ static void *alloc_pool (   /* Pointer to allocated memory block (NULL:no memory
 }
 
 
+/*-----------------------------------------------------------------------*/
+/* Allocate a memory block from the fast pool (falls back to main pool)  */
+/*-----------------------------------------------------------------------*/
+
+static void *alloc_pool_fast (  /* Pointer to allocated memory block (NULL:no memory available) */
+    JDEC *jd,               /* Pointer to the decompressor object */
+    size_t ndata            /* Number of bytes to allocate */
+)
+{
+    char *rp;
+
+
+    ndata = (ndata + 3) & ~3;           /* Align block size to the word boundary */
+
+    if (jd->sz_pool_fast >= ndata) {
+        jd->sz_pool_fast -= ndata;
+        rp = (char *)jd->pool_fast;     /* Get start of available fast memory */
+        jd->pool_fast = (void *)(rp + ndata);
+        return (void *)rp;
+    }
+
+    return alloc_pool(jd, ndata);   /* Fast pool exhausted or not given */
+}
+
+
 
 #if JD_DEFAULT_HUFFMAN
 /*-----------------------------------------------------------------------*/
@@ -249,7 +279,7 @@ static JRESULT create_qt_tbl (  /* 0:OK, !0:Failed */
             return JDR_FMT1;    /* Err: not 8-bit resolution */
         }
         i = d & 3;                              /* Get table ID */
-        pb = alloc_pool(jd, 64 * sizeof (int32_t));/* Allocate a memory block for the table */
+        pb = alloc_pool_fast(jd, 64 * sizeof (int32_t));/* Allocate a memory block for the table (hot in IDCT) */
         if (!pb) {
             return JDR_MEM1;    /* Err: not enough memory */
         }
@@ -330,21 +360,22 @@ static JRESULT create_huffman_tbl ( /* 0:OK, !0:Failed */
             }
             pd[i] = d;
         }
-#if JD_FASTDECODE == 2
+#if JD_FASTDECODE >= 2
         { /* Create fast huffman decode table */
             unsigned int span, td, ti;
-            uint16_t *tbl_ac = 0;
+            jd_hufflut_t *tbl_ac = 0;
             uint8_t *tbl_dc = 0;
 
             if (cls) {
-                tbl_ac = alloc_pool(jd, HUFF_LEN * sizeof (uint16_t));  /* LUT for AC elements */
+                tbl_ac = alloc_pool_fast(jd, HUFF_LEN * sizeof (jd_hufflut_t)); /* LUT for AC elements */
                 if (!tbl_ac) {
                     return JDR_MEM1;    /* Err: not enough memory */
                 }
                 jd->hufflut_ac[num] = tbl_ac;
-                memset(tbl_ac, 0xFF, HUFF_LEN * sizeof (uint16_t));     /* Default value (0xFFFF: may be long code) */
+                /* Default value (0xFFFF / 0: may be long code) */
+                memset(tbl_ac, JD_FASTDECODE == 2 ? 0xFF : 0, HUFF_LEN * sizeof (jd_hufflut_t));
             } else {
-                tbl_dc = alloc_pool(jd, HUFF_LEN * sizeof (uint8_t));   /* LUT for AC elements */
+                tbl_dc = alloc_pool_fast(jd, HUFF_LEN * sizeof (uint8_t));      /* LUT for DC elements */
                 if (!tbl_dc) {
                     return JDR_MEM1;    /* Err: not enough memory */
                 }
@@ -356,7 +387,25 @@ static JRESULT create_huffman_tbl ( /* 0:OK, !0:Failed */
                     ti = ph[i] << (HUFF_BIT - 1 - b) & HUFF_MASK;   /* Index of input pattern for the code */
                     if (cls) {
                         td = pd[i++] | ((b + 1) << 8);  /* b15..b8: code length, b7..b0: zero run and data length */
+#if JD_FASTDECODE == 3
+                        /* When the data bits follow the code within HUFF_BIT, they are part of the index too:
+                           b31..b16: the element value, b15..b12: code + data length */
+                        unsigned int nd = td & 0x0F, k;
+                        int v;
+
+                        for (k = 0; k < 1U << (HUFF_BIT - 1 - b); k++) {
+                            tbl_ac[ti + k] = td;
+                            if (nd && b + 1 + nd <= HUFF_BIT) {
+                                v = (int)(k >> (HUFF_BIT - 1 - b - nd));    /* Data bits */
+                                if (!(v >> (nd - 1))) {
+                                    v -= (1 << nd) - 1;    /* Restore negative value if needed */
+                                }
+                                tbl_ac[ti + k] = td | (b + 1 + nd) << 12 | (uint32_t)(v & 0xFFFF) << 16;
+                            }
+                        }
+#else
                         for (span = 1 << (HUFF_BIT - 1 - b); span; span--, tbl_ac[ti++] = (uint16_t)td) ;
+#endif
                     } else {
                         td = pd[i++] | ((b + 1) << 4);  /* b7..b4: code length, b3..b0: data length */
                         for (span = 1 << (HUFF_BIT - 1 - b); span; span--, tbl_dc[ti++] = (uint8_t)td) ;
@@ -374,6 +423,7 @@ static JRESULT create_huffman_tbl ( /* 0:OK, !0:Failed */
 
 
 
+#if JD_FASTDECODE <= 2
 /*-----------------------------------------------------------------------*/
 /* Extract a huffman decoded data from input stream                      */
 /*-----------------------------------------------------------------------*/
@@ -617,6 +667,238 @@ static int bitext ( /* >=0: extracted data, <0: error code */
 #endif
 }
 
+#else
+/*-----------------------------------------------------------------------*/
+/* Top up the 64-bit bit reservoir (JD_FASTDECODE 3)                     */
+/*-----------------------------------------------------------------------*/
+
+static uint64_t load_be64 (const uint8_t *p)
+{
+    uint64_t v;
+
+    memcpy(&v, p, 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static int wreg_fill (  /* 0:OK, <0: error code */
+    JDEC *jd,           /* Pointer to the decompressor object */
+    unsigned int nbit   /* Number of bits the caller needs (1 to 16) */
+)
+{
+    size_t dc = jd->dctr;
+    uint8_t *dp = jd->dptr;
+    unsigned int d, nb, flg = 0, wbit = jd->dbit;
+    uint64_t w = jd->wreg, v, ff;
+
+
+    if (!jd->marker && dc >= 8) {   /* Whole bytes that fit, in one go if none of them is 0xFF */
+        nb = (63 - wbit) / 8;
+        v = load_be64(dp);
+        ff = ~v;                    /* 0xFF bytes are now zero bytes */
+        ff = (ff - 0x0101010101010101ULL) & ~ff & 0x8080808080808080ULL;
+        if (nb && !(ff >> (64 - nb * 8))) {
+            jd->wreg = w << (nb * 8) | v >> (64 - nb * 8);
+            jd->dbit = wbit + nb * 8;
+            jd->dptr = dp + nb; jd->dctr = dc - nb;
+            return 0;
+        }
+    }
+
+    while (wbit <= 56) {    /* A byte at a time around markers, byte stuffing and buffer ends */
+        if (jd->marker) {
+            d = 0xFF;   /* Input stream has stalled for a marker. Generate stuff bits */
+        } else {
+            if (!dc) {  /* Buffer empty, re-fill input buffer */
+                dp = jd->inbuf;                     /* Top of input buffer */
+                dc = jd->infunc(jd, dp, JD_SZBUF);
+                if (!dc) {
+                    if (wbit >= nbit) {
+                        break;      /* Enough for now, the stream may simply end here */
+                    }
+                    return 0 - (int)JDR_INP;    /* Err: read error or wrong stream termination */
+                }
+            }
+            d = *dp++; dc--;
+            if (flg) {      /* In flag sequence? */
+                flg = 0;    /* Exit flag sequence */
+                if (d != 0) {
+                    jd->marker = d;    /* Not an escape of 0xFF but a marker */
+                }
+                d = 0xFF;
+            } else {
+                if (d == 0xFF) {        /* Is start of flag sequence? */
+                    flg = 1; continue;  /* Enter flag sequence, get trailing byte */
+                }
+            }
+        }
+        w = w << 8 | d; /* Shift 8 bits in the reservoir */
+        wbit += 8;
+    }
+    jd->wreg = w; jd->dbit = wbit;
+    jd->dctr = dc; jd->dptr = dp;
+
+    return 0;
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Extract a huffman decoded data from the bit reservoir                 */
+/*-----------------------------------------------------------------------*/
+
+/* Incremental search for the codes longer than HUFF_BIT (at least 16 bits in the reservoir) */
+static int huffext_long (   /* >=0: decoded data, <0: error code */
+    JDEC *jd,           /* Pointer to the decompressor object */
+    unsigned int id,    /* Table ID (0:Y, 1:C) */
+    unsigned int cls    /* Table class (0:DC, 1:AC) */
+)
+{
+    const uint8_t *hb = jd->huffbits[id][cls] + HUFF_BIT;                           /* Bit distribution table */
+    const uint16_t *hc = jd->huffcode[id][cls] + jd->longofs[id][cls];              /* Code word table */
+    const uint8_t *hd = jd->huffdata[id][cls] + jd->longofs[id][cls];               /* Data table */
+    unsigned int d, nc, bl, wbit = jd->dbit;
+
+
+    for (bl = HUFF_BIT + 1; bl <= 16; bl++) {
+        nc = *hb++;
+        if (nc) {
+            d = (unsigned int)(jd->wreg >> (wbit - bl)) & ((1U << bl) - 1);
+            do {    /* Search the code word in this bit length */
+                if (d == *hc++) {       /* Matched? */
+                    jd->dbit = wbit - bl;   /* Snip the huffman code */
+                    return *hd;         /* Return the decoded data */
+                }
+                hd++;
+            } while (--nc);
+        }
+    }
+
+    return 0 - (int)JDR_FMT1;   /* Err: code not found (may be collapted data) */
+}
+
+static int huffext (    /* >=0: decoded data, <0: error code */
+    JDEC *jd,           /* Pointer to the decompressor object */
+    unsigned int id,    /* Table ID (0:Y, 1:C) */
+    unsigned int cls    /* Table class (0:DC, 1:AC) */
+)
+{
+    unsigned int d, wbit;
+    int e;
+
+
+    if (jd->dbit < 16) {
+        e = wreg_fill(jd, 16);
+        if (e < 0) {
+            return e;
+        }
+    }
+    wbit = jd->dbit;
+    d = (unsigned int)(jd->wreg >> (wbit - HUFF_BIT)) & HUFF_MASK;  /* Short code as table index */
+    if (cls) {  /* AC element (code only, the data bits stay in the reservoir) */
+        d = jd->hufflut_ac[id][d];
+        if (d) {
+            jd->dbit = wbit - (d >> 8 & 0x0F);
+            return d & 0xFF;
+        }
+    } else {    /* DC element */
+        d = jd->hufflut_dc[id][d];
+        if (d != 0xFF) {
+            jd->dbit = wbit - (d >> 4);
+            return d & 0xF;
+        }
+    }
+
+    return huffext_long(jd, id, cls);
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Extract N bits from the bit reservoir                                 */
+/*-----------------------------------------------------------------------*/
+
+static int bitext ( /* >=0: extracted data, <0: error code */
+    JDEC *jd,           /* Pointer to the decompressor object */
+    unsigned int nbit   /* Number of bits to extract (1 to 16) */
+)
+{
+    unsigned int wbit;
+    int e;
+
+
+    if (jd->dbit < nbit) {
+        e = wreg_fill(jd, nbit);
+        if (e < 0) {
+            return e;
+        }
+    }
+    wbit = jd->dbit - nbit;
+    jd->dbit = wbit;
+
+    return (int)(jd->wreg >> wbit) & ((1 << nbit) - 1);
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Extract an AC element: zero run, data length and the signed value     */
+/*-----------------------------------------------------------------------*/
+
+static int acext (      /* >=0: zero run and data length (0:EOB), <0: error code */
+    JDEC *jd,           /* Pointer to the decompressor object */
+    unsigned int id,    /* Table ID (0:Y, 1:C) */
+    int *val            /* Element value when the data length is not 0 */
+)
+{
+    unsigned int d, nd, wbit;
+    int e;
+
+
+    if (jd->dbit < 32) {    /* Room for the longest code and its data bits */
+        e = wreg_fill(jd, 16);
+        if (e < 0) {
+            return e;
+        }
+    }
+    wbit = jd->dbit;
+    d = jd->hufflut_ac[id][(unsigned int)(jd->wreg >> (wbit - HUFF_BIT)) & HUFF_MASK];
+    if (d & 0xF000) {   /* Code and data bits resolved by the table */
+        jd->dbit = wbit - (d >> 12 & 0x0F);
+        *val = (int16_t)(d >> 16);
+        return d & 0xFF;
+    }
+    if (d) {            /* Short code, data bits follow */
+        jd->dbit = wbit - (d >> 8 & 0x0F);
+        d &= 0xFF;
+    } else {
+        e = huffext_long(jd, id, 1);
+        if (e < 0) {
+            return e;
+        }
+        d = (unsigned int)e;
+    }
+
+    nd = d & 0x0F;
+    if (nd) {
+        e = bitext(jd, nd);     /* Extract data bits */
+        if (e < 0) {
+            return e;
+        }
+        if (!(e >> (nd - 1))) {
+            e -= (1 << nd) - 1;    /* Restore negative value if needed */
+        }
+        *val = e;
+    }
+    return (int)d;
+}
+#endif
+
 
 
 
@@ -827,16 +1109,17 @@ static JRESULT mcu_load (
 )
 {
     int32_t *tmp = (int32_t *)jd->workbuf;  /* Block working buffer for de-quantize and IDCT */
-    int d, e;
-    unsigned int blk, nby, i, bc, z, id, cmp;
+    int d, e = 0;
+    unsigned int blk, nby, nbc, i, bc, z, id, cmp;
     jd_yuv_t *bp;
     const int32_t *dqf;
 
 
     nby = jd->msx * jd->msy;    /* Number of Y blocks (1, 2 or 4) */
     bp = jd->mcubuf;            /* Pointer to the first block of MCU */
+    nbc = (jd->ncomp != 3 && JD_MONO_OUT(jd)) ? 0 : 2;  /* No C blocks at all for a monochrome image in luminance output */
 
-    for (blk = 0; blk < nby + 2; blk++) {   /* Get nby Y blocks and two C blocks */
+    for (blk = 0; blk < nby + nbc; blk++) {   /* Get nby Y blocks and two C blocks */
         cmp = (blk < nby) ? 0 : blk - nby + 1;  /* Component number 0:Y, 1:Cb, 2:Cr */
 
         if (cmp && jd->ncomp != 3) {        /* Clear C blocks if not exist (monochrome image) */
@@ -871,7 +1154,11 @@ static JRESULT mcu_load (
             memset(&tmp[1], 0, 63 * sizeof (int32_t));  /* Initialize all AC elements */
             z = 1;      /* Top of the AC elements (in zigzag-order) */
             do {
+#if JD_FASTDECODE == 3
+                d = acext(jd, id, &e);              /* Extract zero runs, bit length and the value in one go */
+#else
                 d = huffext(jd, id, 1);             /* Extract a huffman coded value (zero runs and bit length) */
+#endif
                 if (d == 0) {
                     break;    /* EOB? */
                 }
@@ -884,6 +1171,9 @@ static JRESULT mcu_load (
                     return JDR_FMT1;    /* Too long zero run */
                 }
                 if (bc &= 0x0F) {                   /* Bit length? */
+#if JD_FASTDECODE == 3
+                    d = e;
+#else
                     d = bitext(jd, bc);             /* Extract data bits */
                     if (d < 0) {
                         return (JRESULT)(0 - d);    /* Err: input device */
@@ -892,6 +1182,7 @@ static JRESULT mcu_load (
                     if (!(d & bc)) {
                         d -= (bc << 1) - 1;    /* Restore negative value if needed */
                     }
+#endif
                     i = Zig[z];                     /* Get raster-order index */
                     tmp[i] = d * dqf[i] >> 8;       /* De-quantize, apply scale factor of Arai algorithm and descale 8 bits */
                 }
@@ -920,6 +1211,113 @@ static JRESULT mcu_load (
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Build an RGB MCU from the Y/C blocks (1/1 to 1/4 scale)               */
+/*-----------------------------------------------------------------------*/
+
+/* Any sampling layout, with the MCU size and chroma stepping worked out per pixel */
+static void mcu_rgb_generic (
+    JDEC *jd,           /* Pointer to the decompressor object */
+    uint8_t *pix        /* RGB888 output, MCU width x height */
+)
+{
+    const int CVACC = (sizeof (int) > 2) ? 1024 : 128;  /* Adaptive accuracy for both 16-/32-bit systems */
+    unsigned int ix, iy, mx, my;
+    int yy, cb, cr;
+    jd_yuv_t *py, *pc;
+
+
+    mx = jd->msx * 8; my = jd->msy * 8;                 /* MCU size (pixel) */
+    for (iy = 0; iy < my; iy++) {
+        pc = py = jd->mcubuf;
+        if (my == 16) {     /* Double block height? */
+            pc += 64 * 4 + (iy >> 1) * 8;
+            if (iy >= 8) {
+                py += 64;
+            }
+        } else {            /* Single block height */
+            pc += mx * 8 + iy * 8;
+        }
+        py += iy * 8;
+        for (ix = 0; ix < mx; ix++) {
+            cb = pc[0] - 128;   /* Get Cb/Cr component and remove offset */
+            cr = pc[64] - 128;
+            if (mx == 16) {                 /* Double block width? */
+                if (ix == 8) {
+                    py += 64 - 8;    /* Jump to next block if double block heigt */
+                }
+                /* Step forward chroma pointer every two pixels */
+                if (ix % 2) {
+                    pc++;
+                }
+            } else {                        /* Single block width */
+                pc++;                       /* Step forward chroma pointer every pixel */
+            }
+            yy = *py++;         /* Get Y component */
+            *pix++ = /*R*/ BYTECLIP(yy + ((int)(1.402 * CVACC) * cr) / CVACC);
+            *pix++ = /*G*/ BYTECLIP(yy - ((int)(0.344 * CVACC) * cb + (int)(0.714 * CVACC) * cr) / CVACC);
+            *pix++ = /*B*/ BYTECLIP(yy + ((int)(1.772 * CVACC) * cb) / CVACC);
+        }
+    }
+}
+
+
+/* Body of the per-layout routines. msx/msy are constants in each caller, so the block and
+   chroma strides fold away, and the colour terms of a chroma sample are worked out once for
+   the 1, 2 or 4 pixels it covers. The arithmetic is that of mcu_rgb_generic. */
+static inline __attribute__((always_inline)) void mcu_rgb_layout (
+    const jd_yuv_t *mcubuf, /* Y blocks, then the Cb and Cr blocks */
+    uint8_t *pix,           /* RGB888 output, MCU width x height */
+    const unsigned int msx, /* MCU size in blocks */
+    const unsigned int msy
+)
+{
+    const int CVACC = (sizeof (int) > 2) ? 1024 : 128;
+    const unsigned int mx = msx * 8;
+    const jd_yuv_t *pc = mcubuf + msx * msy * 64;   /* Cb block (Cr block follows) */
+    unsigned int cx, cy, sx, sy, ix, iy;
+    int yy, r, g, b;
+    uint8_t *d;
+
+
+    for (cy = 0; cy < 8; cy++) {
+        for (cx = 0; cx < 8; cx++, pc++) {
+            r = ((int)(1.402 * CVACC) * (pc[64] - 128)) / CVACC;
+            g = ((int)(0.344 * CVACC) * (pc[0] - 128) + (int)(0.714 * CVACC) * (pc[64] - 128)) / CVACC;
+            b = ((int)(1.772 * CVACC) * (pc[0] - 128)) / CVACC;
+            for (sy = 0; sy < msy; sy++) {      /* Pixels sharing this chroma sample */
+                iy = cy * msy + sy;
+                for (sx = 0; sx < msx; sx++) {
+                    ix = cx * msx + sx;
+                    yy = mcubuf[((iy >> 3) * msx + (ix >> 3)) * 64 + (iy & 7) * 8 + (ix & 7)];
+                    d = pix + (iy * mx + ix) * 3;
+                    d[0] = /*R*/ BYTECLIP(yy + r);
+                    d[1] = /*G*/ BYTECLIP(yy - g);
+                    d[2] = /*B*/ BYTECLIP(yy + b);
+                }
+            }
+        }
+    }
+}
+
+static void mcu_rgb_444 (JDEC *jd, uint8_t *pix)
+{
+    mcu_rgb_layout(jd->mcubuf, pix, 1, 1);
+}
+
+static void mcu_rgb_422 (JDEC *jd, uint8_t *pix)
+{
+    mcu_rgb_layout(jd->mcubuf, pix, 2, 1);
+}
+
+static void mcu_rgb_420 (JDEC *jd, uint8_t *pix)
+{
+    mcu_rgb_layout(jd->mcubuf, pix, 2, 2);
+}
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Output an MCU: Convert YCrCb to RGB and output it in RGB form         */
 /*-----------------------------------------------------------------------*/
@@ -937,6 +1335,7 @@ static JRESULT mcu_output (
     jd_yuv_t *py, *pc;
     uint8_t *pix;
     JRECT rect;
+    const int mono = JD_MONO_OUT(jd);                   /* Luminance output (grayscale format or monochrome image) */
 
 
     mx = jd->msx * 8; my = jd->msy * 8;                 /* MCU size (pixel) */
@@ -956,38 +1355,8 @@ static JRESULT mcu_output (
     if (!JD_USE_SCALE || jd->scale != 3) {  /* Not for 1/8 scaling */
         pix = (uint8_t *)jd->workbuf;
 
-        if (JD_FORMAT != 2) {   /* RGB output (build an RGB MCU from Y/C component) */
-            for (iy = 0; iy < my; iy++) {
-                pc = py = jd->mcubuf;
-                if (my == 16) {     /* Double block height? */
-                    pc += 64 * 4 + (iy >> 1) * 8;
-                    if (iy >= 8) {
-                        py += 64;
-                    }
-                } else {            /* Single block height */
-                    pc += mx * 8 + iy * 8;
-                }
-                py += iy * 8;
-                for (ix = 0; ix < mx; ix++) {
-                    cb = pc[0] - 128;   /* Get Cb/Cr component and remove offset */
-                    cr = pc[64] - 128;
-                    if (mx == 16) {                 /* Double block width? */
-                        if (ix == 8) {
-                            py += 64 - 8;    /* Jump to next block if double block heigt */
-                        }
-                        /* Step forward chroma pointer every two pixels */
-                        if (ix % 2) {
-                            pc++;
-                        }
-                    } else {                        /* Single block width */
-                        pc++;                       /* Step forward chroma pointer every pixel */
-                    }
-                    yy = *py++;         /* Get Y component */
-                    *pix++ = /*R*/ BYTECLIP(yy + ((int)(1.402 * CVACC) * cr) / CVACC);
-                    *pix++ = /*G*/ BYTECLIP(yy - ((int)(0.344 * CVACC) * cb + (int)(0.714 * CVACC) * cr) / CVACC);
-                    *pix++ = /*B*/ BYTECLIP(yy + ((int)(1.772 * CVACC) * cb) / CVACC);
-                }
-            }
+        if (!mono) {   /* RGB output (build an RGB MCU from Y/C component) */
+            jd->mcu_rgb(jd, pix);
         } else {    /* Monochrome output (build a grayscale MCU from Y comopnent) */
             for (iy = 0; iy < my; iy++) {
                 py = jd->mcubuf + iy * 8;
@@ -1002,7 +1371,7 @@ static JRESULT mcu_output (
                             py += 64 - 8;    /* Jump to next block if double block height */
                         }
                     }
-                    *pix++ = (uint8_t) * py++;          /* Get and store a Y value as grayscale */
+                    *pix++ = BYTECLIP(*py++);           /* Get and store a Y value as grayscale (DC-only blocks are not clipped yet) */
                 }
             }
         }
@@ -1015,16 +1384,16 @@ static JRESULT mcu_output (
             /* Get averaged RGB value of each square correcponds to a pixel */
             s = jd->scale * 2;  /* Number of shifts for averaging */
             w = 1 << jd->scale; /* Width of square */
-            a = (mx - w) * (JD_FORMAT != 2 ? 3 : 1);    /* Bytes to skip for next line in the square */
+            a = (mx - w) * (mono ? 1 : 3);    /* Bytes to skip for next line in the square */
             op = (uint8_t *)jd->workbuf;
             for (iy = 0; iy < my; iy += w) {
                 for (ix = 0; ix < mx; ix += w) {
-                    pix = (uint8_t *)jd->workbuf + (iy * mx + ix) * (JD_FORMAT != 2 ? 3 : 1);
+                    pix = (uint8_t *)jd->workbuf + (iy * mx + ix) * (mono ? 1 : 3);
                     r = g = b = 0;
                     for (y = 0; y < w; y++) {   /* Accumulate RGB value in the square */
                         for (x = 0; x < w; x++) {
                             r += *pix++;    /* Accumulate R or Y (monochrome output) */
-                            if (JD_FORMAT != 2) {   /* RGB output? */
+                            if (!mono) {   /* RGB output? */
                                 g += *pix++;    /* Accumulate G */
                                 b += *pix++;    /* Accumulate B */
                             }
@@ -1032,7 +1401,7 @@ static JRESULT mcu_output (
                         pix += a;
                     }                           /* Put the averaged pixel value */
                     *op++ = (uint8_t)(r >> s);  /* Put R or Y (monochrome output) */
-                    if (JD_FORMAT != 2) {   /* RGB output? */
+                    if (!mono) {   /* RGB output? */
                         *op++ = (uint8_t)(g >> s);  /* Put G */
                         *op++ = (uint8_t)(b >> s);  /* Put B */
                     }
@@ -1045,8 +1414,11 @@ static JRESULT mcu_output (
         /* Build a 1/8 descaled RGB MCU from discrete comopnents */
         pix = (uint8_t *)jd->workbuf;
         pc = jd->mcubuf + mx * my;
-        cb = pc[0] - 128;       /* Get Cb/Cr component and restore right level */
-        cr = pc[64] - 128;
+        cb = cr = 0;
+        if (!mono) {
+            cb = pc[0] - 128;   /* Get Cb/Cr component and restore right level */
+            cr = pc[64] - 128;
+        }
         for (iy = 0; iy < my; iy += 8) {
             py = jd->mcubuf;
             if (iy == 8) {
@@ -1055,12 +1427,12 @@ static JRESULT mcu_output (
             for (ix = 0; ix < mx; ix += 8) {
                 yy = *py;   /* Get Y component */
                 py += 64;
-                if (JD_FORMAT != 2) {
+                if (!mono) {
                     *pix++ = /*R*/ BYTECLIP(yy + ((int)(1.402 * CVACC) * cr / CVACC));
                     *pix++ = /*G*/ BYTECLIP(yy - ((int)(0.344 * CVACC) * cb + (int)(0.714 * CVACC) * cr) / CVACC);
                     *pix++ = /*B*/ BYTECLIP(yy + ((int)(1.772 * CVACC) * cb / CVACC));
                 } else {
-                    *pix++ = yy;
+                    *pix++ = BYTECLIP(yy);
                 }
             }
         }
@@ -1076,17 +1448,17 @@ static JRESULT mcu_output (
         for (y = 0; y < ry; y++) {
             for (x = 0; x < rx; x++) {  /* Copy effective pixels */
                 *d++ = *s++;
-                if (JD_FORMAT != 2) {
+                if (!mono) {
                     *d++ = *s++;
                     *d++ = *s++;
                 }
             }
-            s += (mx - rx) * (JD_FORMAT != 2 ? 3 : 1);  /* Skip truncated pixels */
+            s += (mx - rx) * (mono ? 1 : 3);  /* Skip truncated pixels */
         }
     }
 
     /* Convert RGB888 to RGB565 if needed */
-    if (JD_FORMAT == 1) {
+    if (JD_FORMAT == 1 && !mono) {
         uint8_t *s = (uint8_t *)jd->workbuf;
         uint16_t w, *d = (uint16_t *)s;
         unsigned int n = rx * ry;
@@ -1120,6 +1492,20 @@ JRESULT jd_prepare (
     size_t sz_pool,         /* Size of working buffer */
     void *dev               /* I/O device identifier for the session */
 )
+{
+    return jd_prepare_ex(jd, infunc, pool, sz_pool, 0, 0, dev);
+}
+
+
+JRESULT jd_prepare_ex (
+    JDEC *jd,               /* Blank decompressor object */
+    size_t (*infunc)(JDEC *, uint8_t *, size_t), /* JPEG strem input function */
+    void *pool,             /* Working buffer for the decompression session */
+    size_t sz_pool,         /* Size of working buffer */
+    void *pool_fast,        /* Small fast buffer for the hot tables and MCU buffers (can be null) */
+    size_t sz_pool_fast,    /* Size of fast buffer */
+    void *dev               /* I/O device identifier for the session */
+)
 {
     uint8_t *seg, b;
     uint16_t marker;
@@ -1131,10 +1517,12 @@ JRESULT jd_prepare (
     memset(jd, 0, sizeof (JDEC));   /* Clear decompression object (this might be a problem if machine's null pointer is not all bits zero) */
     jd->pool = pool;        /* Work memroy */
     jd->sz_pool = sz_pool;  /* Size of given work memory */
+    jd->pool_fast = pool_fast;          /* Fast work memory */
+    jd->sz_pool_fast = pool_fast ? sz_pool_fast : 0;
     jd->infunc = infunc;    /* Stream input function */
     jd->device = dev;       /* I/O device identifier */
 
-    jd->inbuf = seg = alloc_pool(jd, JD_SZBUF);     /* Allocate stream input buffer */
+    jd->inbuf = seg = alloc_pool_fast(jd, JD_SZBUF);    /* Allocate stream input buffer */
     if (!seg) {
         return JDR_MEM1;
     }
@@ -1204,6 +1592,9 @@ JRESULT jd_prepare (
                         return JDR_FMT3;                    /* Err: Supports only 4:4:4, 4:2:0 or 4:2:2 */
                     }
                     jd->msx = b >> 4; jd->msy = b & 15;     /* Size of MCU [blocks] */
+                    /* RGB MCU builder for this layout, so mcu_output does no per-pixel layout maths */
+                    jd->mcu_rgb = JD_MCU_GENERIC ? mcu_rgb_generic
+                                  : (b == 0x22) ? mcu_rgb_420 : (b == 0x21) ? mcu_rgb_422 : mcu_rgb_444;
                 } else {        /* Cb/Cr component */
                     if (b != 0x11) {
                         return JDR_FMT3;    /* Err: Sampling factor of Cb/Cr must be 1 */
@@ -1298,14 +1689,13 @@ JRESULT jd_prepare (
             if (len < 256) {
                 len = 256;    /* but at least 256 byte is required for IDCT */
             }
-            jd->workbuf = alloc_pool(jd, len);          /* and it may occupy a part of following MCU working buffer for RGB output */
+            len = (len + 3) & ~3;
+            /* RGB output may occupy a part of the following MCU working buffer, so both come from one block of the same pool */
+            jd->workbuf = alloc_pool_fast(jd, len + (n + 2) * 64 * sizeof (jd_yuv_t));
             if (!jd->workbuf) {
                 return JDR_MEM1;    /* Err: not enough memory */
             }
-            jd->mcubuf = alloc_pool(jd, (n + 2) * 64 * sizeof (jd_yuv_t));  /* Allocate MCU working buffer */
-            if (!jd->mcubuf) {
-                return JDR_MEM1;    /* Err: not enough memory */
-            }
+            jd->mcubuf = (jd_yuv_t *)((uint8_t *)jd->workbuf + len);   /* MCU working buffer follows the IDCT/RGB buffer */
 
             /* Align stream read offset to JD_SZBUF */
             if (ofs %= JD_SZBUF) {
@@ -1355,6 +1745,9 @@ JRESULT jd_decomp (
     unsigned int x, y, mx, my;
     uint16_t rst, rsc;
     JRESULT rc;
+#if JD_PROFILE
+    uint32_t t0, t1;
+#endif
 
 
     if (scale > (JD_USE_SCALE ? 3 : 0)) {
@@ -1366,9 +1759,16 @@ JRESULT jd_decomp (
 
     jd->dcv[2] = jd->dcv[1] = jd->dcv[0] = 0;   /* Initialize DC values */
     rst = rsc = 0;
+#if JD_PROFILE
+    jd->t_load = jd->t_output = 0;
+    t0 = JD_TIMESTAMP();    /* Each MCU starts at the previous one's end stamp (restarts count as load) */
+#endif
 
     rc = JDR_OK;
     for (y = 0; y < jd->height; y += my) {      /* Vertical loop of MCUs */
+#if JD_TRACE
+        jd_trace(JD_TRACE_MCU_ROW, 1, y);
+#endif
         for (x = 0; x < jd->width; x += mx) {   /* Horizontal loop of MCUs */
             if (jd->nrst && rst++ == jd->nrst) {    /* Process restart interval if enabled */
                 rc = restart(jd, rsc++);
@@ -1381,11 +1781,22 @@ JRESULT jd_decomp (
             if (rc != JDR_OK) {
                 return rc;
             }
+#if JD_PROFILE
+            t1 = JD_TIMESTAMP();
+            jd->t_load += t1 - t0;
+#endif
             rc = mcu_output(jd, outfunc, x, y); /* Output the MCU (YCbCr to RGB, scaling and output) */
             if (rc != JDR_OK) {
                 return rc;
             }
+#if JD_PROFILE
+            t0 = JD_TIMESTAMP();
+            jd->t_output += t0 - t1;
+#endif
         }
+#if JD_TRACE
+        jd_trace(JD_TRACE_MCU_ROW, 0, y);
+#endif
     }
 
     return rc;
@@ -17,6 +17,7 @@ typedef unsigned short  uint16_t;
 typedef short           int16_t;
 typedef unsigned long   uint32_t;
 typedef long            int32_t;
+typedef unsigned long long uint64_t;
 #else               /* Embedded platform */
 #include <stdint.h>
 #endif
@@ -27,6 +28,12 @@ typedef int16_t jd_yuv_t;
 typedef uint8_t jd_yuv_t;
 #endif
 
+#if JD_FASTDECODE == 3
+typedef uint32_t jd_hufflut_t;  /* AC table entry: code length, zero run and data length, and the value when resolved */
+#else
+typedef uint16_t jd_hufflut_t;  /* AC table entry: code length, zero run and data length */
+#endif
+
 
 /* Error code */
 typedef enum {
@@ -72,26 +79,51 @@ struct JDEC {
     uint8_t *huffdata[2][2];    /* Huffman decoded data tables [id][dcac] */
     int32_t *qttbl[4];          /* Dequantizer tables [id] */
 #if JD_FASTDECODE >= 1
+#if JD_FASTDECODE == 3
+    uint64_t wreg;              /* Bit reservoir, topped up several bytes at a time */
+#else
     uint32_t wreg;              /* Working shift register */
+#endif
     uint8_t marker;             /* Detected marker (0:None) */
-#if JD_FASTDECODE == 2
+#if JD_FASTDECODE >= 2
     uint8_t longofs[2][2];      /* Table offset of long code [id][dcac] */
-    uint16_t *hufflut_ac[2];    /* Fast huffman decode tables for AC short code [id] */
+    jd_hufflut_t *hufflut_ac[2];    /* Fast huffman decode tables for AC short code [id] */
     uint8_t *hufflut_dc[2];     /* Fast huffman decode tables for DC short code [id] */
 #endif
 #endif
+#if JD_PROFILE
+    uint32_t t_load;            /* Accumulated time in mcu_load (entropy decode + IDCT) [us] */
+    uint32_t t_output;          /* Accumulated time in mcu_output (colour conversion + output function) [us] */
+#endif
+    void (*mcu_rgb)(JDEC *, uint8_t *); /* Builds the RGB MCU for this image's sampling layout (set in jd_prepare) */
     void *workbuf;              /* Working buffer for IDCT and RGB output */
     jd_yuv_t *mcubuf;           /* Working buffer for the MCU */
     void *pool;                 /* Pointer to available memory pool */
     size_t sz_pool;             /* Size of momory pool (bytes available) */
+    void *pool_fast;            /* Pointer to available fast memory pool (hot tables and MCU buffers) */
+    size_t sz_pool_fast;        /* Size of fast memory pool (bytes available) */
     size_t (*infunc)(JDEC *, uint8_t *, size_t); /* Pointer to jpeg stream input function */
     void *device;               /* Pointer to I/O device identifiler for the session */
 };
 
 
 
+/* Non-zero when the output function gets 8-bit luminance (one byte per pixel) for this image
+   instead of JD_FORMAT pixels: always in grayscale format, and for monochrome images with JD_MONO_LUMA */
+#define JD_MONO_OUT(jd)     (JD_FORMAT == 2 || (JD_MONO_LUMA && (jd)->ncomp == 1))
+
+
+#if JD_TRACE
+/* Trace hook, called with begin = 1 / 0 around each traced stage (weak no-op in jpeg_decoder.c) */
+#define JD_TRACE_PREPARE    0   /* jd_prepare (arg: 0) */
+#define JD_TRACE_DECOMP     1   /* jd_decomp (arg: 0) */
+#define JD_TRACE_MCU_ROW    2   /* One row of MCUs (arg: top line of the row) */
+void jd_trace (uint8_t point, uint8_t begin, uint16_t arg);
+#endif
+
 /* TJpgDec API functions */
 JRESULT jd_prepare (JDEC *jd, size_t (*infunc)(JDEC *, uint8_t *, size_t), void *pool, size_t sz_pool, void *dev);
+JRESULT jd_prepare_ex (JDEC *jd, size_t (*infunc)(JDEC *, uint8_t *, size_t), void *pool, size_t sz_pool, void *pool_fast, size_t sz_pool_fast, void *dev);
 JRESULT jd_decomp (JDEC *jd, int (*outfunc)(JDEC *, void *, JRECT *), uint8_t scale);
 
 
@@ -34,11 +34,33 @@
 /  1: Enable
 */
 
+#if defined(CONFIG_JD_MONO_LUMA)
+#define JD_MONO_LUMA    CONFIG_JD_MONO_LUMA
+#else
+#define JD_MONO_LUMA    0
+#endif
+/* Output of monochrome (single component) images.
+/  0: Same pixel format as colour images (converted from Y with zero chroma)
+/  1: 8-bit luminance, skipping the chroma blocks and colour conversion (see JD_MONO_OUT)
+*/
+
+#if defined(CONFIG_JD_MCU_GENERIC)
+#define JD_MCU_GENERIC  CONFIG_JD_MCU_GENERIC
+#else
+#define JD_MCU_GENERIC  0
+#endif
+/* Colour MCU build.
+/  0: A routine specialised for the image's sampling layout (4:4:4, 4:2:2 or 4:2:0), picked in jd_prepare
+/  1: One generic loop for every layout (the reference host/mcu_bench.c checks them against)
+*/
+
 #define JD_FASTDECODE   CONFIG_JD_FASTDECODE
 /* Optimization level
 /  0: Basic optimization. Suitable for 8/16-bit MCUs.
 /  1: + 32-bit barrel shifter. Suitable for 32-bit MCUs.
 /  2: + Table conversion for huffman decoding (wants 6 << HUFF_BIT bytes of RAM)
+/  3: + 64-bit bit reservoir refilled several bytes at a time, and AC tables that also resolve
+/     the value bits of short elements (wants 10 << HUFF_BIT bytes of RAM)
 */
 
 #if defined(CONFIG_JD_DEFAULT_HUFFMAN)
@@ -46,3 +68,23 @@
 #else
 #define JD_DEFAULT_HUFFMAN 0
 #endif
+
+#if defined(CONFIG_JD_PROFILE)
+#define JD_PROFILE CONFIG_JD_PROFILE
+#else
+#define JD_PROFILE 0
+#endif
+/* Accumulate per-stage decode time in the decompressor object.
+/  0: Disable
+/  1: Enable (mcu_load and mcu_output time in microseconds, see JDEC.t_load/t_output)
+*/
+
+#if defined(CONFIG_JD_TRACE)
+#define JD_TRACE CONFIG_JD_TRACE
+#else
+#define JD_TRACE 0
+#endif
+/* Call the application's jd_trace() hook around prepare, decompression and each MCU row.
+/  0: Disable
+/  1: Enable
+*/
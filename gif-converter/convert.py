@@ -3,6 +3,7 @@ GIF/MP4 to JPEG Sequence Converter
 
 Usage:
     python convert.py --source ./source --output ./output [--size 320 240] [--rotate {0,90,180,-90}] [--jpeg_quality 50] [--clear_output]
+                      [--codec {jpeg,q565}] [--grayscale]
 
 Virtual Environment Setup:
     python3 -m venv .venv
@@ -15,8 +16,9 @@ This script will:
 - Rotate frames if specified (0, 90, 180, or -90 degrees)
 - Resize and center-crop them to the specified size (default 320x240)
 - Replace transparency with black (for GIFs)
-- Save frames as JPEG files directly to the output directory
-- Generate a manifest.txt with all JPEG filenames
+- Save frames as JPEG files directly to the output directory, or with --codec q565
+  as lossless Q565 files (main/q565.h), which suit flat-shaded cartoons
+- Generate a manifest.txt with all frame filenames, sizes and frame delays (ms)
 """
 
 import os
@@ -69,6 +71,49 @@ def optimize_jpeg_file(filepath):
         print(f"   jpegoptim not found - skipping post-optimization")
         return False
 
+Q565_RUN_MAX = 62
+
+def q565_hash(px):
+    return ((px >> 11) * 3 + ((px >> 5) & 63) * 5 + (px & 31) * 7) & 63
+
+def encode_q565(img):
+    """Encode an RGB image as Q565 (format in main/q565.h)"""
+    width, height = img.size
+    out = bytearray(b"q565")
+    out += width.to_bytes(2, "little") + height.to_bytes(2, "little")
+    cache = [0] * 64
+    prev = 0
+    run = 0
+    pixels = [((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3) for r, g, b in img.getdata()]
+    for i, px in enumerate(pixels):
+        if px == prev:
+            run += 1
+            if run == Q565_RUN_MAX or i == len(pixels) - 1:
+                out.append(0xC0 | (run - 1))
+                run = 0
+            continue
+        if run:
+            out.append(0xC0 | (run - 1))
+            run = 0
+        h = q565_hash(px)
+        if cache[h] == px:
+            out.append(h)
+        else:
+            cache[h] = px
+            dr = (px >> 11) - (prev >> 11)
+            dg = ((px >> 5) & 63) - ((prev >> 5) & 63)
+            db = (px & 31) - (prev & 31)
+            dg_half = ((dg + 64) >> 1) - 32
+            dr_dg, db_dg = dr - dg_half, db - dg_half
+            if -2 <= dr <= 1 and -2 <= dg <= 1 and -2 <= db <= 1:
+                out.append(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2))
+            elif -32 <= dg <= 31 and -8 <= dr_dg <= 7 and -8 <= db_dg <= 7:
+                out += bytes((0x80 | (dg + 32), (dr_dg + 8) << 4 | (db_dg + 8)))
+            else:
+                out += bytes((0xFE, px >> 8, px & 0xFF))
+        prev = px
+    return bytes(out)
+
 def crop_and_resize(img, size=(320, 240)): # Default changed
     # Resize to fill, then center-crop
     aspect = img.width / img.height
@@ -98,6 +143,11 @@ def process_media_file(input_path, base_output_dir, size=(320, 240), rotation=0,
     base_name = os.path.splitext(os.path.basename(input_path))[0]
     generated_manifest_entries = []
     processed_frames_in_this_file_count = 0
+
+    # Frame delay for the manifest's third column (the player's per-clip default), stride included
+    meta = reader.get_meta_data()
+    frame_ms = meta.get('duration') or (1000.0 / meta['fps'] if meta.get('fps') else 0)
+    delay_col = f" {int(round(frame_ms * frame_stride))}" if frame_ms else ""
     
     for original_frame_idx, frame_data in enumerate(reader):
         if original_frame_idx % frame_stride != 0:
@@ -116,6 +166,20 @@ def process_media_file(input_path, base_output_dir, size=(320, 240), rotation=0,
         background = Image.new('RGBA', img_resized.size, (0, 0, 0, 255)) # Black background
         img_composited = Image.alpha_composite(background, img_resized)
         img_final_rgb = img_composited.convert('RGB')
+        if args.grayscale:
+            # Luminance only: JPEG frames get one component, so the decoder skips chroma and colour conversion
+            img_final_rgb = img_final_rgb.convert('L')
+
+        if args.codec == 'q565':
+            # Filename: original_basename-001.q565 etc.
+            q565_filename = f"{base_name}-{current_processed_frame_idx_for_file + 1:03d}.q565"
+            out_path = os.path.join(base_output_dir, q565_filename)
+            with open(out_path, 'wb') as qf:
+                qf.write(encode_q565(img_final_rgb.convert('RGB')))
+            print(f"Saved Q565 frame (original index {original_frame_idx}) as: {out_path}")
+            generated_manifest_entries.append(f"{q565_filename} {os.path.getsize(out_path)}{delay_col}")
+            processed_frames_in_this_file_count += 1
+            continue
 
         # Output JPEG
         # Filename: original_basename-001.jpg, original_basename-002.jpg etc.
@@ -138,7 +202,7 @@ def process_media_file(input_path, base_output_dir, size=(320, 240), rotation=0,
             img_final_rgb.save(out_path, "JPEG", **save_params)
             print(f"Saved optimized JPEG frame (original index {original_frame_idx}) as: {out_path} (Quality: {jpeg_quality}, QTables: {args.qtables})")
             file_sz = os.path.getsize(out_path)
-            generated_manifest_entries.append(f"{jpeg_filename} {file_sz}")
+            generated_manifest_entries.append(f"{jpeg_filename} {file_sz}{delay_col}")
             processed_frames_in_this_file_count += 1
         except Exception as e:
             print(f"Error saving JPEG frame {out_path}: {e}")
@@ -146,7 +210,7 @@ def process_media_file(input_path, base_output_dir, size=(320, 240), rotation=0,
             try:
                 img_final_rgb.save(out_path, "JPEG", quality=jpeg_quality, optimize=True)
                 file_sz = os.path.getsize(out_path)
-                generated_manifest_entries.append(f"{jpeg_filename} {file_sz}")
+                generated_manifest_entries.append(f"{jpeg_filename} {file_sz}{delay_col}")
                 processed_frames_in_this_file_count += 1
             except Exception as e2:
                 print(f"  Fallback also failed: {e2}")
@@ -198,6 +262,12 @@ def main():
     parser.add_argument('--qtables', type=str, default='web_low', 
                         choices=['web_low', 'web_high', 'photoshop', 'keep', 'auto'],
                         help='JPEG quantization tables (default: web_low). Try "auto" for normal behavior.')
+    parser.add_argument('--codec', choices=['jpeg', 'q565'], default='jpeg',
+                        help='Frame codec (default: jpeg). q565 is lossless RGB565 for flat-colour art; '
+                             'JPEG options are ignored')
+    parser.add_argument('--grayscale', action='store_true',
+                        help='Store luminance only: single-component JPEGs (decoded without chroma or colour '
+                             'conversion), or grey Q565 pixels')
     parser.add_argument('--clear_output', action='store_true',
                         help='Clear the output directory before processing')
     args = parser.parse_args()
@@ -248,7 +318,7 @@ def main():
         print("No frames were processed, so no manifest.txt was generated.")
 
     # Post-process optimization if requested
-    if args.post_optimize and all_manifest_entries:
+    if args.post_optimize and all_manifest_entries and args.codec == 'jpeg':
         print(f"\n🗜️ Post-processing {len(all_manifest_entries)} JPEG files...")
         optimized_count = 0
         for frame_file in all_manifest_entries:
@@ -263,6 +333,7 @@ def main():
         print(f"\n📊 Output Summary:")
         print(f"   🎯 Settings:")
         print(f"      Size: {output_size[0]}x{output_size[1]}")
+        print(f"      Codec: {args.codec}{' (grayscale)' if args.grayscale else ''}")
         print(f"      JPEG Quality: {args.jpeg_quality}")
         print(f"      Quantization Tables: {args.qtables}")
         print(f"      Frame Stride: {args.frame_stride}")
@@ -294,6 +365,10 @@ def main():
             f"--jpeg_quality {args.jpeg_quality} "
             f"--qtables {args.qtables}"
         )
+        if args.codec != 'jpeg':
+            command_to_write += f" --codec {args.codec}"
+        if args.grayscale:
+            command_to_write += " --grayscale"
         if args.post_optimize:
             command_to_write += " --post_optimize"
         if args.clear_output:
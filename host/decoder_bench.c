@@ -0,0 +1,255 @@
+// Decoder benchmark: decodes test.jpg and every frame in the manifest with the
+// tjpgd configuration this binary was compiled with (see the JD_BENCH_* lists
+// in host/CMakeLists.txt) and prints one row of results, optionally as JSON.
+// tools/decoder_bench.py runs all configurations and compares them against a
+// stored baseline.
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
+#include "tjpgd.h"
+
+#define BENCH_POOL_SIZE (128 * 1024)
+#define BENCH_MAX_PATH 512
+#define BENCH_BYTES_PER_PIXEL (JD_FORMAT == 0 ? 3 : JD_FORMAT == 1 ? 2 : 1)
+
+typedef struct {
+    char name[64];
+    uint8_t *data;
+    size_t size;
+    uint16_t width;
+    uint16_t height;
+    uint32_t mcus;
+    uint32_t crc;       // CRC-32 of the decoder output in its native JD_FORMAT
+    size_t pool_used;
+    int result;         // JRESULT of the last decode
+} bench_frame_t;
+
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+    uint8_t *out;
+    uint16_t out_w;
+} bench_io_t;
+
+static size_t bench_in(JDEC *jd, uint8_t *buff, size_t nbyte)
+{
+    bench_io_t *io = jd->device;
+    if (nbyte > io->size - io->pos) {
+        nbyte = io->size - io->pos;
+    }
+    if (buff) {
+        memcpy(buff, io->data + io->pos, nbyte);
+    }
+    io->pos += nbyte;
+    return nbyte;
+}
+
+static int bench_out(JDEC *jd, void *bitmap, JRECT *rect)
+{
+    bench_io_t *io = jd->device;
+    size_t line = (size_t)(rect->right - rect->left + 1) * BENCH_BYTES_PER_PIXEL;
+    const uint8_t *src = bitmap;
+    for (int y = rect->top; y <= rect->bottom; y++) {
+        memcpy(io->out + ((size_t)y * io->out_w + rect->left) * BENCH_BYTES_PER_PIXEL, src, line);
+        src += line;
+    }
+    return 1;
+}
+
+static bool load_file(const char *path, bench_frame_t *frame)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    frame->size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    frame->data = malloc(frame->size);
+    bool ok = frame->data && fread(frame->data, 1, frame->size, f) == frame->size;
+    fclose(f);
+    return ok;
+}
+
+static int load_corpus(const char *dir, bench_frame_t **frames_out)
+{
+    char path[BENCH_MAX_PATH];
+    int count = 0, cap = 64;
+    bench_frame_t *frames = calloc(cap, sizeof(bench_frame_t));
+
+    snprintf(path, sizeof(path), "%s/test.jpg", dir);
+    if (load_file(path, &frames[count])) {
+        snprintf(frames[count].name, sizeof(frames[count].name), "test.jpg");
+        count++;
+    }
+
+    snprintf(path, sizeof(path), "%s/output/manifest.txt", dir);
+    FILE *mf = fopen(path, "r");
+    if (mf) {
+        char line[256], fname[64];
+        while (fgets(line, sizeof(line), mf)) {
+            if (sscanf(line, "%63s", fname) != 1) {
+                continue;
+            }
+            if (count == cap) {
+                cap *= 2;
+                frames = realloc(frames, cap * sizeof(bench_frame_t));
+            }
+            memset(&frames[count], 0, sizeof(bench_frame_t));
+            snprintf(path, sizeof(path), "%s/output/%s", dir, fname);
+            if (!load_file(path, &frames[count])) {
+                fprintf(stderr, "⚠️ Could not read %s\n", path);
+                continue;
+            }
+            snprintf(frames[count].name, sizeof(frames[count].name), "%s", fname);
+            count++;
+        }
+        fclose(mf);
+    }
+    *frames_out = frames;
+    return count;
+}
+
+// Decode every frame once; returns the total decode time in µs
+static int64_t bench_pass(bench_frame_t *frames, int count, uint8_t *pool, uint8_t *out, size_t out_size, bool record)
+{
+    int64_t total = 0;
+    for (int i = 0; i < count; i++) {
+        bench_frame_t *frame = &frames[i];
+        bench_io_t io = { .data = frame->data, .size = frame->size, .out = out };
+        JDEC jd;
+
+        int64_t start = esp_timer_get_time();
+        JRESULT res = jd_prepare(&jd, bench_in, pool, BENCH_POOL_SIZE, &io);
+        if (res == JDR_OK) {
+            io.out_w = jd.width;
+            if ((size_t)jd.width * jd.height * BENCH_BYTES_PER_PIXEL > out_size) {
+                res = JDR_MEM2;
+            } else {
+                res = jd_decomp(&jd, bench_out, 0);
+            }
+        }
+        total += esp_timer_get_time() - start;
+
+        if (record) {
+            frame->result = res;
+            if (res == JDR_OK) {
+                frame->width = jd.width;
+                frame->height = jd.height;
+                frame->mcus = ((jd.width + jd.msx * 8 - 1) / (jd.msx * 8)) *
+                              ((jd.height + jd.msy * 8 - 1) / (jd.msy * 8));
+                frame->pool_used = BENCH_POOL_SIZE - jd.sz_pool;
+                frame->crc = esp_rom_crc32_le(0, out, (uint32_t)jd.width * jd.height * BENCH_BYTES_PER_PIXEL);
+            }
+        }
+    }
+    return total;
+}
+
+int main(int argc, char **argv)
+{
+    const char *data_dir = JD_BENCH_DATA_DIR;
+    const char *json_path = NULL;
+    int passes = 3;
+    bool header = false;
+
+    static const struct option opts[] = {
+        { "data", required_argument, NULL, 'd' },
+        { "json", required_argument, NULL, 'j' },
+        { "passes", required_argument, NULL, 'p' },
+        { "header", no_argument, NULL, 'H' },
+        { NULL, 0, NULL, 0 },
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "d:j:p:H", opts, NULL)) != -1) {
+        switch (opt) {
+        case 'd': data_dir = optarg; break;
+        case 'j': json_path = optarg; break;
+        case 'p': passes = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+        case 'H': header = true; break;
+        default:
+            fprintf(stderr, "usage: %s [--data DIR] [--passes N] [--json FILE] [--header]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bench_frame_t *frames = NULL;
+    int count = load_corpus(data_dir, &frames);
+    if (count == 0) {
+        fprintf(stderr, "❌ No JPEG files found under %s\n", data_dir);
+        return 1;
+    }
+
+    size_t out_size = 1024 * 1024 * 3;
+    uint8_t *pool = malloc(BENCH_POOL_SIZE);
+    uint8_t *out = malloc(out_size);
+
+    // First pass records sizes, pool use and checksums and warms the caches
+    bench_pass(frames, count, pool, out, out_size, true);
+    int64_t best_us = INT64_MAX;
+    for (int p = 0; p < passes; p++) {
+        int64_t us = bench_pass(frames, count, pool, out, out_size, false);
+        if (us < best_us) {
+            best_us = us;
+        }
+    }
+
+    uint64_t mcus = 0;
+    size_t pool_max = 0;
+    uint32_t corpus_crc = 0;
+    int errors = 0;
+    for (int i = 0; i < count; i++) {
+        if (frames[i].result != JDR_OK) {
+            errors++;
+            continue;
+        }
+        mcus += frames[i].mcus;
+        if (frames[i].pool_used > pool_max) {
+            pool_max = frames[i].pool_used;
+        }
+        corpus_crc = esp_rom_crc32_le(corpus_crc, (const uint8_t *)&frames[i].crc, sizeof(frames[i].crc));
+    }
+    double fps = best_us > 0 ? count * 1e6 / best_us : 0;
+    double us_per_mcu = mcus ? (double)best_us / mcus : 0;
+
+    if (header) {
+        printf("%-30s %6s %9s %9s %8s %10s %6s\n", "config", "frames", "frames/s", "us/MCU", "pool B", "crc", "errors");
+    }
+    printf("%-30s %6d %9.1f %9.3f %8zu   %08x %6d\n", JD_BENCH_NAME, count, fps, us_per_mcu, pool_max, corpus_crc, errors);
+
+    if (json_path) {
+        FILE *jf = fopen(json_path, "w");
+        if (!jf) {
+            fprintf(stderr, "❌ Could not write %s\n", json_path);
+            return 1;
+        }
+        fprintf(jf, "{\n  \"config\": \"%s\",\n", JD_BENCH_NAME);
+        fprintf(jf, "  \"options\": {\"JD_FASTDECODE\": %d, \"JD_TBLCLIP\": %d, \"JD_USE_SCALE\": %d, \"JD_SZBUF\": %d, \"JD_FORMAT\": %d},\n",
+                JD_FASTDECODE, JD_TBLCLIP, JD_USE_SCALE, JD_SZBUF, JD_FORMAT);
+        fprintf(jf, "  \"frames\": %d,\n  \"passes\": %d,\n  \"errors\": %d,\n", count, passes, errors);
+        fprintf(jf, "  \"best_pass_us\": %lld,\n  \"frames_per_s\": %.2f,\n  \"us_per_mcu\": %.4f,\n",
+                (long long)best_us, fps, us_per_mcu);
+        fprintf(jf, "  \"mcus\": %llu,\n  \"pool_bytes_max\": %zu,\n  \"corpus_crc\": \"%08x\",\n",
+                (unsigned long long)mcus, pool_max, corpus_crc);
+        fprintf(jf, "  \"checksums\": {\n");
+        for (int i = 0; i < count; i++) {
+            fprintf(jf, "    \"%s\": \"%08x\"%s\n", frames[i].name, frames[i].crc, i + 1 < count ? "," : "");
+        }
+        fprintf(jf, "  }\n}\n");
+        fclose(jf);
+    }
+
+    for (int i = 0; i < count; i++) {
+        free(frames[i].data);
+    }
+    free(frames);
+    free(pool);
+    free(out);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,192 @@
+#include "golden.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+
+static const char *TAG = "GOLDEN";
+
+#define GOLDEN_LABEL_LEN 32
+#define GOLDEN_REPORT_MAX 10 // Individual failures printed before going quiet
+
+typedef struct {
+    char label[GOLDEN_LABEL_LEN];
+    uint32_t crc;
+} golden_entry_t;
+
+struct golden_check {
+    golden_config_t config;
+    golden_entry_t *expected;   // Loaded list (checking) or collected list (updating)
+    size_t expected_count;
+    size_t expected_cap;
+    size_t next;                // Position in 'expected' for the next frame when checking
+    uint32_t frames;
+    uint32_t crc_failures;
+    uint32_t pixel_failures;
+    uint32_t missing_refs;
+    int worst_diff;
+};
+
+static void add_entry(golden_check_t *check, const char *label, uint32_t crc)
+{
+    if (check->expected_count == check->expected_cap) {
+        check->expected_cap = check->expected_cap ? check->expected_cap * 2 : 512;
+        check->expected = realloc(check->expected, check->expected_cap * sizeof(golden_entry_t));
+    }
+    golden_entry_t *e = &check->expected[check->expected_count++];
+    snprintf(e->label, sizeof(e->label), "%s", label);
+    e->crc = crc;
+}
+
+esp_err_t golden_open(const golden_config_t *config, golden_check_t **ret)
+{
+    golden_check_t *check = calloc(1, sizeof(golden_check_t));
+    if (!check) {
+        return ESP_ERR_NO_MEM;
+    }
+    check->config = *config;
+
+    if (config->crc_path && !config->update) {
+        FILE *f = fopen(config->crc_path, "r");
+        if (!f) {
+            ESP_LOGE(TAG, "❌ Cannot open golden list %s", config->crc_path);
+            free(check);
+            return ESP_ERR_NOT_FOUND;
+        }
+        char line[128], label[GOLDEN_LABEL_LEN];
+        unsigned int crc;
+        while (fgets(line, sizeof(line), f)) {
+            if (line[0] == '#' || sscanf(line, "%31s %x", label, &crc) != 2) {
+                continue;
+            }
+            add_entry(check, label, crc);
+        }
+        fclose(f);
+        ESP_LOGI(TAG, "📋 %zu golden checksums from %s", check->expected_count, config->crc_path);
+    }
+    *ret = check;
+    return ESP_OK;
+}
+
+static bool read_ppm(const char *path, int width, int height, uint8_t *rgb)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    int w = 0, h = 0, maxval = 0;
+    bool ok = fscanf(f, "P6 %d %d %d", &w, &h, &maxval) == 3 && fgetc(f) != EOF &&
+              w == width && h == height && maxval == 255 &&
+              fread(rgb, 3, (size_t)w * h, f) == (size_t)w * h;
+    fclose(f);
+    return ok;
+}
+
+// Largest per-channel difference in RGB565 steps; counts pixels beyond the tolerance
+static int compare_reference(const uint16_t *fb, const uint8_t *rgb, int pixels, int tolerance, int *over)
+{
+    const uint8_t *px = (const uint8_t *)fb;
+    int worst = 0;
+    *over = 0;
+    for (int i = 0; i < pixels; i++, px += 2, rgb += 3) {
+        uint16_t v = (uint16_t)(px[0] << 8 | px[1]);
+        int d[3] = {
+            abs((int)((v >> 11) & 0x1F) - (rgb[0] * 31 + 127) / 255),
+            abs((int)((v >> 5) & 0x3F) - (rgb[1] * 63 + 127) / 255),
+            abs((int)(v & 0x1F) - (rgb[2] * 31 + 127) / 255),
+        };
+        int m = d[0] > d[1] ? d[0] : d[1];
+        m = m > d[2] ? m : d[2];
+        if (m > tolerance) {
+            (*over)++;
+        }
+        if (m > worst) {
+            worst = m;
+        }
+    }
+    return worst;
+}
+
+void golden_check_frame(golden_check_t *check, const char *label, const uint16_t *fb, int width, int height)
+{
+    const golden_config_t *cfg = &check->config;
+    size_t pixels = (size_t)width * height;
+    uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)fb, pixels * sizeof(uint16_t));
+    check->frames++;
+
+    if (cfg->crc_path && cfg->update) {
+        add_entry(check, label, crc);
+    } else if (cfg->crc_path) {
+        const golden_entry_t *e = check->next < check->expected_count ? &check->expected[check->next++] : NULL;
+        if (!e || strcmp(e->label, label) != 0 || e->crc != crc) {
+            if (check->crc_failures++ < GOLDEN_REPORT_MAX) {
+                ESP_LOGE(TAG, "❌ %s: checksum %08lx, golden %s %08lx", label, (unsigned long)crc,
+                         e ? e->label : "(none)", e ? (unsigned long)e->crc : 0UL);
+            }
+        }
+    }
+
+    if (cfg->reference_dir) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s.ppm", cfg->reference_dir, label);
+        uint8_t *rgb = malloc(pixels * 3);
+        if (!rgb || !read_ppm(path, width, height, rgb)) {
+            check->missing_refs++;
+        } else {
+            int over = 0;
+            int worst = compare_reference(fb, rgb, (int)pixels, cfg->tolerance, &over);
+            if (worst > check->worst_diff) {
+                check->worst_diff = worst;
+            }
+            if (over && check->pixel_failures++ < GOLDEN_REPORT_MAX) {
+                ESP_LOGE(TAG, "❌ %s: %d pixels drift beyond ±%d (max %d RGB565 steps)", label, over, cfg->tolerance, worst);
+            }
+        }
+        free(rgb);
+    }
+}
+
+int golden_finish(golden_check_t *check)
+{
+    const golden_config_t *cfg = &check->config;
+    int failures = 0;
+
+    if (cfg->crc_path && cfg->update) {
+        FILE *f = fopen(cfg->crc_path, "w");
+        if (!f) {
+            ESP_LOGE(TAG, "❌ Cannot write %s", cfg->crc_path);
+            failures++;
+        } else {
+            fprintf(f, "# Panel framebuffer CRC-32 after each displayed frame (t4_host --update-golden)\n");
+            for (size_t i = 0; i < check->expected_count; i++) {
+                fprintf(f, "%s %08lx\n", check->expected[i].label, (unsigned long)check->expected[i].crc);
+            }
+            fclose(f);
+            ESP_LOGI(TAG, "💾 Wrote %zu golden checksums to %s", check->expected_count, cfg->crc_path);
+        }
+    } else if (cfg->crc_path) {
+        if (check->next != check->expected_count) {
+            ESP_LOGE(TAG, "❌ %lu frames shown, golden list has %zu", (unsigned long)check->frames, check->expected_count);
+            failures++;
+        }
+        failures += check->crc_failures;
+        if (check->crc_failures == 0) {
+            ESP_LOGI(TAG, "✅ %lu frames match the golden checksums", (unsigned long)check->frames);
+        } else {
+            ESP_LOGE(TAG, "❌ %lu of %lu frames differ from the golden checksums",
+                     (unsigned long)check->crc_failures, (unsigned long)check->frames);
+        }
+    }
+
+    if (cfg->reference_dir) {
+        failures += check->pixel_failures;
+        ESP_LOGI(TAG, "🔍 Reference frames: %lu beyond ±%d, worst drift %d steps, %lu missing",
+                 (unsigned long)check->pixel_failures, cfg->tolerance, check->worst_diff, (unsigned long)check->missing_refs);
+    }
+
+    free(check->expected);
+    free(check);
+    return failures;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Golden-image checks for the host player. Every displayed frame is identified
+// by a label ("boot", "frame-00042") and checked in two optional ways:
+//  - checksum: CRC-32 of the panel framebuffer against a golden list
+//    (host/golden/panel_crc.txt), or rewrite that list with update = true
+//  - reference: per-pixel comparison against PPMs recorded earlier with
+//    t4_host --record, allowing 'tolerance' RGB565 steps per channel
+typedef struct golden_check golden_check_t;
+
+typedef struct {
+    const char *crc_path;       // Golden checksum list (NULL = no checksum check)
+    bool update;                // Rewrite crc_path from this run instead of comparing
+    const char *reference_dir;  // Directory with <label>.ppm files (NULL = no pixel check)
+    int tolerance;              // Allowed per-channel difference in RGB565 steps
+} golden_config_t;
+
+esp_err_t golden_open(const golden_config_t *config, golden_check_t **ret);
+
+// Check one frame; fb is width * height big-endian RGB565 pixels (panel byte order)
+void golden_check_frame(golden_check_t *check, const char *label, const uint16_t *fb, int width, int height);
+
+// Report, write the list when updating, free. Returns the number of failed frames.
+int golden_finish(golden_check_t *check);
@@ -0,0 +1,509 @@
+// Grayscale JPEG benchmark: decodes every manifest frame with esp_jpeg, takes its
+// luminance and encodes it as a baseline single-component JPEG (the standard
+// luminance tables, like convert.py --grayscale), then times esp_jpeg on the
+// colour frame and on the grey one. Also checks the grey decode is grey.
+// --write DIR saves the grey corpus (DIR/output/*.jpg, a manifest and
+// test.jpg) for the player's host_golden_frames_gray tests. --restart N puts
+// a restart marker every N blocks, for the decoder's RSTn handling.
+//
+// Built twice: gray_bench with the luminance path (CONFIG_JD_MONO_LUMA), and
+// gray_bench_generic decoding monochrome frames through the colour path.
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h>
+#include <sys/stat.h>
+#include "esp_timer.h"
+#include "jpeg_decoder.h"
+
+#define BENCH_WORK_SIZE 65472
+#define BENCH_MAX_PATH 512
+#define BENCH_MAX_CLIPS 32
+
+typedef struct {
+    char name[32];
+    int frames;
+    size_t color_bytes;
+    size_t gray_bytes;
+    int64_t color_us;   // Best pass, summed over frames
+    int64_t gray_us;
+    double sq_err;      // Luminance error of the grey decode, for the PSNR
+    size_t pixels;
+} clip_stats_t;
+
+// Annex K tables, in jpeg_default_huffman_table.c
+extern const unsigned char esp_jpeg_lum_dc_num_bits[16];
+extern const unsigned char esp_jpeg_lum_dc_values[12];
+extern const unsigned char esp_jpeg_lum_ac_num_bits[16];
+extern const unsigned char esp_jpeg_lum_ac_values[162];
+
+static const uint8_t k_zigzag[64] = {
+    0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+};
+
+static const uint8_t k_luma_quant[64] = {
+    16, 11, 10, 16,  24,  40,  51,  61,
+    12, 12, 14, 19,  26,  58,  60,  55,
+    14, 13, 16, 24,  40,  57,  69,  56,
+    14, 17, 22, 29,  51,  87,  80,  62,
+    18, 22, 37, 56,  68, 109, 103,  77,
+    24, 35, 55, 64,  81, 104, 113,  92,
+    49, 64, 78, 87, 103, 121, 120, 101,
+    72, 92, 95, 98, 112, 100, 103,  99,
+};
+
+typedef struct {
+    uint16_t code[256];
+    uint8_t size[256];
+} huff_table_t;
+
+typedef struct {
+    uint8_t *p;
+    uint32_t acc;
+    int bits;
+} bit_writer_t;
+
+// Canonical codes from the bit-length counts (T.81 Annex C)
+static void huff_build(huff_table_t *t, const unsigned char bits[16], const unsigned char *values)
+{
+    uint16_t code = 0;
+    int k = 0;
+    for (int len = 1; len <= 16; len++) {
+        for (int i = 0; i < bits[len - 1]; i++, k++) {
+            t->code[values[k]] = code++;
+            t->size[values[k]] = (uint8_t)len;
+        }
+        code <<= 1;
+    }
+}
+
+static void put_bits(bit_writer_t *w, uint32_t code, int len)
+{
+    w->acc = (w->acc << len) | (code & ((1u << len) - 1));
+    w->bits += len;
+    while (w->bits >= 8) {
+        uint8_t b = (uint8_t)(w->acc >> (w->bits - 8));
+        *w->p++ = b;
+        if (b == 0xFF) {
+            *w->p++ = 0;    // Byte stuffing
+        }
+        w->bits -= 8;
+    }
+    w->acc &= (1u << w->bits) - 1;
+}
+
+static int magnitude_bits(int v)
+{
+    int n = 0;
+    for (v = v < 0 ? -v : v; v; v >>= 1) {
+        n++;
+    }
+    return n;
+}
+
+// Category and the value bits (negative values as v - 1 in 'n' bits)
+static void put_value(bit_writer_t *w, const huff_table_t *t, int symbol, int v, int n)
+{
+    put_bits(w, t->code[symbol], t->size[symbol]);
+    if (n) {
+        put_bits(w, (uint32_t)(v < 0 ? v - 1 : v), n);
+    }
+}
+
+static uint8_t *put_marker(uint8_t *o, uint8_t marker, int len)
+{
+    *o++ = 0xFF;
+    *o++ = marker;
+    *o++ = (uint8_t)(len >> 8);
+    *o++ = (uint8_t)len;
+    return o;
+}
+
+static uint8_t *put_dht(uint8_t *o, uint8_t class_id, const unsigned char bits[16], const unsigned char *values)
+{
+    int count = 0;
+    for (int i = 0; i < 16; i++) {
+        count += bits[i];
+    }
+    o = put_marker(o, 0xC4, 2 + 1 + 16 + count);
+    *o++ = class_id;
+    memcpy(o, bits, 16);
+    memcpy(o + 16, values, count);
+    return o + 16 + count;
+}
+
+// Pad the last byte with 1 bits
+static void flush_bits(bit_writer_t *w)
+{
+    if (w->bits) {
+        put_bits(w, 0x7F, 8 - w->bits);
+    }
+}
+
+// Baseline JPEG, one component, 8x8 MCUs, IJG quality scaling of the Annex K luminance table;
+// restart markers every 'restart' MCUs when not 0
+static size_t gray_jpeg_encode(const uint8_t *luma, int width, int height, int quality, int restart, uint8_t *out)
+{
+    static huff_table_t dc, ac;
+    static double cosines[8][8];
+    if (!dc.size[0]) {
+        huff_build(&dc, esp_jpeg_lum_dc_num_bits, esp_jpeg_lum_dc_values);
+        huff_build(&ac, esp_jpeg_lum_ac_num_bits, esp_jpeg_lum_ac_values);
+        for (int x = 0; x < 8; x++) {
+            for (int u = 0; u < 8; u++) {
+                cosines[x][u] = cos((2 * x + 1) * u * M_PI / 16) * (u ? 0.5 : 0.5 / sqrt(2.0));
+            }
+        }
+    }
+    int scale = quality < 50 ? 5000 / quality : 200 - quality * 2;
+    uint8_t quant[64];
+    for (int i = 0; i < 64; i++) {
+        int q = (k_luma_quant[i] * scale + 50) / 100;
+        quant[i] = (uint8_t)(q < 1 ? 1 : q > 255 ? 255 : q);
+    }
+
+    uint8_t *o = out;
+    *o++ = 0xFF;
+    *o++ = 0xD8;
+    o = put_marker(o, 0xDB, 2 + 1 + 64);
+    *o++ = 0x00;
+    for (int k = 0; k < 64; k++) {
+        *o++ = quant[k_zigzag[k]];
+    }
+    o = put_marker(o, 0xC0, 2 + 6 + 3);
+    *o++ = 8;
+    *o++ = (uint8_t)(height >> 8);
+    *o++ = (uint8_t)height;
+    *o++ = (uint8_t)(width >> 8);
+    *o++ = (uint8_t)width;
+    *o++ = 1;       // Components
+    *o++ = 1;       // Id
+    *o++ = 0x11;    // 1x1 sampling
+    *o++ = 0;       // Quantisation table
+    o = put_dht(o, 0x00, esp_jpeg_lum_dc_num_bits, esp_jpeg_lum_dc_values);
+    o = put_dht(o, 0x10, esp_jpeg_lum_ac_num_bits, esp_jpeg_lum_ac_values);
+    if (restart) {
+        o = put_marker(o, 0xDD, 4);
+        *o++ = (uint8_t)(restart >> 8);
+        *o++ = (uint8_t)restart;
+    }
+    o = put_marker(o, 0xDA, 2 + 1 + 2 + 3);
+    *o++ = 1;
+    *o++ = 1;
+    *o++ = 0x00;    // DC/AC table 0
+    *o++ = 0;
+    *o++ = 63;
+    *o++ = 0;
+
+    bit_writer_t w = { .p = o };
+    int prev_dc = 0, mcus = 0;
+    for (int by = 0; by < height; by += 8) {
+        for (int bx = 0; bx < width; bx += 8) {
+            if (restart && mcus && mcus % restart == 0) {
+                flush_bits(&w);
+                *w.p++ = 0xFF;
+                *w.p++ = (uint8_t)(0xD0 + (mcus / restart - 1) % 8);
+                prev_dc = 0;
+            }
+            mcus++;
+            double block[64];
+            for (int y = 0; y < 8; y++) {
+                for (int x = 0; x < 8; x++) {
+                    int sx = bx + x < width ? bx + x : width - 1;   // Edge blocks repeat the last pixel
+                    int sy = by + y < height ? by + y : height - 1;
+                    block[y * 8 + x] = luma[sy * width + sx] - 128.0;
+                }
+            }
+            int coef[64];
+            for (int v = 0; v < 8; v++) {
+                for (int u = 0; u < 8; u++) {
+                    double sum = 0;
+                    for (int y = 0; y < 8; y++) {
+                        for (int x = 0; x < 8; x++) {
+                            sum += block[y * 8 + x] * cosines[x][u] * cosines[y][v];
+                        }
+                    }
+                    coef[v * 8 + u] = (int)lround(sum / quant[v * 8 + u]);
+                }
+            }
+
+            int diff = coef[0] - prev_dc;
+            prev_dc = coef[0];
+            int n = magnitude_bits(diff);
+            put_value(&w, &dc, n, diff, n);
+            int run = 0;
+            for (int k = 1; k < 64; k++) {
+                int v = coef[k_zigzag[k]];
+                if (!v) {
+                    run++;
+                    continue;
+                }
+                for (; run > 15; run -= 16) {
+                    put_bits(&w, ac.code[0xF0], ac.size[0xF0]);   // ZRL
+                }
+                n = magnitude_bits(v);
+                put_value(&w, &ac, run << 4 | n, v, n);
+                run = 0;
+            }
+            if (run) {
+                put_bits(&w, ac.code[0x00], ac.size[0x00]);   // EOB
+            }
+        }
+    }
+    flush_bits(&w);
+    o = w.p;
+    *o++ = 0xFF;
+    *o++ = 0xD9;
+    return o - out;
+}
+
+static bool write_file(const char *path, const void *data, size_t size)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+    bool ok = fwrite(data, 1, size, f) == size;
+    return fclose(f) == 0 && ok;
+}
+
+static uint8_t *load_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = malloc(*size);
+    if (data && fread(data, 1, *size, f) != *size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+// Clip name: frame name up to the last '-' ("spongebob-012.jpg" -> "spongebob")
+static clip_stats_t *clip_for(clip_stats_t *clips, int *num_clips, const char *frame)
+{
+    char name[32];
+    const char *dash = strrchr(frame, '-');
+    snprintf(name, sizeof(name), "%.*s", dash ? (int)(dash - frame) : (int)strlen(frame), frame);
+    for (int i = 0; i < *num_clips; i++) {
+        if (strcmp(clips[i].name, name) == 0) {
+            return &clips[i];
+        }
+    }
+    if (*num_clips == BENCH_MAX_CLIPS) {
+        return &clips[BENCH_MAX_CLIPS - 1];
+    }
+    clip_stats_t *c = &clips[(*num_clips)++];
+    snprintf(c->name, sizeof(c->name), "%s", name);
+    return c;
+}
+
+// Best of 'passes' decodes into RGB565 panel order, as the player asks for it
+static int64_t time_decode(esp_jpeg_image_cfg_t *cfg, int passes, bool *ok)
+{
+    esp_jpeg_image_output_t info;
+    int64_t best = INT64_MAX;
+    for (int p = 0; p < passes && *ok; p++) {
+        int64_t start = esp_timer_get_time();
+        *ok = esp_jpeg_decode(cfg, &info) == ESP_OK;
+        int64_t elapsed = esp_timer_get_time() - start;
+        best = elapsed < best ? elapsed : best;
+    }
+    return best;
+}
+
+static void print_row(const clip_stats_t *c)
+{
+    double mse = c->pixels ? c->sq_err / c->pixels : 0;
+    printf("%-14s %6d %9.1f %9.1f %10.1f %10.1f %7.2fx %7.1f\n", c->name, c->frames,
+           c->color_bytes / 1024.0, c->gray_bytes / 1024.0,
+           c->frames ? (double)c->color_us / c->frames : 0.0, c->frames ? (double)c->gray_us / c->frames : 0.0,
+           c->gray_us ? (double)c->color_us / c->gray_us : 0.0,
+           mse > 0 ? 10 * log10(255.0 * 255.0 / mse) : 99.0);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option long_opts[] = {
+        { "passes",  required_argument, NULL, 'p' },
+        { "quality", required_argument, NULL, 'q' },
+        { "write",   required_argument, NULL, 'w' },
+        { "restart", required_argument, NULL, 'r' },
+        { "help",    no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    int passes = 3;
+    int quality = 50;   // convert.py --jpeg_quality default
+    int restart = 0;
+    const char *write_dir = NULL;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "p:q:w:r:h", long_opts, NULL)) != -1) {
+        switch (opt) {
+        case 'p': passes = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+        case 'q': quality = atoi(optarg) < 1 ? 1 : atoi(optarg) > 100 ? 100 : atoi(optarg); break;
+        case 'w': write_dir = optarg; break;
+        case 'r': restart = atoi(optarg) > 0 ? atoi(optarg) : 0; break;
+        default:
+            fprintf(stderr, "usage: %s [--passes N] [--quality Q] [--restart MCUS] [--write DIR] [DATA_DIR]\n"
+                            "  Times grey against colour decodes of DATA_DIR/output/manifest.txt (default "
+                            GRAY_BENCH_DATA_DIR ")\n",
+                    argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+    const char *dir = optind < argc ? argv[optind] : GRAY_BENCH_DATA_DIR;
+
+    char path[BENCH_MAX_PATH];
+    snprintf(path, sizeof(path), "%s/output/manifest.txt", dir);
+    FILE *mf = fopen(path, "r");
+    if (!mf) {
+        fprintf(stderr, "❌ Cannot open %s\n", path);
+        return 1;
+    }
+
+    FILE *out_manifest = NULL;
+    if (write_dir) {
+        mkdir(write_dir, 0755);
+        snprintf(path, sizeof(path), "%s/output", write_dir);
+        mkdir(path, 0755);
+        snprintf(path, sizeof(path), "%s/output/manifest.txt", write_dir);
+        out_manifest = fopen(path, "w");
+        size_t boot_size = 0;
+        snprintf(path, sizeof(path), "%s/test.jpg", dir);
+        uint8_t *boot = load_file(path, &boot_size);
+        snprintf(path, sizeof(path), "%s/test.jpg", write_dir);
+        if (!out_manifest || !boot || !write_file(path, boot, boot_size)) {
+            fprintf(stderr, "❌ Cannot write the grey corpus to %s\n", write_dir);
+            return 1;
+        }
+        free(boot);
+    }
+
+    uint8_t *work = malloc(BENCH_WORK_SIZE);
+    clip_stats_t clips[BENCH_MAX_CLIPS] = { 0 };
+    int num_clips = 0;
+    int failures = 0, skipped = 0;
+    char line[256], fname[128];
+    while (fgets(line, sizeof(line), mf)) {
+        if (sscanf(line, "%127s", fname) != 1) {
+            continue;
+        }
+        size_t size = 0;
+        snprintf(path, sizeof(path), "%s/output/%s", dir, fname);
+        uint8_t *data = load_file(path, &size);
+        esp_jpeg_image_cfg_t cfg = {
+            .indata = data,
+            .indata_size = size,
+            .out_format = JPEG_IMAGE_FORMAT_RGB888,
+            .out_scale = JPEG_IMAGE_SCALE_0,
+            .advanced = { .working_buffer = work, .working_buffer_size = BENCH_WORK_SIZE },
+        };
+        esp_jpeg_image_output_t info;
+        if (!data || esp_jpeg_get_image_info(&cfg, &info) != ESP_OK) {
+            skipped++;
+            free(data);
+            continue;
+        }
+
+        size_t pixels = (size_t)info.width * info.height;
+        uint8_t *rgb = malloc(pixels * 3);
+        uint8_t *luma = malloc(pixels);
+        uint16_t *out = malloc(pixels * 2);
+        uint8_t *gray = malloc(pixels * 2 + 1024);   // Far above what a q >= 1 frame takes
+        cfg.outbuf = rgb;
+        cfg.outbuf_size = pixels * 3;
+        bool ok = esp_jpeg_decode(&cfg, &info) == ESP_OK;
+        for (size_t i = 0; ok && i < pixels; i++) {
+            const uint8_t *px = rgb + i * 3;
+            luma[i] = (uint8_t)((77 * px[0] + 150 * px[1] + 29 * px[2] + 128) >> 8);   // BT.601
+        }
+        size_t gray_size = ok ? gray_jpeg_encode(luma, info.width, info.height, quality, restart, gray) : 0;
+
+        cfg.out_format = JPEG_IMAGE_FORMAT_RGB565;
+        cfg.flags.swap_color_bytes = 1;
+        cfg.outbuf = (uint8_t *)out;
+        cfg.outbuf_size = pixels * 2;
+        int64_t color_us = time_decode(&cfg, passes, &ok);
+        cfg.indata = gray;
+        cfg.indata_size = gray_size;
+        int64_t gray_us = time_decode(&cfg, passes, &ok);
+
+        // Grey RGB565 has R = B = the top 5 bits of the luminance and G its top 6
+        double sq_err = 0;
+        for (size_t i = 0; ok && i < pixels; i++) {
+            uint16_t px = (uint16_t)(out[i] << 8 | out[i] >> 8);
+            int r = px >> 11, g = (px >> 5) & 63, b = px & 31;
+            if (r != b || g >> 1 != r) {
+                fprintf(stderr, "❌ %s: pixel %zu is not grey (%04x)\n", fname, i, px);
+                ok = false;
+            }
+            double d = (g << 2 | g >> 4) - luma[i];
+            sq_err += d * d;
+        }
+        if (!ok) {
+            fprintf(stderr, "❌ %s: grey encode or decode failed\n", fname);
+            failures++;
+        } else {
+            if (out_manifest) {
+                snprintf(path, sizeof(path), "%s/output/%s", write_dir, fname);
+                if (!write_file(path, gray, gray_size)) {
+                    fprintf(stderr, "❌ Cannot write %s\n", path);
+                    failures++;
+                }
+                fprintf(out_manifest, "%s %zu\n", fname, gray_size);
+            }
+            clip_stats_t *c = clip_for(clips, &num_clips, fname);
+            c->frames++;
+            c->color_bytes += size;
+            c->gray_bytes += gray_size;
+            c->color_us += color_us;
+            c->gray_us += gray_us;
+            c->sq_err += sq_err;
+            c->pixels += pixels;
+        }
+        free(rgb);
+        free(luma);
+        free(out);
+        free(gray);
+        free(data);
+    }
+    fclose(mf);
+    free(work);
+    if (out_manifest) {
+        fclose(out_manifest);
+    }
+
+    clip_stats_t total = { .name = "total" };
+    printf("%-14s %6s %9s %9s %10s %10s %8s %7s\n", "clip", "frames", "color KB", "grey KB", "color us",
+           "grey us", "speedup", "PSNR");
+    for (int i = 0; i < num_clips; i++) {
+        print_row(&clips[i]);
+        total.frames += clips[i].frames;
+        total.color_bytes += clips[i].color_bytes;
+        total.gray_bytes += clips[i].gray_bytes;
+        total.color_us += clips[i].color_us;
+        total.gray_us += clips[i].gray_us;
+        total.sq_err += clips[i].sq_err;
+        total.pixels += clips[i].pixels;
+    }
+    print_row(&total);
+    if (skipped) {
+        printf("%d frames skipped (unreadable or not JPEG)\n", skipped);
+    }
+    if (failures) {
+        printf("%d frames failed\n", failures);
+    }
+    return (failures == 0 && total.frames > 0) ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+// Host stand-in for main/encoder.c. Without a recording there is no knob and the
+// frame delay never changes; with host_encoder_load() the recorded edges go
+// through the glitch filter and PCNT models and the device's event queue as the
+// virtual clock passes their timestamps.
+
+#include "host_encoder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "ENC";
+
+static quadrature_decoder_t s_decoder;
+static encoder_queue_t s_queue;
+static encoder_edge_t *s_edges;
+static size_t s_edge_count;
+static size_t s_next_edge;
+static int64_t s_origin_us;   // Clock time that edge timestamp 0 maps to
+
+int encoder_edges_load(const char *path, encoder_edge_t **edges, size_t *count)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return -1;
+    }
+    size_t cap = 256, n = 0;
+    encoder_edge_t *list = malloc(cap * sizeof(encoder_edge_t));
+    char line[128];
+    long long ts;
+    int a, b;
+    while (list && fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || sscanf(line, "%lld %d %d", &ts, &a, &b) != 3) {
+            continue;
+        }
+        if (n == cap) {
+            cap *= 2;
+            list = realloc(list, cap * sizeof(encoder_edge_t));
+            if (!list) {
+                break;
+            }
+        }
+        list[n++] = (encoder_edge_t){ .ts_us = ts, .a = (uint8_t)a, .b = (uint8_t)b };
+    }
+    fclose(f);
+    if (!list) {
+        return -1;
+    }
+    *edges = list;
+    *count = n;
+    return 0;
+}
+
+size_t encoder_edges_filter_glitches(encoder_edge_t *edges, size_t count, int64_t glitch_us)
+{
+    size_t out = 0;
+    for (size_t i = 0; i < count; i++) {
+        // A pulse: the next edge restores the levels from before this one, too soon
+        bool pulse = out > 0 && i + 1 < count &&
+                     edges[i + 1].a == edges[out - 1].a && edges[i + 1].b == edges[out - 1].b &&
+                     edges[i + 1].ts_us - edges[i].ts_us < glitch_us;
+        if (pulse) {
+            i++;
+            continue;
+        }
+        edges[out++] = edges[i];
+    }
+    return out;
+}
+
+esp_err_t host_encoder_load(const char *path)
+{
+    free(s_edges);
+    s_edges = NULL;
+    if (encoder_edges_load(path, &s_edges, &s_edge_count) != 0) {
+        ESP_LOGE(TAG, "❌ Cannot read encoder edges from %s", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+    size_t raw = s_edge_count;
+    s_edge_count = encoder_edges_filter_glitches(s_edges, s_edge_count, ENCODER_GLITCH_NS / 1000);
+    s_next_edge = 0;
+    ESP_LOGI(TAG, "🎛️ Replaying %zu encoder edges from %s (%zu glitch edges filtered)", s_edge_count, path, raw - s_edge_count);
+    return ESP_OK;
+}
+
+esp_err_t encoder_init(void)
+{
+    quadrature_init(&s_decoder, QUADRATURE_REST_A, QUADRATURE_REST_B);
+    s_origin_us = esp_timer_get_time();
+    return ESP_OK;
+}
+
+// Deliver the edges the "ISR" would have seen by now
+static void replay_due_edges(void)
+{
+    int64_t now = esp_timer_get_time() - s_origin_us;
+    while (s_next_edge < s_edge_count && s_edges[s_next_edge].ts_us <= now) {
+        const encoder_edge_t *e = &s_edges[s_next_edge++];
+        int dir = quadrature_feed(&s_decoder, e->a, e->b);
+        if (dir) {
+            encoder_event_t ev = { .ts_us = (uint32_t)(s_origin_us + e->ts_us), .dir = (int8_t)dir };
+            encoder_queue_push(&s_queue, ev);
+        }
+    }
+}
+
+bool encoder_get_event(encoder_event_t *ev)
+{
+    replay_due_edges();
+    return encoder_queue_pop(&s_queue, ev);
+}
+
+uint32_t encoder_dropped_events(void)
+{
+    return s_queue.dropped;
+}
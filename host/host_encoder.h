@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "encoder.h"
+
+// Recorded encoder edge: A/B levels right after an edge on either line. Files hold one "<t_us> <A> <B>" line per edge, '#' starts a comment.
+typedef struct {
+    int64_t ts_us;   // Relative to the start of the recording
+    uint8_t a;
+    uint8_t b;
+} encoder_edge_t;
+
+// Read an edge file; returns 0 and a malloc'd list on success
+int encoder_edges_load(const char *path, encoder_edge_t **edges, size_t *count);
+
+// Model of the PCNT glitch filter: drops pulses (an edge undone by the next
+// one) shorter than glitch_us, in place. Returns the new count.
+size_t encoder_edges_filter_glitches(encoder_edge_t *edges, size_t count, int64_t glitch_us);
+
+// Replay an edge file through encoder_get_event(), with
+// edge time 0 at encoder_init()
+esp_err_t host_encoder_load(const char *path);
@@ -0,0 +1,361 @@
+// Host (Linux) entry point: runs the same boot image + manifest playback as
+// main/main.c against the mock panel and prints per-stage CPU timings.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "image_display.h"
+#include "mock_panel.h"
+#include "host_telemetry.h"
+#include "host_encoder.h"
+#include "golden.h"
+#include "span_trace.h"
+#include "frame_source.h"
+#include "storage_bench.h"
+#include "esp_partition.h"
+
+static const char *TAG = "T4_HOST";
+
+#define LCD_H_RES 320
+#define LCD_V_RES 240
+#define MANIFEST_NAME "output/manifest.txt"
+
+// Globals main/main.c provides on the device
+esp_lcd_panel_handle_t panel_handle = NULL;
+volatile uint32_t g_frame_delay_ms = 100;
+
+typedef struct {
+    const char *record_dir;   // NULL = don't write frames
+    int record_every;
+    golden_check_t *golden;   // NULL = no golden checks
+    const char *switch_clip;  // Clip to switch to after the first frame, NULL = none
+    uint32_t frames;
+    uint32_t recorded;
+} frame_recorder_t;
+
+// Called with the panel contents after every displayed frame ("boot" or "frame-NNNNN")
+static void capture_frame(frame_recorder_t *recorder, const char *label, bool sampled)
+{
+    if (recorder->record_dir && sampled) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s.ppm", recorder->record_dir, label);
+        if (mock_panel_write_ppm(panel_handle, path) == ESP_OK) {
+            recorder->recorded++;
+        } else {
+            ESP_LOGW(TAG, "⚠️ Failed to write %s", path);
+        }
+    }
+    if (recorder->golden) {
+        golden_check_frame(recorder->golden, label, mock_panel_framebuffer(panel_handle), LCD_H_RES, LCD_V_RES);
+    }
+}
+
+static void on_frame(const perf_frame_record_t *rec, void *ctx)
+{
+    frame_recorder_t *recorder = ctx;
+    char label[32];
+    snprintf(label, sizeof(label), "frame-%05u", (unsigned)recorder->frames);
+    capture_frame(recorder, label, recorder->frames % recorder->record_every == 0);
+    recorder->frames++;
+
+    // Mid-playback, the way a knob wiggle or another task would
+    if (recorder->switch_clip && recorder->frames == 1) {
+        bool all = strcmp(recorder->switch_clip, "all") == 0;
+        int clip = all ? -1 : image_display_find_clip(recorder->switch_clip);
+        if (!all && clip < 0) {
+            ESP_LOGW(TAG, "⚠️ No clip named %s", recorder->switch_clip);
+        } else {
+            image_display_select_clip(clip);
+        }
+    }
+}
+
+static esp_err_t show_boot_image(void)
+{
+    uint8_t *jpeg_data = NULL;
+    size_t file_size = 0;
+    if (frame_source_load("test.jpg", MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, &jpeg_data, &file_size) != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️ No test.jpg, skipping boot image");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    size_t out_buf_size = LCD_H_RES * LCD_V_RES * 2;
+    size_t work_buf_size = 65472;
+    uint8_t *out_buf = heap_caps_malloc(out_buf_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    uint8_t *work_buf = heap_caps_malloc(work_buf_size, MALLOC_CAP_8BIT);
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    if (out_buf && work_buf) {
+        ret = decode_and_display_jpeg(jpeg_data, file_size, out_buf, out_buf_size, work_buf, work_buf_size);
+    }
+    heap_caps_free(jpeg_data);
+    heap_caps_free(out_buf);
+    heap_caps_free(work_buf);
+    return ret;
+}
+
+static void print_summary(double wall_s, double virtual_s, bool spi_model)
+{
+    size_t count = 0;
+    const perf_frame_record_t *recs = host_telemetry_records(&count);
+    uint64_t sum[7] = { 0 };
+    uint32_t decoded = 0, errors = 0, duplicates = 0, previews = 0;
+    uint64_t preview_busy = 0;
+    uint32_t ahead = 0;                   // Drawn from the lookahead ring
+    uint32_t blends = 0;
+    uint64_t blend_us = 0, blend_busy = 0;
+    uint64_t ahead_path = 0, inline_path = 0;  // Time between the frame coming due and its draw
+
+    for (size_t i = 0; i < count; i++) {
+        if (recs[i].flags & PERF_FLAG_DUPLICATE) {
+            duplicates++;
+            continue;
+        }
+        if (recs[i].flags & PERF_FLAG_DECODE_ERROR) {
+            errors++;
+            continue;
+        }
+        if (recs[i].flags & PERF_FLAG_PREVIEW) {
+            // Reduced-scale decodes, kept out of the stage averages
+            previews++;
+            preview_busy += recs[i].prepare_us + recs[i].decode_us + recs[i].color_us + recs[i].scale_us + recs[i].spi_submit_us;
+            continue;
+        }
+        if (recs[i].flags & PERF_FLAG_BLEND) {
+            // In-betweens: decode_us is the blend kernel
+            blends++;
+            blend_us += recs[i].decode_us;
+            blend_busy += recs[i].decode_us + recs[i].scale_us + recs[i].spi_submit_us;
+            continue;
+        }
+        decoded++;
+        if (recs[i].flags & PERF_FLAG_LOOKAHEAD) {
+            ahead++;
+            ahead_path += recs[i].scale_us + recs[i].spi_submit_us;
+        } else {
+            inline_path += recs[i].prepare_us + recs[i].decode_us + recs[i].color_us + recs[i].scale_us + recs[i].spi_submit_us;
+        }
+        sum[0] += recs[i].prepare_us;
+        sum[1] += recs[i].decode_us;
+        sum[2] += recs[i].color_us;
+        sum[3] += recs[i].scale_us;
+        sum[4] += recs[i].spi_submit_us;
+        sum[5] += recs[i].prepare_us + recs[i].decode_us + recs[i].color_us + recs[i].scale_us + recs[i].spi_submit_us;
+        sum[6] += recs[i].spi_complete_us;
+    }
+
+    printf("frames: %zu played, %u decoded, %u duplicates skipped, %u errors\n",
+           count, (unsigned)decoded, (unsigned)duplicates, (unsigned)errors);
+    if (decoded) {
+        printf("avg us/frame: prepare %.1f  entropy+IDCT %.1f  colour %.1f  scale %.1f  submit %.1f  busy %.1f\n",
+               (double)sum[0] / decoded, (double)sum[1] / decoded, (double)sum[2] / decoded,
+               (double)sum[3] / decoded, (double)sum[4] / decoded, (double)sum[5] / decoded);
+        printf("avg us/frame SPI complete (draw start to last colour-done): %.1f\n", (double)sum[6] / decoded);
+        printf("CPU-bound rate: %.1f frames/s\n", decoded * 1e6 / (double)sum[5]);
+    }
+    if (ahead) {
+        printf("lookahead: %u of %u decoded ahead, on-time path %.1f us (%.1f us decoding inline)\n",
+               (unsigned)ahead, (unsigned)decoded, (double)ahead_path / ahead,
+               decoded > ahead ? (double)inline_path / (decoded - ahead) : 0.0);
+    }
+    if (blends) {
+        printf("blend: %u in-betweens, avg blend %.1f us, avg busy %.1f us\n", (unsigned)blends,
+               (double)blend_us / blends, (double)blend_busy / blends);
+    }
+    if (previews) {
+        printf("scrub: %u previews, avg busy %.1f us (CPU-bound %.1f frames/s)\n", (unsigned)previews,
+               (double)preview_busy / previews, preview_busy ? previews * 1e6 / (double)preview_busy : 0.0);
+    }
+    printf("panel: %u draws, %llu pixels\n", (unsigned)mock_panel_draw_count(panel_handle),
+           (unsigned long long)mock_panel_pixel_count(panel_handle));
+    printf("playback: %.2f s simulated (incl. pacing, %.1f frames/s), %.2f s wall\n",
+           virtual_s, virtual_s > 0 ? count / virtual_s : 0.0, wall_s);
+    if (spi_model) {
+        mock_panel_bus_stats_t bus;
+        mock_panel_bus_stats(panel_handle, &bus);
+        printf("SPI model: %u transactions, bus busy %.1f ms (%.1f%% of playback), draws blocked %.1f ms\n",
+               (unsigned)bus.transactions, bus.bus_busy_ns / 1e6,
+               virtual_s > 0 ? bus.bus_busy_ns / 1e7 / virtual_s : 0.0, bus.blocked_us / 1e3);
+    }
+}
+
+// Storage benchmark on every backend that mounts (pack only with --pack)
+static void run_storage_bench(int passes, bool have_pack)
+{
+    static const char *const names[] = { "spiffs", "littlefs", "pack" };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        const frame_source_t *source = frame_source_find(names[i]);
+        if (!source || (!have_pack && strcmp(names[i], "pack") == 0)) {
+            continue;
+        }
+        if (frame_source_init(source) == ESP_OK) {
+            storage_bench_run(MANIFEST_NAME, passes);
+        }
+    }
+}
+
+static void write_file(const void *data, size_t len, void *ctx)
+{
+    fwrite(data, 1, len, ctx);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [--loops N] [--delay MS] [--record DIR] [--record-every K] [--verbose|--quiet]\n"
+            "          [--golden FILE | --update-golden FILE] [--reference DIR] [--tolerance STEPS]\n"
+            "          [--spi-model] [--spi-mhz MHZ] [--cpu-scale F] [--trace FILE] [--encoder FILE]\n"
+            "          [--source spiffs|littlefs|pack] [--pack FILE] [--storage-bench N] [--clip NAME|all]\n"
+            "  Plays " MANIFEST_NAME " through the real player code\n"
+            "  --golden/--update-golden  check or rewrite per-frame panel checksums\n"
+            "  --reference               compare against PPMs from an earlier --record run\n"
+            "  --spi-model               simulate SPI bus timing (main.c panel IO settings);\n"
+            "                            with --cpu-scale (device/host CPU time ratio) and\n"
+            "                            --delay 0 the simulated rate predicts device fps\n"
+            "  --trace                   write the span trace dump (tools/trace_to_chrome.py input)\n"
+            "  --encoder                 replay recorded knob edges (host/encoder/*.edges) during playback\n"
+            "  --source                  frame storage backend (default spiffs; the filesystem ones read\n"
+            "                            " STORAGE_BASE_PATH ")\n"
+            "  --pack                    frame pack (tools/pack_frames.py) standing in for the storage partition\n"
+            "  --storage-bench           time stat/open/read on every backend, N passes, before playback\n"
+            "  --clip                    switch to clip NAME (\"larry\") after the first frame and loop it\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option long_opts[] = {
+        { "loops",        required_argument, NULL, 'n' },
+        { "delay",        required_argument, NULL, 'd' },
+        { "record",       required_argument, NULL, 'r' },
+        { "record-every", required_argument, NULL, 'e' },
+        { "verbose",      no_argument,       NULL, 'v' },
+        { "quiet",        no_argument,       NULL, 'q' },
+        { "golden",       required_argument, NULL, 'g' },
+        { "update-golden", required_argument, NULL, 'u' },
+        { "reference",    required_argument, NULL, 'R' },
+        { "tolerance",    required_argument, NULL, 't' },
+        { "spi-model",    no_argument,       NULL, 's' },
+        { "spi-mhz",      required_argument, NULL, 'm' },
+        { "cpu-scale",    required_argument, NULL, 'c' },
+        { "trace",        required_argument, NULL, 'T' },
+        { "encoder",      required_argument, NULL, 'E' },
+        { "source",       required_argument, NULL, 'S' },
+        { "pack",         required_argument, NULL, 'P' },
+        { "storage-bench", required_argument, NULL, 'B' },
+        { "clip",         required_argument, NULL, 'C' },
+        { "help",         no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    int loops = 1;
+    frame_recorder_t recorder = { .record_every = 1 };
+    golden_config_t golden = { .tolerance = 1 };
+    mock_panel_timing_t timing = MOCK_PANEL_TIMING_T4();
+    bool spi_model = false;
+    double cpu_scale = 1.0;
+    const char *trace_path = NULL;
+    const char *encoder_path = NULL;
+    const char *source_name = NULL;
+    const char *pack_path = NULL;
+    int storage_bench_passes = 0;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "n:d:r:e:vqg:u:R:t:sm:c:T:E:S:P:B:C:h", long_opts, NULL)) != -1) {
+        switch (opt) {
+        case 'n': loops = atoi(optarg); break;
+        case 'd': g_frame_delay_ms = (uint32_t)atoi(optarg); break;
+        case 'r': recorder.record_dir = optarg; break;
+        case 'e': recorder.record_every = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+        case 'v': host_log_set_level(ESP_LOG_DEBUG); break;
+        case 'q': host_log_set_level(ESP_LOG_WARN); break;
+        case 'g': golden.crc_path = optarg; golden.update = false; break;
+        case 'u': golden.crc_path = optarg; golden.update = true; break;
+        case 'R': golden.reference_dir = optarg; break;
+        case 't': golden.tolerance = atoi(optarg); break;
+        case 's': spi_model = true; break;
+        case 'm': timing.pclk_hz = (uint32_t)(atof(optarg) * 1e6); spi_model = true; break;
+        case 'c': cpu_scale = atof(optarg); break;
+        case 'T': trace_path = optarg; break;
+        case 'E': encoder_path = optarg; break;
+        case 'S': source_name = optarg; break;
+        case 'P': pack_path = optarg; break;
+        case 'B': storage_bench_passes = atoi(optarg); break;
+        case 'C': recorder.switch_clip = optarg; break;
+        default: usage(argv[0]); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (recorder.record_dir) {
+        mkdir(recorder.record_dir, 0755);
+    }
+    if ((golden.crc_path || golden.reference_dir) && golden_open(&golden, &recorder.golden) != ESP_OK) {
+        return 1;
+    }
+
+    const frame_source_t *source = NULL;   // NULL = default backend
+    if (source_name && !(source = frame_source_find(source_name))) {
+        fprintf(stderr, "unknown frame source '%s'\n", source_name);
+        return 2;
+    }
+    if (pack_path) {
+        ESP_ERROR_CHECK(host_partition_set_file("storage", pack_path));
+    }
+    if (storage_bench_passes > 0) {
+        run_storage_bench(storage_bench_passes, pack_path != NULL);
+    }
+    ESP_ERROR_CHECK(frame_source_init(source));
+    ESP_ERROR_CHECK(span_trace_init());
+    ESP_ERROR_CHECK(mock_panel_create(LCD_H_RES, LCD_V_RES, &panel_handle));
+    mock_panel_set_color_trans_done_cb(panel_handle, image_display_on_color_trans_done, NULL);
+    if (spi_model) {
+        mock_panel_set_timing(panel_handle, &timing);
+    }
+    host_clock_set_cpu_scale(cpu_scale);
+
+    if (show_boot_image() == ESP_OK) {
+        capture_frame(&recorder, "boot", true);
+    }
+
+    if (encoder_path && host_encoder_load(encoder_path) != ESP_OK) {
+        return 1;
+    }
+    encoder_init();
+
+    host_telemetry_set_frame_cb(on_frame, &recorder);
+    struct timespec wall_start, wall_end;
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    int64_t virtual_start = esp_timer_get_time();
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < loops && ret == ESP_OK; i++) {
+        ret = play_jpeg_sequence_from_manifest(MANIFEST_NAME, g_frame_delay_ms);
+    }
+    int64_t virtual_us = esp_timer_get_time() - virtual_start;
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+
+    print_summary((wall_end.tv_sec - wall_start.tv_sec) + (wall_end.tv_nsec - wall_start.tv_nsec) / 1e9, virtual_us / 1e6, spi_model);
+    int clip = image_display_current_clip();
+    printf("clips: %d indexed, playing %s\n", image_display_clip_count(),
+           clip >= 0 ? image_display_clip(clip)->name : "all");
+    if (encoder_path) {
+        printf("encoder: frame delay now %u ms, %u detents dropped\n",
+               (unsigned)g_frame_delay_ms, (unsigned)encoder_dropped_events());
+    }
+    if (recorder.record_dir) {
+        printf("recorded %u frames to %s\n", (unsigned)recorder.recorded, recorder.record_dir);
+    }
+    if (trace_path) {
+        FILE *tf = fopen(trace_path, "wb");
+        if (tf) {
+            span_trace_dump(write_file, tf);
+            fclose(tf);
+            printf("span trace written to %s\n", trace_path);
+        } else {
+            ESP_LOGW(TAG, "⚠️ Failed to write %s", trace_path);
+        }
+    }
+    int golden_failures = recorder.golden ? golden_finish(recorder.golden) : 0;
+    mock_panel_destroy(panel_handle);
+    return (ret == ESP_OK && recorder.frames > 0 && golden_failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+#include "host_telemetry.h"
+#include <stdlib.h>
+
+static perf_frame_record_t *s_records = NULL;
+static size_t s_count = 0;
+static size_t s_capacity = 0;
+static host_frame_cb_t s_frame_cb = NULL;
+static void *s_frame_ctx = NULL;
+
+esp_err_t perf_telemetry_init(void)
+{
+    return ESP_OK;
+}
+
+void perf_telemetry_commit(const perf_frame_record_t *rec)
+{
+    if (s_count == s_capacity) {
+        size_t capacity = s_capacity ? s_capacity * 2 : 1024;
+        perf_frame_record_t *records = realloc(s_records, capacity * sizeof(*records));
+        if (!records) {
+            return;
+        }
+        s_records = records;
+        s_capacity = capacity;
+    }
+    s_records[s_count++] = *rec;
+    if (s_frame_cb) {
+        s_frame_cb(rec, s_frame_ctx);
+    }
+}
+
+void perf_telemetry_poll(void)
+{
+}
+
+void perf_telemetry_flush(void)
+{
+}
+
+void host_telemetry_set_frame_cb(host_frame_cb_t cb, void *ctx)
+{
+    s_frame_cb = cb;
+    s_frame_ctx = ctx;
+}
+
+const perf_frame_record_t *host_telemetry_records(size_t *count)
+{
+    *count = s_count;
+    return s_records;
+}
+
+void host_telemetry_reset(void)
+{
+    s_count = 0;
+}
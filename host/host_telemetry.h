@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stddef.h>
+#include "perf_telemetry.h"
+
+// Host replacement for main/perf_telemetry.c: records stay in memory and every
+// committed record (one per played frame) is handed to an optional callback.
+
+typedef void (*host_frame_cb_t)(const perf_frame_record_t *rec, void *ctx);
+
+void host_telemetry_set_frame_cb(host_frame_cb_t cb, void *ctx);
+
+// All records committed so far, oldest first
+const perf_frame_record_t *host_telemetry_records(size_t *count);
+
+void host_telemetry_reset(void);
@@ -0,0 +1,126 @@
+// Colour MCU build benchmark: times the per-layout RGB MCU builders tjpgd picks in
+// jd_prepare (4:4:4, 4:2:2, 4:2:0) against the generic loop, and checks them
+// bit-exact against it over random Y/Cb/Cr blocks, including the out-of-range
+// samples DC-only blocks leave unclipped.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "esp_timer.h"
+
+// The builders are static: compile the decoder into this file
+#include "tjpgd.c"
+
+#define BENCH_MCUS 64   // Distinct MCUs cycled through per pass
+
+// Mean over 'passes' back-to-back runs, in microseconds per pass
+#define TIME_MEAN(passes, mean_us, stmt)                             \
+    do {                                                             \
+        int64_t start_ = esp_timer_get_time();                       \
+        for (int p_ = 0; p_ < (passes); p_++) {                      \
+            stmt;                                                    \
+        }                                                            \
+        mean_us = (double)(esp_timer_get_time() - start_) / (passes); \
+    } while (0)
+
+typedef struct {
+    const char *name;
+    unsigned int msx, msy;
+    void (*build)(JDEC *, uint8_t *);
+} layout_t;
+
+static const layout_t LAYOUTS[] = {
+    { "4:4:4", 1, 1, mcu_rgb_444 },
+    { "4:2:2", 2, 1, mcu_rgb_422 },
+    { "4:2:0", 2, 2, mcu_rgb_420 },
+};
+
+static void build_all(JDEC *jd, jd_yuv_t *mcus, size_t mcu_len, uint8_t *out, size_t out_len,
+                      void (*build)(JDEC *, uint8_t *))
+{
+    for (int i = 0; i < BENCH_MCUS; i++) {
+        jd->mcubuf = mcus + i * mcu_len;
+        build(jd, out + i * out_len);
+    }
+}
+
+static void print_row(const char *name, double us, double base_us, int pixels)
+{
+    printf("%-22s %9.2f %10.1f %8.2fx\n", name, us, us > 0 ? pixels / us : 0.0,
+           base_us > 0 ? us / base_us : 0.0);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option long_opts[] = {
+        { "passes", required_argument, NULL, 'p' },
+        { "help",   no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    int passes = 2000;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "p:h", long_opts, NULL)) != -1) {
+        switch (opt) {
+        case 'p': passes = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+        default:
+            fprintf(stderr, "usage: %s [--passes N]\n"
+                            "  Times the RGB MCU builders on %d MCUs per layout and checks them against the generic loop\n",
+                    argv[0], BENCH_MCUS);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    int mismatches = 0;
+    printf("%-22s %9s %10s %9s\n", "kernel", "us/pass", "Mpx/s", "vs generic");
+    for (size_t l = 0; l < sizeof(LAYOUTS) / sizeof(LAYOUTS[0]); l++) {
+        const layout_t *lay = &LAYOUTS[l];
+        const size_t mcu_len = (lay->msx * lay->msy + 2) * 64;     // Y blocks, Cb, Cr
+        const size_t out_len = lay->msx * lay->msy * 64 * 3;       // RGB888
+        jd_yuv_t *mcus = malloc(BENCH_MCUS * mcu_len * sizeof(jd_yuv_t));
+        uint8_t *want = malloc(BENCH_MCUS * out_len);
+        uint8_t *got = malloc(BENCH_MCUS * out_len);
+
+        srand(420 + (int)l);
+        for (size_t i = 0; i < BENCH_MCUS * mcu_len; i++) {
+            // Wider than 0..255 where the sample type allows it: DC-only blocks are not clipped
+            mcus[i] = (jd_yuv_t)((jd_yuv_t)-1 < 0 ? rand() % 768 - 256 : rand() % 256);
+        }
+
+        JDEC jd;
+        memset(&jd, 0, sizeof(jd));
+        jd.msx = (uint8_t)lay->msx;
+        jd.msy = (uint8_t)lay->msy;
+        build_all(&jd, mcus, mcu_len, want, out_len, mcu_rgb_generic);
+        memset(got, 0xA5, BENCH_MCUS * out_len);
+        build_all(&jd, mcus, mcu_len, got, out_len, lay->build);
+        int bad = 0;
+        for (size_t i = 0; i < BENCH_MCUS * out_len; i++) {
+            if (got[i] != want[i] && bad++ < 5) {
+                size_t px = (i % out_len) / 3;
+                fprintf(stderr, "❌ %s MCU %zu px (%zu,%zu) ch %zu: %u, want %u\n", lay->name, i / out_len,
+                        px % (lay->msx * 8), px / (lay->msx * 8), i % 3, got[i], want[i]);
+            }
+        }
+        mismatches += bad;
+
+        double generic_us, layout_us;
+        TIME_MEAN(passes, generic_us, build_all(&jd, mcus, mcu_len, got, out_len, mcu_rgb_generic));
+        TIME_MEAN(passes, layout_us, build_all(&jd, mcus, mcu_len, got, out_len, lay->build));
+        char name[32];
+        const int pixels = (int)(BENCH_MCUS * out_len / 3);
+        snprintf(name, sizeof(name), "%s generic", lay->name);
+        print_row(name, generic_us, generic_us, pixels);
+        snprintf(name, sizeof(name), "%s specialised", lay->name);
+        print_row(name, layout_us, generic_us, pixels);
+
+        free(mcus);
+        free(want);
+        free(got);
+    }
+
+    if (mismatches) {
+        printf("%d bytes differ from the generic loop\n", mismatches);
+    }
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,245 @@
+#include "mock_panel.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_timer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MOCK_PANEL_MAX_INFLIGHT 64
+
+typedef struct {
+    int64_t done_ns;   // Simulated completion time
+    bool last;         // Last chunk of a draw: fires on_color_trans_done
+} mock_trans_t;
+
+struct esp_lcd_panel_io_t {
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    void *user_ctx;
+};
+
+struct esp_lcd_panel_t {
+    int width;
+    int height;
+    uint16_t *fb;
+    struct esp_lcd_panel_io_t io;
+    uint32_t draws;
+    uint64_t pixels;
+
+    bool timed;                 // Timing model enabled
+    mock_panel_timing_t timing;
+    int64_t bus_free_ns;        // When the bus finishes everything submitted so far
+    mock_trans_t inflight[MOCK_PANEL_MAX_INFLIGHT]; // Queued colour transactions, in bus order
+    int inflight_head;
+    int inflight_count;
+    mock_panel_bus_stats_t stats;
+};
+
+esp_err_t mock_panel_create(int width, int height, esp_lcd_panel_handle_t *ret_panel)
+{
+    struct esp_lcd_panel_t *panel = calloc(1, sizeof(*panel));
+    if (!panel) {
+        return ESP_ERR_NO_MEM;
+    }
+    panel->fb = calloc((size_t)width * height, sizeof(uint16_t));
+    if (!panel->fb) {
+        free(panel);
+        return ESP_ERR_NO_MEM;
+    }
+    panel->width = width;
+    panel->height = height;
+    *ret_panel = panel;
+    return ESP_OK;
+}
+
+void mock_panel_destroy(esp_lcd_panel_handle_t panel)
+{
+    if (panel) {
+        if (panel->timed) {
+            host_clock_set_event_source(NULL);
+        }
+        free(panel->fb);
+        free(panel);
+    }
+}
+
+void mock_panel_set_color_trans_done_cb(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_color_trans_done_cb_t cb, void *user_ctx)
+{
+    panel->io.on_color_trans_done = cb;
+    panel->io.user_ctx = user_ctx;
+}
+
+esp_err_t esp_lcd_panel_io_register_event_callbacks(esp_lcd_panel_io_handle_t io,
+                                                    const esp_lcd_panel_io_callbacks_t *cbs, void *user_ctx)
+{
+    io->on_color_trans_done = cbs->on_color_trans_done;
+    io->user_ctx = user_ctx;
+    return ESP_OK;
+}
+
+const uint16_t *mock_panel_framebuffer(esp_lcd_panel_handle_t panel)
+{
+    return panel->fb;
+}
+
+uint32_t mock_panel_draw_count(esp_lcd_panel_handle_t panel)
+{
+    return panel->draws;
+}
+
+uint64_t mock_panel_pixel_count(esp_lcd_panel_handle_t panel)
+{
+    return panel->pixels;
+}
+
+static int64_t next_event_us(void *ctx)
+{
+    struct esp_lcd_panel_t *panel = ctx;
+    if (!panel->inflight_count) {
+        return INT64_MAX;
+    }
+    return (panel->inflight[panel->inflight_head].done_ns + 999) / 1000;
+}
+
+static void run_event(void *ctx)
+{
+    struct esp_lcd_panel_t *panel = ctx;
+    mock_trans_t t = panel->inflight[panel->inflight_head];
+    panel->inflight_head = (panel->inflight_head + 1) % MOCK_PANEL_MAX_INFLIGHT;
+    panel->inflight_count--;
+    if (t.last && panel->io.on_color_trans_done) {
+        panel->io.on_color_trans_done(&panel->io, NULL, panel->io.user_ctx);
+    }
+}
+
+void mock_panel_set_timing(esp_lcd_panel_handle_t panel, const mock_panel_timing_t *timing)
+{
+    panel->timed = timing != NULL;
+    if (timing) {
+        panel->timing = *timing;
+        if (panel->timing.trans_queue_depth > MOCK_PANEL_MAX_INFLIGHT) {
+            panel->timing.trans_queue_depth = MOCK_PANEL_MAX_INFLIGHT;
+        }
+        host_event_source_t source = { .next_event_us = next_event_us, .run_event = run_event, .ctx = panel };
+        host_clock_set_event_source(&source);
+    } else {
+        host_clock_set_event_source(NULL);
+    }
+}
+
+void mock_panel_bus_stats(esp_lcd_panel_handle_t panel, mock_panel_bus_stats_t *stats)
+{
+    *stats = panel->stats;
+}
+
+static int64_t bus_time_ns(const struct esp_lcd_panel_t *panel, uint64_t bits)
+{
+    return (int64_t)(bits * 1000000000ull / panel->timing.pclk_hz);
+}
+
+// Wait (advancing the clock) until at most 'max_inflight' queued transactions remain
+static void wait_inflight(struct esp_lcd_panel_t *panel, int max_inflight)
+{
+    int64_t start = esp_timer_get_time();
+    while (panel->inflight_count > max_inflight) {
+        host_clock_wait_event(INT64_MAX);
+    }
+    panel->stats.blocked_us += esp_timer_get_time() - start;
+}
+
+// Polling transaction: waits for the queue to drain, then busy-waits for its own bits
+static void polling_trans(struct esp_lcd_panel_t *panel, uint32_t bits)
+{
+    wait_inflight(panel, 0);
+    int64_t now_ns = esp_timer_get_time() * 1000;
+    int64_t start = panel->bus_free_ns > now_ns ? panel->bus_free_ns : now_ns;
+    int64_t len = panel->timing.polling_overhead_ns + bus_time_ns(panel, bits);
+    panel->bus_free_ns = start + len;
+    panel->stats.transactions++;
+    panel->stats.bus_busy_ns += len;
+
+    int64_t wait_us = (panel->bus_free_ns + 999) / 1000 - esp_timer_get_time();
+    if (wait_us > 0) {
+        host_clock_advance_us(wait_us);
+        panel->stats.blocked_us += wait_us;
+    }
+}
+
+// CASET / RASET / RAMWR followed by the pixel data as queued transactions
+static void timed_draw(struct esp_lcd_panel_t *panel, size_t color_bytes)
+{
+    const mock_panel_timing_t *t = &panel->timing;
+    host_clock_run_due_events();
+    polling_trans(panel, t->cmd_bits);          // CASET
+    polling_trans(panel, 4 * t->param_bits);
+    polling_trans(panel, t->cmd_bits);          // RASET
+    polling_trans(panel, 4 * t->param_bits);
+    polling_trans(panel, t->cmd_bits);          // RAMWR
+
+    for (size_t off = 0; off < color_bytes; off += t->max_transfer_sz) {
+        size_t len = color_bytes - off < t->max_transfer_sz ? color_bytes - off : t->max_transfer_sz;
+        wait_inflight(panel, t->trans_queue_depth - 1);
+        int64_t now_ns = esp_timer_get_time() * 1000;
+        int64_t start = panel->bus_free_ns > now_ns ? panel->bus_free_ns : now_ns;
+        int64_t dur = t->queued_overhead_ns + bus_time_ns(panel, (uint64_t)len * 8);
+        panel->bus_free_ns = start + dur;
+        panel->stats.transactions++;
+        panel->stats.bus_busy_ns += dur;
+
+        int slot = (panel->inflight_head + panel->inflight_count) % MOCK_PANEL_MAX_INFLIGHT;
+        panel->inflight[slot] = (mock_trans_t) { .done_ns = panel->bus_free_ns, .last = off + len >= color_bytes };
+        panel->inflight_count++;
+    }
+}
+
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start,
+                                    int x_end, int y_end, const void *color_data)
+{
+    if (!panel || !color_data || x_start >= x_end || y_start >= y_end) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (x_start < 0 || y_start < 0 || x_end > panel->width || y_end > panel->height) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const uint16_t *src = color_data;
+    const int w = x_end - x_start;
+    for (int y = y_start; y < y_end; y++) {
+        memcpy(panel->fb + (size_t)y * panel->width + x_start, src, w * sizeof(uint16_t));
+        src += w;
+    }
+    panel->draws++;
+    panel->pixels += (uint64_t)w * (y_end - y_start);
+
+    // The framebuffer is updated at submit time either way, so recorded frames don't depend on timing
+    if (panel->timed) {
+        timed_draw(panel, (size_t)w * (y_end - y_start) * sizeof(uint16_t));
+    } else if (panel->io.on_color_trans_done) {
+        panel->io.on_color_trans_done(&panel->io, NULL, panel->io.user_ctx);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_disp_on_off(esp_lcd_panel_handle_t panel, bool on_off)
+{
+    return ESP_OK;
+}
+
+esp_err_t mock_panel_write_ppm(esp_lcd_panel_handle_t panel, const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        return ESP_FAIL;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", panel->width, panel->height);
+    const uint8_t *px = (const uint8_t *)panel->fb;
+    for (int i = 0; i < panel->width * panel->height; i++, px += 2) {
+        uint16_t v = (uint16_t)(px[0] << 8 | px[1]); // Panel byte order is big-endian RGB565
+        uint8_t rgb[3] = {
+            (uint8_t)(((v >> 11) & 0x1F) * 255 / 31),
+            (uint8_t)(((v >> 5) & 0x3F) * 255 / 63),
+            (uint8_t)((v & 0x1F) * 255 / 31),
+        };
+        fwrite(rgb, 1, sizeof(rgb), f);
+    }
+    fclose(f);
+    return ESP_OK;
+}
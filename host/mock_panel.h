@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+
+// Host stand-in for the ILI9341 + SPI panel IO. Draws land in a logical
+// (post swap_xy/mirror) framebuffer in the panel's byte order, i.e. the
+// byte-swapped RGB565 the player produces. Without a timing model the
+// colour-done callback fires at the end of every draw; with one it fires when
+// the simulated bus would have finished the transfer.
+
+// Create a panel of width x height logical pixels
+esp_err_t mock_panel_create(int width, int height, esp_lcd_panel_handle_t *ret_panel);
+void mock_panel_destroy(esp_lcd_panel_handle_t panel);
+
+// Register the on_color_trans_done callback (same role as esp_lcd_panel_io_spi_config_t)
+void mock_panel_set_color_trans_done_cb(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_color_trans_done_cb_t cb, void *user_ctx);
+
+// Framebuffer access (width * height pixels, panel byte order)
+const uint16_t *mock_panel_framebuffer(esp_lcd_panel_handle_t panel);
+
+// Number of draw_bitmap calls and pixels written since creation
+uint32_t mock_panel_draw_count(esp_lcd_panel_handle_t panel);
+uint64_t mock_panel_pixel_count(esp_lcd_panel_handle_t panel);
+
+// SPI bus timing model, mirroring esp_lcd's SPI panel IO + the ILI9341 driver:
+// every draw sends CASET, RASET (command + 4 parameter bytes each) and RAMWR as
+// polling transactions, each of which first waits for the queued colour
+// transactions of the previous draw; the pixel data then goes out as queued
+// transactions of at most max_transfer_sz bytes, the caller blocking while
+// trans_queue_depth of them are in flight. The overheads are estimates of the
+// driver / DMA set-up cost per transaction; calibrate them against the device's
+// spi_complete telemetry.
+typedef struct {
+    uint32_t pclk_hz;             // SPI clock
+    int cmd_bits;                 // lcd_cmd_bits
+    int param_bits;               // lcd_param_bits
+    int trans_queue_depth;        // trans_queue_depth
+    size_t max_transfer_sz;       // Bus max_transfer_sz (bytes per colour transaction)
+    uint32_t polling_overhead_ns; // Per polling transaction (commands, parameters)
+    uint32_t queued_overhead_ns;  // Per queued colour transaction
+} mock_panel_timing_t;
+
+// The T4 configuration from main/main.c
+#define MOCK_PANEL_TIMING_T4() {            \
+    .pclk_hz = 40 * 1000 * 1000,            \
+    .cmd_bits = 8,                          \
+    .param_bits = 8,                        \
+    .trans_queue_depth = 10,                \
+    .max_transfer_sz = 320 * 80 * 2,        \
+    .polling_overhead_ns = 10000,           \
+    .queued_overhead_ns = 4000,             \
+}
+
+typedef struct {
+    uint32_t transactions;  // Polling + queued transactions
+    uint64_t bus_busy_ns;   // Time the bus spent on transactions incl. overheads
+    uint64_t blocked_us;    // Time draw calls spent waiting for the bus
+} mock_panel_bus_stats_t;
+
+// Enable the timing model (NULL = instant draws). Registers the panel as the
+// host clock's event source, so completions fire from vTaskDelay / xSemaphoreTake.
+void mock_panel_set_timing(esp_lcd_panel_handle_t panel, const mock_panel_timing_t *timing);
+void mock_panel_bus_stats(esp_lcd_panel_handle_t panel, mock_panel_bus_stats_t *stats);
+
+// Write the framebuffer as a binary PPM (P6, RGB888)
+esp_err_t mock_panel_write_ppm(esp_lcd_panel_handle_t panel, const char *path);
@@ -0,0 +1,233 @@
+// RGB565 pixel kernel benchmark: times the player's per-pixel kernels on a
+// 160x120 frame (the corpus size) and checks each against a plain per-channel
+// reference over every weight/mode it supports. memcpy of the same frame is
+// the yardstick for the blend, nearest-neighbour for the upscalers. The
+// index-table scaler must match nearest-neighbour at whole factors.
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "esp_timer.h"
+#include "rgb565_blend.h"
+#include "rgb565_scale.h"
+
+#define BENCH_W 160
+#define BENCH_H 120
+#define BENCH_PIXELS (BENCH_W * BENCH_H)
+
+static uint16_t swap16(uint16_t px)
+{
+    return (uint16_t)(px << 8 | px >> 8);
+}
+
+// Same maths one channel at a time; also the baseline the SWAR kernel is timed against
+static uint16_t blend_ref(uint16_t a, uint16_t b, int w, bool swapped)
+{
+    if (swapped) {
+        a = swap16(a);
+        b = swap16(b);
+    }
+    int r = ((a >> 11) * (32 - w) + (b >> 11) * w + 16) >> 5;
+    int g = (((a >> 5) & 63) * (32 - w) + ((b >> 5) & 63) * w + 16) >> 5;
+    int bl = ((a & 31) * (32 - w) + (b & 31) * w + 16) >> 5;
+    uint16_t px = (uint16_t)(r << 11 | g << 5 | bl);
+    return swapped ? swap16(px) : px;
+}
+
+static uint16_t px_at(const uint16_t *src, int x, int y, bool swapped)
+{
+    x = x < 0 ? 0 : x >= BENCH_W ? BENCH_W - 1 : x;
+    y = y < 0 ? 0 : y >= BENCH_H ? BENCH_H - 1 : y;
+    return swapped ? swap16(src[y * BENCH_W + x]) : src[y * BENCH_W + x];
+}
+
+// Bilinear 2x output pixel (dx, dy): 9/16 of its source pixel, 3/16 of each neighbour
+// towards it and 1/16 of the diagonal one
+static uint16_t bilinear_ref(const uint16_t *src, int dx, int dy, bool swapped)
+{
+    int x = dx / 2, y = dy / 2;
+    int nx = x + (dx & 1 ? 1 : -1), ny = y + (dy & 1 ? 1 : -1);
+    uint16_t p[4] = { px_at(src, x, y, swapped), px_at(src, nx, y, swapped),
+                      px_at(src, x, ny, swapped), px_at(src, nx, ny, swapped) };
+    static const int w[4] = { 9, 3, 3, 1 };
+    int r = 8, g = 8, b = 8;
+    for (int i = 0; i < 4; i++) {
+        r += (p[i] >> 11) * w[i];
+        g += ((p[i] >> 5) & 63) * w[i];
+        b += (p[i] & 31) * w[i];
+    }
+    uint16_t px = (uint16_t)((r >> 4) << 11 | (g >> 4) << 5 | (b >> 4));
+    return swapped ? swap16(px) : px;
+}
+
+// Independent fit/fill geometry: source pixel under the centre of each output pixel
+static int table_mismatches(const uint16_t *src, int src_w, int src_h, bool fill, const uint16_t *got)
+{
+    double ratio_w = 320.0 / src_w, ratio_h = 240.0 / src_h;
+    double ratio = fill ? (ratio_w > ratio_h ? ratio_w : ratio_h) : (ratio_w < ratio_h ? ratio_w : ratio_h);
+    int scaled_w = (int)(src_w * ratio + 0.5), scaled_h = (int)(src_h * ratio + 0.5);
+    int dst_w = scaled_w < 320 ? scaled_w : 320, dst_h = scaled_h < 240 ? scaled_h : 240;
+    int crop_x = (scaled_w - dst_w) / 2, crop_y = (scaled_h - dst_h) / 2;
+    int bad = 0;
+    for (int y = 0; y < dst_h; y++) {
+        int sy = (int)((y + crop_y + 0.5) * src_h / scaled_h);
+        for (int x = 0; x < dst_w; x++) {
+            int sx = (int)((x + crop_x + 0.5) * src_w / scaled_w);
+            if (got[y * dst_w + x] != src[sy * src_w + sx] && bad++ < 5) {
+                fprintf(stderr, "❌ table %dx%d %s px (%d,%d): %04x, want %04x\n", src_w, src_h,
+                        fill ? "fill" : "fit", x, y, got[y * dst_w + x], src[sy * src_w + sx]);
+            }
+        }
+    }
+    return bad;
+}
+
+// Mean over 'passes' back-to-back runs, in microseconds per frame
+#define TIME_MEAN(passes, mean_us, stmt)                             \
+    do {                                                             \
+        int64_t start_ = esp_timer_get_time();                       \
+        for (int p_ = 0; p_ < (passes); p_++) {                      \
+            stmt;                                                    \
+        }                                                            \
+        mean_us = (double)(esp_timer_get_time() - start_) / (passes); \
+    } while (0)
+
+static void print_row(const char *name, double us, double base_us)
+{
+    printf("%-22s %9.2f %10.1f %8.2fx\n", name, us, us > 0 ? BENCH_PIXELS / us : 0.0,
+           base_us > 0 ? us / base_us : 0.0);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option long_opts[] = {
+        { "passes", required_argument, NULL, 'p' },
+        { "help",   no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    int passes = 2000;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "p:h", long_opts, NULL)) != -1) {
+        switch (opt) {
+        case 'p': passes = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+        default:
+            fprintf(stderr, "usage: %s [--passes N]\n"
+                            "  Times the RGB565 kernels on a %dx%d frame and checks them against a reference\n",
+                    argv[0], BENCH_W, BENCH_H);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    uint16_t *a = malloc(BENCH_PIXELS * 2);
+    uint16_t *b = malloc(BENCH_PIXELS * 2);
+    uint16_t *out = malloc(BENCH_PIXELS * 2);
+    uint16_t *big = malloc(BENCH_PIXELS * 2 * 4);
+    uint16_t *nn_big = malloc(BENCH_PIXELS * 2 * 4);
+    srand(565);
+    for (int i = 0; i < BENCH_PIXELS; i++) {
+        a[i] = (uint16_t)rand();
+        b[i] = (uint16_t)rand();
+    }
+    // Extremes, where a carry between channels would show first
+    a[0] = 0xFFFF; b[0] = 0x0000;
+    a[1] = 0x0000; b[1] = 0xFFFF;
+    a[2] = 0xFFFF; b[2] = 0xFFFF;
+
+    int mismatches = 0;
+    for (int swapped = 0; swapped <= 1; swapped++) {
+        for (int w = 0; w <= RGB565_BLEND_ONE; w++) {
+            // Odd count, so the scalar tail is covered too
+            rgb565_blend(a, b, out, BENCH_PIXELS - 1, w, swapped);
+            for (int i = 0; i < BENCH_PIXELS - 1; i++) {
+                if (out[i] != blend_ref(a[i], b[i], w, swapped)) {
+                    if (mismatches++ < 5) {
+                        fprintf(stderr, "❌ blend w=%d swapped=%d px %d: %04x + %04x -> %04x, want %04x\n", w, swapped,
+                                i, a[i], b[i], out[i], blend_ref(a[i], b[i], w, swapped));
+                    }
+                }
+            }
+        }
+    }
+
+    // Bilinear, whole frame and in the player's 8-row bands (which read one row past each band)
+    for (int swapped = 0; swapped <= 1; swapped++) {
+        for (int band = 0; band <= 1; band++) {
+            for (int y0 = 0; y0 < BENCH_H; y0 += band ? 8 : BENCH_H) {
+                int rows = band ? (BENCH_H - y0 < 8 ? BENCH_H - y0 : 8) : BENCH_H;
+                bilinear_scale_2x_rgb565(a, big + y0 * 2 * BENCH_W * 2, BENCH_W, BENCH_H, y0, rows, swapped);
+            }
+            for (int i = 0; i < BENCH_PIXELS * 4; i++) {
+                uint16_t want = bilinear_ref(a, i % (BENCH_W * 2), i / (BENCH_W * 2), swapped);
+                if (big[i] != want && mismatches++ < 5) {
+                    fprintf(stderr, "❌ bilinear swapped=%d bands=%d px %d: %04x, want %04x\n", swapped, band, i,
+                            big[i], want);
+                }
+            }
+        }
+    }
+
+    // Index tables: whole factors against nearest-neighbour, other ratios against the geometry above
+    static rgb565_scale_map_t map;
+    static const struct { int w, h, factor; } whole[] = { { BENCH_W, BENCH_H, 2 }, { 100, 80, 3 } };
+    for (int i = 0; i < 2; i++) {
+        rgb565_scale_map_init(&map, whole[i].w, whole[i].h, 320, 240, false);
+        table_scale_rows_rgb565(a, big, &map, 0, map.dst_h);
+        nn_scale_band_rgb565(a, nn_big, whole[i].w, whole[i].h, whole[i].factor);
+        size_t len = (size_t)whole[i].w * whole[i].h * whole[i].factor * whole[i].factor;
+        if (map.dst_w != whole[i].w * whole[i].factor || memcmp(big, nn_big, len * 2) != 0) {
+            if (mismatches++ < 5) {
+                fprintf(stderr, "❌ table %dx%d is not nearest-neighbour %dx\n", whole[i].w, whole[i].h,
+                        whole[i].factor);
+            }
+        }
+    }
+    static const struct { int w, h; } odd[] = { { 150, 100 }, { 176, 144 }, { 64, 64 }, { 213, 97 } };
+    for (int i = 0; i < 4; i++) {
+        for (int fill = 0; fill <= 1; fill++) {
+            rgb565_scale_map_init(&map, odd[i].w, odd[i].h, 320, 240, fill);
+            table_scale_rows_rgb565(a, big, &map, 0, map.dst_h);
+            mismatches += table_mismatches(a, odd[i].w, odd[i].h, fill, big);
+        }
+    }
+
+    double nn_us, nn_band_us, bilinear_us, bilinear_swapped_us;
+    TIME_MEAN(passes, nn_us, nn_scale_2x_rgb565(a, big, BENCH_W, BENCH_H));
+    TIME_MEAN(passes, nn_band_us, nn_scale_band_rgb565(a, big, BENCH_W, BENCH_H, 2));
+    TIME_MEAN(passes, bilinear_us, bilinear_scale_2x_rgb565(a, big, BENCH_W, BENCH_H, 0, BENCH_H, false));
+    double table_us, table_fill_us;
+    rgb565_scale_map_init(&map, BENCH_W, BENCH_H, 320, 240, false);
+    TIME_MEAN(passes, table_us, table_scale_rows_rgb565(a, big, &map, 0, map.dst_h));
+    rgb565_scale_map_init(&map, 150, 100, 320, 240, true);   // 2.4x, cropped at the sides
+    TIME_MEAN(passes, table_fill_us, table_scale_rows_rgb565(a, big, &map, 0, map.dst_h));
+    TIME_MEAN(passes, bilinear_swapped_us, bilinear_scale_2x_rgb565(a, big, BENCH_W, BENCH_H, 0, BENCH_H, true));
+
+    double copy_us, ref_us, blend_us, blend_swapped_us;
+    TIME_MEAN(passes, copy_us, memcpy(out, a, BENCH_PIXELS * 2));
+    TIME_MEAN(passes, ref_us, for (int i = 0; i < BENCH_PIXELS; i++) out[i] = blend_ref(a[i], b[i], 11, true));
+    TIME_MEAN(passes, blend_us, rgb565_blend(a, b, out, BENCH_PIXELS, 11, false));
+    TIME_MEAN(passes, blend_swapped_us, rgb565_blend(a, b, out, BENCH_PIXELS, 11, true));
+
+    printf("%-22s %9s %10s %9s\n", "kernel", "us/frame", "Mpixel/s", "vs copy");
+    print_row("memcpy", copy_us, copy_us);
+    print_row("blend (per channel)", ref_us, copy_us);
+    print_row("blend", blend_us, copy_us);
+    print_row("blend (panel order)", blend_swapped_us, copy_us);
+    printf("%-22s %9s %10s %9s   (source pixels)\n", "2x upscale", "us/frame", "Mpixel/s", "vs NN");
+    print_row("nearest 2x", nn_us, nn_us);
+    print_row("nearest 2x (band)", nn_band_us, nn_us);
+    print_row("bilinear 2x", bilinear_us, nn_us);
+    print_row("bilinear 2x (panel)", bilinear_swapped_us, nn_us);
+    print_row("table 2x", table_us, nn_us);
+    print_row("table 150x100 fill", table_fill_us, nn_us);
+    if (mismatches) {
+        printf("%d pixels differ from the reference\n", mismatches);
+    }
+    free(a);
+    free(b);
+    free(out);
+    free(big);
+    free(nn_big);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,296 @@
+// Q565 vs tjpgd benchmark: decodes every manifest frame with esp_jpeg (the
+// player's configuration), re-encodes the pixels as Q565 and decodes that,
+// checking the round trip is bit-exact. Prints size and decode time per clip.
+// --write DIR also saves the Q565 corpus (DIR/output/*.q565, a manifest and
+// test.jpg), which plays through the player with the JPEG golden checksums.
+//
+// The corpus is JPEG, so Q565 here also has to carry the JPEG's ringing and
+// block noise; frames made from the source GIFs with convert.py --codec q565
+// compress better than this shows.
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <sys/stat.h>
+#include "esp_timer.h"
+#include "jpeg_decoder.h"
+#include "q565.h"
+
+#define BENCH_WORK_SIZE 65472
+#define BENCH_MAX_PATH 512
+#define BENCH_MAX_CLIPS 32
+
+typedef struct {
+    char name[32];
+    int frames;
+    size_t jpeg_bytes;
+    size_t q565_bytes;
+    int64_t jpeg_us;    // Best pass, summed over frames
+    int64_t q565_us;
+} clip_stats_t;
+
+// Reference encoder, mirrors encode_q565() in gif-converter/convert.py
+static size_t q565_encode(const uint16_t *pixels, uint16_t width, uint16_t height, uint8_t *out)
+{
+    uint8_t *o = out;
+    memcpy(o, Q565_MAGIC, 4);
+    o[4] = width & 0xFF;
+    o[5] = width >> 8;
+    o[6] = height & 0xFF;
+    o[7] = height >> 8;
+    o += Q565_HEADER_SIZE;
+
+    uint16_t cache[64] = { 0 };
+    uint16_t prev = 0;
+    int run = 0;
+    size_t total = (size_t)width * height;
+    for (size_t i = 0; i < total; i++) {
+        uint16_t px = pixels[i];
+        if (px == prev) {
+            run++;
+            if (run == Q565_RUN_MAX || i == total - 1) {
+                *o++ = Q565_OP_RUN | (run - 1);
+                run = 0;
+            }
+            continue;
+        }
+        if (run) {
+            *o++ = Q565_OP_RUN | (run - 1);
+            run = 0;
+        }
+        int h = Q565_HASH(px);
+        if (cache[h] == px) {
+            *o++ = Q565_OP_INDEX | h;
+        } else {
+            cache[h] = px;
+            int dr = (px >> 11) - (prev >> 11);
+            int dg = ((px >> 5) & 63) - ((prev >> 5) & 63);
+            int db = (px & 31) - (prev & 31);
+            int dg_half = ((dg + 64) >> 1) - 32;
+            int dr_dg = dr - dg_half, db_dg = db - dg_half;
+            if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                *o++ = Q565_OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2);
+            } else if (dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 && db_dg <= 7) {
+                *o++ = Q565_OP_LUMA | (dg + 32);
+                *o++ = (dr_dg + 8) << 4 | (db_dg + 8);
+            } else {
+                *o++ = Q565_OP_RGB;
+                *o++ = px >> 8;
+                *o++ = px & 0xFF;
+            }
+        }
+        prev = px;
+    }
+    return o - out;
+}
+
+static bool write_file(const char *path, const void *data, size_t size)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+    bool ok = fwrite(data, 1, size, f) == size;
+    return fclose(f) == 0 && ok;
+}
+
+static uint8_t *load_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = malloc(*size);
+    if (data && fread(data, 1, *size, f) != *size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+// Clip name: frame name up to the last '-' ("spongebob-012.jpg" -> "spongebob")
+static clip_stats_t *clip_for(clip_stats_t *clips, int *num_clips, const char *frame)
+{
+    char name[32];
+    const char *dash = strrchr(frame, '-');
+    snprintf(name, sizeof(name), "%.*s", dash ? (int)(dash - frame) : (int)strlen(frame), frame);
+    for (int i = 0; i < *num_clips; i++) {
+        if (strcmp(clips[i].name, name) == 0) {
+            return &clips[i];
+        }
+    }
+    if (*num_clips == BENCH_MAX_CLIPS) {
+        return &clips[BENCH_MAX_CLIPS - 1];
+    }
+    clip_stats_t *c = &clips[(*num_clips)++];
+    snprintf(c->name, sizeof(c->name), "%s", name);
+    return c;
+}
+
+static void print_row(const clip_stats_t *c)
+{
+    printf("%-14s %6d %9.1f %9.1f %7.2f %10.1f %10.1f %7.1fx\n", c->name, c->frames,
+           c->jpeg_bytes / 1024.0, c->q565_bytes / 1024.0,
+           c->jpeg_bytes ? (double)c->q565_bytes / c->jpeg_bytes : 0.0,
+           c->frames ? (double)c->jpeg_us / c->frames : 0.0, c->frames ? (double)c->q565_us / c->frames : 0.0,
+           c->q565_us ? (double)c->jpeg_us / c->q565_us : 0.0);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option long_opts[] = {
+        { "passes", required_argument, NULL, 'p' },
+        { "write",  required_argument, NULL, 'w' },
+        { "help",   no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    int passes = 3;
+    const char *write_dir = NULL;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "p:w:h", long_opts, NULL)) != -1) {
+        switch (opt) {
+        case 'p': passes = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+        case 'w': write_dir = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [--passes N] [--write DIR] [DATA_DIR]\n"
+                            "  Compares Q565 with tjpgd on DATA_DIR/output/manifest.txt (default " Q565_BENCH_DATA_DIR ")\n",
+                    argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+    const char *dir = optind < argc ? argv[optind] : Q565_BENCH_DATA_DIR;
+
+    char path[BENCH_MAX_PATH];
+    snprintf(path, sizeof(path), "%s/output/manifest.txt", dir);
+    FILE *mf = fopen(path, "r");
+    if (!mf) {
+        fprintf(stderr, "❌ Cannot open %s\n", path);
+        return 1;
+    }
+
+    FILE *out_manifest = NULL;
+    if (write_dir) {
+        mkdir(write_dir, 0755);
+        snprintf(path, sizeof(path), "%s/output", write_dir);
+        mkdir(path, 0755);
+        snprintf(path, sizeof(path), "%s/output/manifest.txt", write_dir);
+        out_manifest = fopen(path, "w");
+        size_t boot_size = 0;
+        snprintf(path, sizeof(path), "%s/test.jpg", dir);
+        uint8_t *boot = load_file(path, &boot_size);
+        snprintf(path, sizeof(path), "%s/test.jpg", write_dir);
+        if (!out_manifest || !boot || !write_file(path, boot, boot_size)) {
+            fprintf(stderr, "❌ Cannot write the Q565 corpus to %s\n", write_dir);
+            return 1;
+        }
+        free(boot);
+    }
+
+    uint8_t *work = malloc(BENCH_WORK_SIZE);
+    clip_stats_t clips[BENCH_MAX_CLIPS] = { 0 };
+    int num_clips = 0;
+    int mismatches = 0, skipped = 0;
+    char line[256], fname[128];
+    while (fgets(line, sizeof(line), mf)) {
+        if (sscanf(line, "%127s", fname) != 1) {
+            continue;
+        }
+        size_t size = 0;
+        snprintf(path, sizeof(path), "%s/output/%s", dir, fname);
+        uint8_t *data = load_file(path, &size);
+        esp_jpeg_image_cfg_t cfg = {
+            .indata = data,
+            .indata_size = size,
+            .out_format = JPEG_IMAGE_FORMAT_RGB565,
+            .out_scale = JPEG_IMAGE_SCALE_0,
+            .advanced = { .working_buffer = work, .working_buffer_size = BENCH_WORK_SIZE },
+        };
+        esp_jpeg_image_output_t info;
+        if (!data || q565_is_frame(data, size) || esp_jpeg_get_image_info(&cfg, &info) != ESP_OK) {
+            skipped++;
+            free(data);
+            continue;
+        }
+
+        size_t pixels = (size_t)info.width * info.height;
+        uint16_t *ref = malloc(pixels * 2);
+        uint16_t *out = malloc(pixels * 2);
+        uint8_t *q = malloc(Q565_HEADER_SIZE + pixels * 3);   // Worst case: every pixel a literal
+        cfg.outbuf = (uint8_t *)ref;
+        cfg.outbuf_size = pixels * 2;
+
+        int64_t jpeg_best = INT64_MAX, q565_best = INT64_MAX;
+        bool ok = true;
+        for (int p = 0; p < passes && ok; p++) {
+            int64_t start = esp_timer_get_time();
+            ok = esp_jpeg_decode(&cfg, &info) == ESP_OK;
+            int64_t elapsed = esp_timer_get_time() - start;
+            jpeg_best = elapsed < jpeg_best ? elapsed : jpeg_best;
+        }
+        size_t q_size = ok ? q565_encode(ref, info.width, info.height, q) : 0;
+        for (int p = 0; p < passes && ok; p++) {
+            int64_t start = esp_timer_get_time();
+            ok = q565_decode(q, q_size, out, pixels, false) == ESP_OK;
+            int64_t elapsed = esp_timer_get_time() - start;
+            q565_best = elapsed < q565_best ? elapsed : q565_best;
+        }
+        if (!ok || memcmp(ref, out, pixels * 2) != 0) {
+            fprintf(stderr, "❌ %s: Q565 round trip is not bit-exact\n", fname);
+            mismatches++;
+        } else {
+            if (out_manifest) {
+                // Same name with the .q565 extension
+                char qname[160];
+                const char *dot = strrchr(fname, '.');
+                snprintf(qname, sizeof(qname), "%.*s.q565", dot ? (int)(dot - fname) : (int)strlen(fname), fname);
+                snprintf(path, sizeof(path), "%s/output/%s", write_dir, qname);
+                if (!write_file(path, q, q_size)) {
+                    fprintf(stderr, "❌ Cannot write %s\n", path);
+                    mismatches++;
+                }
+                fprintf(out_manifest, "%s %zu\n", qname, q_size);
+            }
+            clip_stats_t *c = clip_for(clips, &num_clips, fname);
+            c->frames++;
+            c->jpeg_bytes += size;
+            c->q565_bytes += q_size;
+            c->jpeg_us += jpeg_best;
+            c->q565_us += q565_best;
+        }
+        free(ref);
+        free(out);
+        free(q);
+        free(data);
+    }
+    fclose(mf);
+    free(work);
+    if (out_manifest) {
+        fclose(out_manifest);
+    }
+
+    clip_stats_t total = { .name = "total" };
+    printf("%-14s %6s %9s %9s %7s %10s %10s %8s\n", "clip", "frames", "jpeg KB", "q565 KB", "ratio",
+           "tjpgd us", "q565 us", "speedup");
+    for (int i = 0; i < num_clips; i++) {
+        print_row(&clips[i]);
+        total.frames += clips[i].frames;
+        total.jpeg_bytes += clips[i].jpeg_bytes;
+        total.q565_bytes += clips[i].q565_bytes;
+        total.jpeg_us += clips[i].jpeg_us;
+        total.q565_us += clips[i].q565_us;
+    }
+    print_row(&total);
+    if (skipped) {
+        printf("%d frames skipped (unreadable or not JPEG)\n", skipped);
+    }
+    if (mismatches) {
+        printf("%d frames failed the round trip\n", mismatches);
+    }
+    return (mismatches == 0 && total.frames > 0) ? 0 : 1;
+}
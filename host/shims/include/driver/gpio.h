@@ -0,0 +1,6 @@
+#pragma once
+// Host shim: GPIO numbers only
+
+typedef int gpio_num_t;
+
+#define GPIO_NUM_NC -1
@@ -0,0 +1,7 @@
+#pragma once
+// Host shim: SPI host ids only
+
+typedef int spi_host_device_t;
+
+#define SPI2_HOST 1
+#define SPI3_HOST 2
@@ -0,0 +1,7 @@
+#pragma once
+// Host shim: memory placement attributes are no-ops
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define EXT_RAM_BSS_ATTR
+#define WORD_ALIGNED_ATTR __attribute__((aligned(4)))
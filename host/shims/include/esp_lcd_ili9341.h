@@ -0,0 +1,3 @@
+#pragma once
+// Host shim: the ILI9341 is replaced by mock_panel.c
+#include "esp_lcd_panel_vendor.h"
@@ -0,0 +1,3 @@
+#pragma once
+// Host shim: see esp_lcd_types.h
+#include "esp_lcd_types.h"
@@ -0,0 +1,5 @@
+#pragma once
+// Host shim: esp_lcd handle types
+
+typedef struct esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;
@@ -0,0 +1,2 @@
+#pragma once
+// Host shim: no ROM on the host
@@ -0,0 +1,6 @@
+#pragma once
+// Host shim: standard (zlib-compatible) CRC-32
+
+#include <stdint.h>
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len);
@@ -0,0 +1,3 @@
+#pragma once
+// Host shim: nothing needed from esp_system.h
+#include "esp_err.h"
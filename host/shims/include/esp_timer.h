@@ -0,0 +1,31 @@
+#pragma once
+// Host shim: microsecond clock (see esp_shims.c)
+
+#include <stdbool.h>
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
+
+// Host-only: move the clock forward without sleeping (used by vTaskDelay).
+// Events of the registered event source that fall due on the way are fired.
+void host_clock_advance_us(int64_t us);
+
+// Host-only: make CPU time count 'scale' times (rough model of a slower CPU)
+void host_clock_set_cpu_scale(double scale);
+
+// Host-only: simulated hardware that completes work at a given time (mock panel IO).
+// Events fire in time order, with esp_timer_get_time() returning the event time.
+typedef struct {
+    int64_t (*next_event_us)(void *ctx);  // Time of the earliest pending event, INT64_MAX if none
+    void (*run_event)(void *ctx);         // Fire the earliest pending event
+    void *ctx;
+} host_event_source_t;
+
+void host_clock_set_event_source(const host_event_source_t *source);
+
+// Fire every event that is already due
+void host_clock_run_due_events(void);
+
+// Block until the next event (advancing the clock) and fire it. Returns false,
+// with the clock at 'deadline_us', if no event falls due before then.
+bool host_clock_wait_event(int64_t deadline_us);
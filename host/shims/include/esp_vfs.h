@@ -0,0 +1,2 @@
+#pragma once
+// Host shim: the host uses the real filesystem
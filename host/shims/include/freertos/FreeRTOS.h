@@ -0,0 +1,22 @@
+#pragma once
+// Host shim: FreeRTOS types and constants (1 kHz tick)
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include "esp_heap_caps.h" // portmacro.h pulls this in on the device
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE                 0
+#define pdTRUE                  1
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+#define configTICK_RATE_HZ      1000
+#define portTICK_PERIOD_MS      (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY           ((TickType_t)0xffffffffUL)
+#define portNUM_PROCESSORS      1
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((TickType_t)(ms) * configTICK_RATE_HZ) / 1000))
@@ -0,0 +1,11 @@
+#pragma once
+// Host shim: single task; vTaskDelay advances the host clock
+
+#include "freertos/FreeRTOS.h"
+
+typedef void *TaskHandle_t;
+
+void vTaskDelay(TickType_t ticks);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+TickType_t xTaskGetTickCount(void);
+BaseType_t xPortGetCoreID(void);
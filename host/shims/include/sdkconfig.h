@@ -0,0 +1,49 @@
+#pragma once
+// Host shim: the subset of the firmware sdkconfig the shared sources read.
+// Every value can be overridden from the compiler command line (-DCONFIG_...).
+
+#ifndef CONFIG_ESP_CONSOLE_UART_NUM
+#define CONFIG_ESP_CONSOLE_UART_NUM 0
+#endif
+#ifndef CONFIG_HEAP_USE_HOOKS
+#define CONFIG_HEAP_USE_HOOKS 1
+#endif
+#ifndef CONFIG_JD_SZBUF
+#define CONFIG_JD_SZBUF 512
+#endif
+#ifndef CONFIG_JD_FORMAT
+#define CONFIG_JD_FORMAT 0
+#endif
+#ifndef CONFIG_JD_USE_SCALE
+#define CONFIG_JD_USE_SCALE 1
+#endif
+#ifndef CONFIG_JD_TBLCLIP
+#define CONFIG_JD_TBLCLIP 1
+#endif
+#ifndef CONFIG_JD_MONO_LUMA
+#define CONFIG_JD_MONO_LUMA 1
+#endif
+#ifndef CONFIG_JD_MCU_GENERIC
+#define CONFIG_JD_MCU_GENERIC 0
+#endif
+#ifndef CONFIG_JD_FASTDECODE
+#define CONFIG_JD_FASTDECODE 2
+#endif
+#ifndef CONFIG_JD_PROFILE
+#define CONFIG_JD_PROFILE 1
+#endif
+#ifndef CONFIG_JD_TRACE
+#define CONFIG_JD_TRACE 1
+#endif
+#ifndef CONFIG_T4_SPAN_TRACE
+#define CONFIG_T4_SPAN_TRACE 1
+#endif
+#ifndef CONFIG_T4_SPAN_TRACE_RING_LEN
+#define CONFIG_T4_SPAN_TRACE_RING_LEN 131072 // Whole host runs fit; the device default is 1024
+#endif
+#ifndef CONFIG_T4_KNOB_SCRUB
+#define CONFIG_T4_KNOB_SCRUB 0
+#endif
+#ifndef CONFIG_T4_TEMPORAL_BLEND
+#define CONFIG_T4_TEMPORAL_BLEND 0
+#endif
@@ -0,0 +1,381 @@
+// Host implementations of the ESP-IDF APIs used by the player and esp_jpeg
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_crc.h"
+#include "esp_spiffs.h"
+#include "esp_littlefs.h"
+#include "esp_partition.h"
+#include "driver/uart.h"
+
+/* ---- esp_err ---------------------------------------------------------- */
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:                return "ESP_OK";
+    case ESP_FAIL:              return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_CRC:   return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_INVALID_VERSION: return "ESP_ERR_INVALID_VERSION";
+    default:                    return "UNKNOWN ERROR";
+    }
+}
+
+/* ---- esp_log ---------------------------------------------------------- */
+
+static esp_log_level_t s_log_level = ESP_LOG_INFO;
+
+void host_log_set_level(esp_log_level_t level)
+{
+    s_log_level = level;
+}
+
+void host_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    static const char letters[] = "NEWIDV";
+    if (level > s_log_level) {
+        return;
+    }
+    fprintf(stderr, "%c (%lld) %s: ", letters[level], (long long)(esp_timer_get_time() / 1000), tag);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+/* ---- esp_timer -------------------------------------------------------- */
+
+// Real monotonic time (optionally scaled) plus the time the player "slept"
+// (vTaskDelay does not block on the host)
+static int64_t s_clock_offset_us = 0;
+static double s_cpu_scale = 1.0;
+static int64_t s_frozen_us = -1;  // >= 0 while an event callback runs
+static host_event_source_t s_event_source;
+
+static int64_t real_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)(((int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000) * s_cpu_scale);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    if (s_frozen_us >= 0) {
+        return s_frozen_us;
+    }
+    return real_time_us() + s_clock_offset_us;
+}
+
+void host_clock_set_cpu_scale(double scale)
+{
+    int64_t now = esp_timer_get_time();
+    s_cpu_scale = scale > 0 ? scale : 1.0;
+    s_clock_offset_us = now - real_time_us();
+}
+
+void host_clock_set_event_source(const host_event_source_t *source)
+{
+    if (source) {
+        s_event_source = *source;
+    } else {
+        memset(&s_event_source, 0, sizeof(s_event_source));
+    }
+}
+
+static int64_t next_event_us(void)
+{
+    return s_event_source.next_event_us ? s_event_source.next_event_us(s_event_source.ctx) : INT64_MAX;
+}
+
+// Fire the earliest event with the clock reading its completion time
+static void fire_next_event(int64_t at_us)
+{
+    s_frozen_us = at_us;
+    s_event_source.run_event(s_event_source.ctx);
+    s_frozen_us = -1;
+}
+
+void host_clock_run_due_events(void)
+{
+    int64_t next;
+    while ((next = next_event_us()) <= esp_timer_get_time()) {
+        fire_next_event(next);
+    }
+}
+
+bool host_clock_wait_event(int64_t deadline_us)
+{
+    int64_t now = esp_timer_get_time();
+    int64_t next = next_event_us();
+    if (next > deadline_us) {
+        if (deadline_us != INT64_MAX && deadline_us > now) {
+            s_clock_offset_us += deadline_us - now;
+        }
+        return false;
+    }
+    if (next > now) {
+        s_clock_offset_us += next - now;
+    }
+    fire_next_event(next);
+    return true;
+}
+
+void host_clock_advance_us(int64_t us)
+{
+    if (us <= 0) {
+        return;
+    }
+    int64_t target = esp_timer_get_time() + us;
+    while (host_clock_wait_event(target)) {
+    }
+}
+
+/* ---- heap_caps -------------------------------------------------------- */
+
+__attribute__((weak)) void esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps)
+{
+}
+
+__attribute__((weak)) void esp_heap_trace_free_hook(void *ptr)
+{
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    void *p = malloc(size);
+    esp_heap_trace_alloc_hook(p, size, caps);
+    return p;
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    void *p = calloc(n, size);
+    esp_heap_trace_alloc_hook(p, n * size, caps);
+    return p;
+}
+
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps)
+{
+    void *p = realloc(ptr, size);
+    esp_heap_trace_alloc_hook(p, size, caps);
+    return p;
+}
+
+void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps)
+{
+    // aligned_alloc wants a size that is a multiple of the alignment
+    void *p = aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    esp_heap_trace_alloc_hook(p, size, caps);
+    return p;
+}
+
+void heap_caps_free(void *ptr)
+{
+    esp_heap_trace_free_hook(ptr);
+    free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    return (caps & MALLOC_CAP_SPIRAM) ? 4 * 1024 * 1024 : 256 * 1024;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return heap_caps_get_free_size(caps);
+}
+
+/* ---- esp_rom_crc ------------------------------------------------------ */
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+/* ---- SPIFFS ----------------------------------------------------------- */
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t *conf)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_spiffs_info(const char *partition_label, size_t *total_bytes, size_t *used_bytes)
+{
+    // The data directory stands in for the partition; report a nominal size
+    *total_bytes = 0x300000;
+    *used_bytes = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_vfs_littlefs_register(const esp_vfs_littlefs_conf_t *conf)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_littlefs_info(const char *partition_label, size_t *total_bytes, size_t *used_bytes)
+{
+    *total_bytes = 0x300000;
+    *used_bytes = 0;
+    return ESP_OK;
+}
+
+/* ---- esp_partition ---------------------------------------------------- */
+
+// One file-backed partition (host_partition_set_file)
+static esp_partition_t s_partition;
+static FILE *s_partition_file = NULL;
+
+esp_err_t host_partition_set_file(const char *label, const char *path)
+{
+    if (s_partition_file) {
+        fclose(s_partition_file);
+    }
+    s_partition_file = fopen(path, "rb");
+    if (!s_partition_file) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    fseek(s_partition_file, 0, SEEK_END);
+    s_partition = (esp_partition_t){
+        .type = ESP_PARTITION_TYPE_DATA,
+        .address = 0x90000,
+        .size = (uint32_t)ftell(s_partition_file),
+    };
+    snprintf(s_partition.label, sizeof(s_partition.label), "%s", label);
+    return ESP_OK;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label)
+{
+    if (!s_partition_file || (label && strcmp(label, s_partition.label) != 0)) {
+        return NULL;
+    }
+    return &s_partition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+    if (partition != &s_partition || src_offset + size > partition->size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    fseek(s_partition_file, (long)src_offset, SEEK_SET);
+    return fread(dst, 1, size, s_partition_file) == size ? ESP_OK : ESP_FAIL;
+}
+
+// Mapped ranges are heap copies; the handle is a slot in this table
+#define HOST_PARTITION_MAPS 4
+static void *s_partition_maps[HOST_PARTITION_MAPS];
+
+esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void **out_ptr,
+                             esp_partition_mmap_handle_t *out_handle)
+{
+    if (offset % 0x10000 != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint32_t i = 0; i < HOST_PARTITION_MAPS; i++) {
+        if (s_partition_maps[i]) {
+            continue;
+        }
+        void *copy = malloc(size);
+        if (!copy) {
+            return ESP_ERR_NO_MEM;
+        }
+        esp_err_t ret = esp_partition_read(partition, offset, copy, size);
+        if (ret != ESP_OK) {
+            free(copy);
+            return ret;
+        }
+        s_partition_maps[i] = copy;
+        *out_ptr = copy;
+        *out_handle = i;
+        return ESP_OK;
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle)
+{
+    if (handle < HOST_PARTITION_MAPS) {
+        free(s_partition_maps[handle]);
+        s_partition_maps[handle] = NULL;
+    }
+}
+
+/* ---- UART ------------------------------------------------------------- */
+
+static FILE *s_uart_out = NULL;
+static uint8_t s_uart_rx[256];
+static size_t s_uart_rx_len = 0;
+static size_t s_uart_rx_pos = 0;
+
+void host_uart_set_output(FILE *out)
+{
+    s_uart_out = out;
+}
+
+void host_uart_inject_rx(const void *data, size_t len)
+{
+    if (len > sizeof(s_uart_rx)) {
+        len = sizeof(s_uart_rx);
+    }
+    memcpy(s_uart_rx, data, len);
+    s_uart_rx_len = len;
+    s_uart_rx_pos = 0;
+}
+
+esp_err_t uart_driver_install(uart_port_t uart_num, int rx_buffer_size, int tx_buffer_size,
+                              int queue_size, void *uart_queue, int intr_alloc_flags)
+{
+    return ESP_OK;
+}
+
+int uart_read_bytes(uart_port_t uart_num, void *buf, uint32_t length, TickType_t ticks_to_wait)
+{
+    size_t n = s_uart_rx_len - s_uart_rx_pos;
+    if (n > length) {
+        n = length;
+    }
+    memcpy(buf, s_uart_rx + s_uart_rx_pos, n);
+    s_uart_rx_pos += n;
+    return (int)n;
+}
+
+int uart_write_bytes(uart_port_t uart_num, const void *src, size_t size)
+{
+    if (s_uart_out) {
+        fwrite(src, 1, size, s_uart_out);
+    }
+    return (int)size;
+}
+
+esp_err_t uart_wait_tx_done(uart_port_t uart_num, TickType_t ticks_to_wait)
+{
+    if (s_uart_out) {
+        fflush(s_uart_out);
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,236 @@
+// Encoder tests: recorded edge sequences (host/encoder/*.edges) go through the
+// glitch filter and PCNT models, the device's event queue (main/encoder_core.h)
+// and the speed control (main/speed_control.c), and the queue is hammered from
+// two threads to check it never loses or reorders an event that fits.
+//
+//   test_encoder FILE.edges...   check each file against its "# expect" lines:
+//     # expect cw=N ccw=M                      detents seen in each direction
+//     # expect speed FROM->TO [within_us=T]    frame delay starting at FROM ends at
+//                                              TO, first reached T µs after the first detent
+//     # expect clip N                          net clip switches wiggled (+1 next, -1 previous),
+//                                              with or without scrub mode
+//     # expect scrub N                         net frames the playhead moves in scrub mode
+//   test_encoder --stress        producer/consumer threads on one queue
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "host_encoder.h"
+#include "speed_control.h"
+
+// The player polls the queue once per frame
+#define POLL_INTERVAL_US 33000
+
+typedef struct {
+    int want_cw, want_ccw;
+    int speed_from, speed_to;   // -1 = no speed expectation
+    int64_t speed_within_us;    // 0 = no time limit
+    int clip_steps;             // Net clip switches, checked when has_clip
+    bool has_clip;
+    int scrub_frames;           // Checked when has_scrub
+    bool has_scrub;
+} edge_expect_t;
+
+typedef struct {
+    int cw, ccw;
+    int64_t last_ts, first_ts;
+    speed_control_t speed;
+    uint32_t delay_ms;
+    int64_t reached_us;         // First time delay_ms hit speed_to, -1 = never
+    speed_control_t scrub;      // The same detents as CONFIG_T4_KNOB_SCRUB sees them
+    int scrub_frames;
+} edge_result_t;
+
+// What the player does once per frame: take every pending event, oldest first
+static int drain(const char *path, encoder_queue_t *queue, int64_t now, const edge_expect_t *want, edge_result_t *res)
+{
+    encoder_event_t ev;
+    int failures = 0;
+    while (encoder_queue_pop(queue, &ev)) {
+        if ((int64_t)ev.ts_us < res->last_ts || (int64_t)ev.ts_us > now) {
+            fprintf(stderr, "❌ %s: event at %u µs out of order\n", path, (unsigned)ev.ts_us);
+            failures++;
+        }
+        if (res->cw + res->ccw == 0) {
+            res->first_ts = ev.ts_us;
+        }
+        res->last_ts = ev.ts_us;
+        if (ev.dir > 0) {
+            res->cw++;
+        } else {
+            res->ccw++;
+        }
+        res->delay_ms = speed_control_step(&res->speed, res->delay_ms, &ev);
+        res->scrub_frames += speed_control_scrub_step(&res->scrub, &ev);
+        if (res->reached_us < 0 && (int)res->delay_ms == want->speed_to) {
+            res->reached_us = ev.ts_us - res->first_ts;
+        }
+    }
+    return failures;
+}
+
+static bool parse_expect(const char *path, edge_expect_t *want)
+{
+    *want = (edge_expect_t){ .want_cw = -1, .speed_from = -1, .speed_to = -1 };
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    char line[128];
+    long long within;
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "# expect cw=%d ccw=%d", &want->want_cw, &want->want_ccw) == 2) {
+            continue;
+        }
+        if (sscanf(line, "# expect clip %d", &want->clip_steps) == 1) {
+            want->has_clip = true;
+            continue;
+        }
+        if (sscanf(line, "# expect scrub %d", &want->scrub_frames) == 1) {
+            want->has_scrub = true;
+            continue;
+        }
+        int n = sscanf(line, "# expect speed %d->%d within_us=%lld", &want->speed_from, &want->speed_to, &within);
+        if (n == 3) {
+            want->speed_within_us = within;
+        }
+    }
+    fclose(f);
+    return want->want_cw >= 0;
+}
+
+static int check_file(const char *path)
+{
+    edge_expect_t want;
+    encoder_edge_t *edges;
+    size_t count;
+    if (!parse_expect(path, &want) || encoder_edges_load(path, &edges, &count) != 0) {
+        fprintf(stderr, "❌ %s: unreadable or no '# expect cw=N ccw=M' line\n", path);
+        return 1;
+    }
+    size_t raw = count;
+    count = encoder_edges_filter_glitches(edges, count, ENCODER_GLITCH_NS / 1000);
+
+    quadrature_decoder_t dec;
+    encoder_queue_t queue = { 0 };
+    quadrature_init(&dec, QUADRATURE_REST_A, QUADRATURE_REST_B);
+    edge_result_t res = { .delay_ms = want.speed_from > 0 ? want.speed_from : 100, .reached_us = -1 };
+    int failures = 0;
+    int64_t next_poll = POLL_INTERVAL_US;
+    for (size_t i = 0; i < count; i++) {
+        while (edges[i].ts_us >= next_poll) {
+            failures += drain(path, &queue, next_poll, &want, &res);
+            next_poll += POLL_INTERVAL_US;
+        }
+        int dir = quadrature_feed(&dec, edges[i].a, edges[i].b);
+        if (dir) {
+            encoder_event_t ev = { .ts_us = (uint32_t)edges[i].ts_us, .dir = (int8_t)dir };
+            encoder_queue_push(&queue, ev);
+        }
+    }
+    failures += drain(path, &queue, INT64_MAX, &want, &res);
+    free(edges);
+
+    if (res.cw != want.want_cw || res.ccw != want.want_ccw || queue.dropped) {
+        fprintf(stderr, "❌ %s: cw=%d ccw=%d dropped=%u, expected cw=%d ccw=%d\n",
+                path, res.cw, res.ccw, (unsigned)queue.dropped, want.want_cw, want.want_ccw);
+        failures++;
+    }
+    if (want.speed_to >= 0 && (int)res.delay_ms != want.speed_to) {
+        fprintf(stderr, "❌ %s: frame delay %d -> %u ms, expected %d ms\n",
+                path, want.speed_from, (unsigned)res.delay_ms, want.speed_to);
+        failures++;
+    }
+    if (res.speed.clip_steps != (want.has_clip ? want.clip_steps : 0)) {
+        fprintf(stderr, "❌ %s: %d clip switches, expected %d\n", path, res.speed.clip_steps, want.clip_steps);
+        failures++;
+    }
+    if (res.scrub.clip_steps != res.speed.clip_steps) {
+        fprintf(stderr, "❌ %s: %d clip switches in scrub mode, %d without\n", path, res.scrub.clip_steps,
+                res.speed.clip_steps);
+        failures++;
+    }
+    if (want.has_scrub && res.scrub_frames != want.scrub_frames) {
+        fprintf(stderr, "❌ %s: scrubbed %d frames, expected %d\n", path, res.scrub_frames, want.scrub_frames);
+        failures++;
+    }
+    if (want.speed_within_us && (res.reached_us < 0 || res.reached_us > want.speed_within_us)) {
+        fprintf(stderr, "❌ %s: frame delay took %lld µs to reach %d ms, limit %lld µs\n",
+                path, (long long)res.reached_us, want.speed_to, (long long)want.speed_within_us);
+        failures++;
+    }
+    if (!failures) {
+        printf("✅ %s: cw=%d ccw=%d from %zu edges (%zu glitch edges filtered)", path, res.cw, res.ccw, count, raw - count);
+        if (want.speed_to >= 0) {
+            printf(", delay %d -> %u ms in %lld µs", want.speed_from, (unsigned)res.delay_ms, (long long)res.reached_us);
+        }
+        if (res.speed.clip_steps) {
+            printf(", clip %+d", res.speed.clip_steps);
+        }
+        if (want.has_scrub) {
+            printf(", scrub %+d frames", res.scrub_frames);
+        }
+        printf("\n");
+    }
+    return failures;
+}
+
+#define STRESS_EVENTS 200000
+
+static void *stress_producer(void *arg)
+{
+    encoder_queue_t *queue = arg;
+    for (uint32_t i = 0; i < STRESS_EVENTS; ) {
+        encoder_event_t ev = { .ts_us = i, .dir = (i & 1) ? 1 : -1 };
+        if (encoder_queue_push(queue, ev)) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static int stress(void)
+{
+    static encoder_queue_t queue;
+    pthread_t producer;
+    pthread_create(&producer, NULL, stress_producer, &queue);
+
+    uint32_t expected = 0;
+    int failures = 0;
+    encoder_event_t ev;
+    while (expected < STRESS_EVENTS) {
+        if (!encoder_queue_pop(&queue, &ev)) {
+            sched_yield();
+            continue;
+        }
+        if (ev.ts_us != expected || ev.dir != ((expected & 1) ? 1 : -1)) {
+            if (failures++ < 10) {
+                fprintf(stderr, "❌ stress: got event %u, expected %u\n", (unsigned)ev.ts_us, (unsigned)expected);
+            }
+        }
+        expected++;
+    }
+    pthread_join(producer, NULL);
+    if (!failures) {
+        printf("✅ stress: %u events in order across threads (%u full-queue retries)\n",
+               (unsigned)STRESS_EVENTS, (unsigned)queue.dropped);
+    }
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s FILE.edges... | --stress\n", argv[0]);
+        return 2;
+    }
+    int failures = 0;
+    for (int i = 1; i < argc; i++) {
+        failures += strcmp(argv[i], "--stress") == 0 ? stress() : check_file(argv[i]);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,153 @@
+#include "decode_bench.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "jpeg_decoder.h"
+#include "q565.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+
+static const char *TAG = "DECODE_BENCH";
+
+#define BENCH_BULK_POOL_SIZE 65472          // Same as the player's JPEG_WORK_BUFFER_SIZE_ALLOC
+#define BENCH_FAST_POOL_SIZE JPEG_FAST_WORK_BUFFER_SIZE
+
+typedef struct {
+    const char *name;
+    bool use_fast_pool;
+} bench_placement_t;
+
+static const bench_placement_t s_placements[] = {
+    { "all-in-one PSRAM",        false },
+    { "split DRAM fast + PSRAM", true  },
+};
+
+typedef struct {
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint64_t load_us;   // Entropy decode + IDCT (CONFIG_JD_PROFILE only)
+    uint32_t decoded;
+    uint32_t failed;
+} bench_result_t;
+
+static void bench_placement(const bench_placement_t *pl, const preloaded_jpeg_frame_t *frames, int num_frames,
+                            int passes, uint8_t *outbuf, size_t outbuf_size,
+                            uint8_t *bulk_pool, uint8_t *fast_pool, bench_result_t *res)
+{
+    *res = (bench_result_t) { .min_us = UINT32_MAX };
+
+    for (int p = 0; p < passes; p++) {
+        for (int i = 0; i < num_frames; i++) {
+            // Work-pool placement only matters to tjpgd
+            if (q565_is_frame(frames[i].data, frames[i].size)) {
+                continue;
+            }
+            esp_jpeg_image_cfg_t cfg = {
+                .indata = frames[i].data,
+                .indata_size = frames[i].size,
+                .outbuf = outbuf,
+                .outbuf_size = outbuf_size,
+                .out_format = JPEG_IMAGE_FORMAT_RGB565,
+                .out_scale = JPEG_IMAGE_SCALE_0,
+                .flags = { .swap_color_bytes = 1 },
+                .advanced = {
+                    .working_buffer = bulk_pool,
+                    .working_buffer_size = BENCH_BULK_POOL_SIZE,
+                    .fast_working_buffer = pl->use_fast_pool ? fast_pool : NULL,
+                    .fast_working_buffer_size = pl->use_fast_pool ? BENCH_FAST_POOL_SIZE : 0,
+                },
+            };
+            esp_jpeg_image_output_t info;
+            int64_t start = esp_timer_get_time();
+            esp_err_t ret = esp_jpeg_decode(&cfg, &info);
+            uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+
+            if (ret != ESP_OK) {
+                res->failed++;
+                continue;
+            }
+            res->decoded++;
+            res->total_us += elapsed;
+            res->load_us += info.timing.mcu_load_us;
+            if (elapsed < res->min_us) res->min_us = elapsed;
+            if (elapsed > res->max_us) res->max_us = elapsed;
+
+            // Yield now and then so the idle task still runs
+            if (i % 10 == 9) {
+                vTaskDelay(1);
+            }
+        }
+    }
+}
+
+esp_err_t decode_bench_run(const preloaded_jpeg_frame_t *frames, int num_frames, int passes)
+{
+    if (frames == NULL || num_frames <= 0 || passes <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Largest native output across the sequence
+    size_t outbuf_size = 0;
+    for (int i = 0; i < num_frames; i++) {
+        esp_jpeg_image_cfg_t info_cfg = {
+            .indata = frames[i].data,
+            .indata_size = frames[i].size,
+            .out_format = JPEG_IMAGE_FORMAT_RGB565,
+        };
+        esp_jpeg_image_output_t info;
+        if (esp_jpeg_get_image_info(&info_cfg, &info) == ESP_OK && info.output_len > outbuf_size) {
+            outbuf_size = info.output_len;
+        }
+    }
+    if (outbuf_size == 0) {
+        ESP_LOGE(TAG, "❌ No decodable frames");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+    uint8_t *outbuf = heap_caps_malloc(outbuf_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    uint8_t *bulk_pool = heap_caps_malloc(BENCH_BULK_POOL_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    uint8_t *fast_pool = heap_caps_malloc(BENCH_FAST_POOL_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!outbuf || !bulk_pool || !fast_pool) {
+        ESP_LOGE(TAG, "❌ Failed to allocate benchmark buffers");
+        ret = ESP_ERR_NO_MEM;
+        goto cleanup;
+    }
+
+    ESP_LOGI(TAG, "⏱️ Decoding %d frames x %d passes per placement (fast pool %d B DRAM, bulk pool %d B PSRAM)",
+             num_frames, passes, BENCH_FAST_POOL_SIZE, BENCH_BULK_POOL_SIZE);
+    // Code placement is a build-time choice: run once per configuration and compare the logs
+#if CONFIG_JD_PLACE_HOT_IN_IRAM
+    ESP_LOGI(TAG, "🔥 Code placement: decoder hot path in IRAM/DRAM (CONFIG_JD_PLACE_HOT_IN_IRAM)");
+#else
+    ESP_LOGI(TAG, "🔥 Code placement: decoder hot path in flash (default)");
+#endif
+
+    uint64_t baseline_avg = 0;
+    for (size_t p = 0; p < sizeof(s_placements) / sizeof(s_placements[0]); p++) {
+        bench_result_t res;
+        bench_placement(&s_placements[p], frames, num_frames, passes, outbuf, outbuf_size, bulk_pool, fast_pool, &res);
+        if (res.decoded == 0) {
+            ESP_LOGE(TAG, "❌ %s: every decode failed", s_placements[p].name);
+            ret = ESP_FAIL;
+            continue;
+        }
+        uint64_t avg = res.total_us / res.decoded;
+        if (p == 0) {
+            baseline_avg = avg;
+        }
+        ESP_LOGI(TAG, "📊 %-24s min=%lu us avg=%lu us max=%lu us load avg=%lu us failed=%lu  (%+ld%% vs all-in-one)",
+                 s_placements[p].name, (unsigned long)res.min_us, (unsigned long)avg, (unsigned long)res.max_us,
+                 (unsigned long)(res.load_us / res.decoded), (unsigned long)res.failed,
+                 baseline_avg ? (long)(((int64_t)avg - (int64_t)baseline_avg) * 100 / (int64_t)baseline_avg) : 0L);
+    }
+
+cleanup:
+    heap_caps_free(outbuf);
+    heap_caps_free(bulk_pool);
+    heap_caps_free(fast_pool);
+    return ret;
+}
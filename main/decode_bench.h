@@ -0,0 +1,9 @@
+#pragma once
+
+#include "esp_err.h"
+#include "image_display.h" // For preloaded_jpeg_frame_t
+
+// Decode every preloaded frame 'passes' times with each tjpgd work-pool placement
+// (all-in-one PSRAM pool vs. fast internal-DRAM pool + PSRAM bulk pool) and log
+// min/avg/max decode time per frame. Nothing is drawn.
+esp_err_t decode_bench_run(const preloaded_jpeg_frame_t *frames, int num_frames, int passes);
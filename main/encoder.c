@@ -1,14 +1,30 @@
 #include "encoder.h"
-#include "driver/pcnt.h"
+#include "driver/pulse_cnt.h"
 #include "driver/gpio.h"
+#include "esp_attr.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 
+static const char *TAG = "ENC";
+
 #define ENC_A_GPIO 22  // SCL pin on 5-pin JST
 #define ENC_B_GPIO 21  // SDA pin on 5-pin JST
-#define PCNT_UNIT_USED PCNT_UNIT_0
 
-void encoder_init(void)
+static encoder_queue_t s_queue;
+
+// Watch points sit on the count limits, so this fires once per detent and the
+// hardware has already wrapped the counter back to 0
+static bool IRAM_ATTR encoder_on_reach(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *user_ctx)
+{
+    encoder_event_t ev = {
+        .ts_us = (uint32_t)esp_timer_get_time(),
+        .dir = edata->watch_point_value > 0 ? 1 : -1,
+    };
+    encoder_queue_push(&s_queue, ev);
+    return false;
+}
+
+esp_err_t encoder_init(void)
 {
     // Ensure lines are inputs with internal pull-ups (in case external board pull-ups are weak)
     gpio_config_t io = {
@@ -18,59 +34,56 @@ void encoder_init(void)
         .pull_down_en = GPIO_PULLDOWN_DISABLE,
         .intr_type = GPIO_INTR_DISABLE
     };
-    gpio_config(&io);
+    esp_err_t ret = gpio_config(&io);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "❌ Encoder GPIO config failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
 
-    // Simple encoder config: count A pulses, use B for direction
-    pcnt_config_t pcnt_config = {
-        .pulse_gpio_num = ENC_A_GPIO,
-        .ctrl_gpio_num  = ENC_B_GPIO,
-        .channel        = PCNT_CHANNEL_0,
-        .unit           = PCNT_UNIT_USED,
-        .pos_mode       = PCNT_COUNT_INC,      // rising edge = +1
-        .neg_mode       = PCNT_COUNT_DIS,      // don't count falling edge
-        .lctrl_mode     = PCNT_MODE_REVERSE,   // reverse when B is low
-        .hctrl_mode     = PCNT_MODE_KEEP,      // keep when B is high
-        .counter_h_lim  = 32767,
-        .counter_l_lim  = -32768,
+    pcnt_unit_config_t unit_config = {
+        .high_limit = ENCODER_COUNTS_PER_DETENT,
+        .low_limit = -ENCODER_COUNTS_PER_DETENT,
     };
-    pcnt_unit_config(&pcnt_config);
+    pcnt_unit_handle_t unit = NULL;
+    ret = pcnt_new_unit(&unit_config, &unit);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "❌ PCNT unit allocation failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    pcnt_glitch_filter_config_t filter = { .max_glitch_ns = ENCODER_GLITCH_NS };
+    ESP_ERROR_CHECK(pcnt_unit_set_glitch_filter(unit, &filter));
+
+    // Full quadrature: each channel counts both edges of one line, with the
+    // other line deciding the direction. A rising while B is high is +1 (CW).
+    pcnt_chan_config_t a_config = { .edge_gpio_num = ENC_A_GPIO, .level_gpio_num = ENC_B_GPIO };
+    pcnt_chan_config_t b_config = { .edge_gpio_num = ENC_B_GPIO, .level_gpio_num = ENC_A_GPIO };
+    pcnt_channel_handle_t chan_a = NULL, chan_b = NULL;
+    ESP_ERROR_CHECK(pcnt_new_channel(unit, &a_config, &chan_a));
+    ESP_ERROR_CHECK(pcnt_new_channel(unit, &b_config, &chan_b));
+    ESP_ERROR_CHECK(pcnt_channel_set_edge_action(chan_a, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_DECREASE));
+    ESP_ERROR_CHECK(pcnt_channel_set_level_action(chan_a, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE));
+    ESP_ERROR_CHECK(pcnt_channel_set_edge_action(chan_b, PCNT_CHANNEL_EDGE_ACTION_DECREASE, PCNT_CHANNEL_EDGE_ACTION_INCREASE));
+    ESP_ERROR_CHECK(pcnt_channel_set_level_action(chan_b, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE));
 
-    // Temporarily disable glitch filter while debugging signal
-    // pcnt_set_filter_value(PCNT_UNIT_USED, 1000);
-    // pcnt_filter_enable(PCNT_UNIT_USED);
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(unit, ENCODER_COUNTS_PER_DETENT));
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(unit, -ENCODER_COUNTS_PER_DETENT));
+    pcnt_event_callbacks_t cbs = { .on_reach = encoder_on_reach };
+    ESP_ERROR_CHECK(pcnt_unit_register_event_callbacks(unit, &cbs, NULL));
 
-    pcnt_counter_pause(PCNT_UNIT_USED);
-    pcnt_counter_clear(PCNT_UNIT_USED);
-    pcnt_counter_resume(PCNT_UNIT_USED);
+    ESP_ERROR_CHECK(pcnt_unit_enable(unit));
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(unit));
+    ESP_ERROR_CHECK(pcnt_unit_start(unit));
+    ESP_LOGI(TAG, "🎛️ Encoder on GPIO%d/GPIO%d: x%d quadrature, %d ns glitch filter, %d-event queue",
+             ENC_A_GPIO, ENC_B_GPIO, ENCODER_COUNTS_PER_DETENT, ENCODER_GLITCH_NS, ENCODER_QUEUE_LEN);
+    return ESP_OK;
 }
 
-int encoder_get_delta(void)
+bool encoder_get_event(encoder_event_t *ev)
 {
-    static int16_t last = 0;
-    static uint32_t last_change_time = 0;
-    int16_t now;
-    pcnt_get_counter_value(PCNT_UNIT_USED, &now);
-    int raw_delta = now - last;
+    return encoder_queue_pop(&s_queue, ev);
+}
 
-    // With single edge counting, each physical click should be 1 count
-    // But add some tolerance for noise/bouncing
-    int clicks = 0;
-    if (raw_delta >= 1) clicks = 1;
-    else if (raw_delta <= -1) clicks = -1;
-    
-    // Basic debouncing: ignore rapid changes
-    uint32_t current_time = esp_timer_get_time() / 1000; // ms
-    if (clicks != 0 && (current_time - last_change_time > 100)) { // 100ms debounce
-        ESP_LOGI("ENC", "clicks=%d (raw=%d)", clicks, raw_delta);
-        last = now;
-        last_change_time = current_time;
-        
-        // reset counters if they drift far to avoid overflow
-        if (now > 16000 || now < -16000) {
-            pcnt_counter_clear(PCNT_UNIT_USED);
-            last = 0;
-        }
-        return clicks;
-    }
-    return 0;
-} 
\ No newline at end of file
+uint32_t encoder_dropped_events(void)
+{
+    return s_queue.dropped;
+}
@@ -1,7 +1,15 @@
 #pragma once
 
-// Initializes the rotary encoder (uses GPIO22 for CLK, GPIO21 for DT)
-void encoder_init(void);
+#include "esp_err.h"
+#include "encoder_core.h"
 
-// Returns signed detent steps since last call (CW positive, CCW negative)
-int encoder_get_delta(void); 
\ No newline at end of file
+// Initializes the rotary encoder (uses GPIO22 for CLK, GPIO21 for DT). A PCNT
+// unit counts every edge of both lines, and every detent is queued with its
+// timestamp from the watch-point interrupt.
+esp_err_t encoder_init(void);
+
+// Pops the oldest pending detent; false if there is none. Never blocks.
+bool encoder_get_event(encoder_event_t *ev);
+
+// Detents lost because nobody drained the queue in time
+uint32_t encoder_dropped_events(void);
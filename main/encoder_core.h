@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Hardware-independent half of the rotary encoder: the ISR -> player event
+// queue and a model of the PCNT quadrature counter. Header-only so the PCNT
+// ISR inlines the queue (no flash access from the interrupt) and the host
+// tests compile exactly the same code.
+
+// One detent of the knob, timestamped by the watch-point ISR
+typedef struct {
+    uint32_t ts_us;   // esp_timer_get_time(), low 32 bits
+    int8_t dir;       // +1 clockwise, -1 counter-clockwise
+} encoder_event_t;
+
+// Both lines high (pull-ups) between detents
+#define QUADRATURE_REST_A 1
+#define QUADRATURE_REST_B 1
+
+// Full quadrature: every edge of A and B counts, four counts per detent
+#define ENCODER_COUNTS_PER_DETENT 4
+
+// Pulses shorter than this are ignored by the PCNT glitch filter (the ESP32
+// filter tops out at 1023 APB cycles, ~12.7 µs)
+#define ENCODER_GLITCH_NS 10000
+
+// Software model of the PCNT unit encoder.c sets up: +1/-1 per edge, and the
+// counter wraps to 0 when it reaches +/-ENCODER_COUNTS_PER_DETENT, which is
+// where the watch-point interrupt reports a detent. The host replays recorded
+// edges through it; on the device the counting happens in hardware.
+typedef struct {
+    uint8_t pos;      // Position of the last A/B state in the Gray sequence 00 -> 01 -> 11 -> 10
+    int8_t count;     // Counter value, always inside the limits
+} quadrature_decoder_t;
+
+static inline uint8_t quadrature_pos(int a, int b)
+{
+    return (uint8_t)(((a & 1) << 1) | ((a ^ b) & 1));
+}
+
+static inline void quadrature_init(quadrature_decoder_t *dec, int a, int b)
+{
+    dec->pos = quadrature_pos(a, b);
+    dec->count = 0;
+}
+
+// Feed the A/B levels after an edge on either line. Returns +1/-1 when the
+// count reaches a limit (one detent), 0 otherwise. Contact bounce cancels out
+// (+1 then -1), even across a limit, because the wrap keeps the count in step
+// with the knob position.
+static inline int quadrature_feed(quadrature_decoder_t *dec, int a, int b)
+{
+    uint8_t pos = quadrature_pos(a, b);
+    uint8_t step = (uint8_t)(pos - dec->pos) & 3;
+    dec->pos = pos;
+    if (step == 1) {
+        dec->count++;
+    } else if (step == 3) {
+        dec->count--;
+    }
+    // step 2 cannot happen in hardware: the PCNT sees every edge that survives the filter
+
+    if (dec->count == ENCODER_COUNTS_PER_DETENT || dec->count == -ENCODER_COUNTS_PER_DETENT) {
+        int dir = dec->count > 0 ? 1 : -1;
+        dec->count = 0;
+        return dir;
+    }
+    return 0;
+}
+
+// Single-producer (ISR) / single-consumer (player task) ring. Each index is
+// written by one side only, so neither side ever blocks or takes a lock.
+#define ENCODER_QUEUE_LEN  32
+#define ENCODER_QUEUE_MASK (ENCODER_QUEUE_LEN - 1)
+_Static_assert((ENCODER_QUEUE_LEN & ENCODER_QUEUE_MASK) == 0, "ENCODER_QUEUE_LEN must be a power of two");
+
+typedef struct {
+    encoder_event_t events[ENCODER_QUEUE_LEN];
+    uint32_t head;      // Events pushed (producer only)
+    uint32_t tail;      // Events popped (consumer only)
+    uint32_t dropped;   // Events lost because the consumer fell a whole queue behind
+} encoder_queue_t;
+
+static inline bool encoder_queue_push(encoder_queue_t *q, encoder_event_t ev)
+{
+    uint32_t head = q->head;
+    if (head - __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE) == ENCODER_QUEUE_LEN) {
+        q->dropped++;
+        return false;
+    }
+    q->events[head & ENCODER_QUEUE_MASK] = ev;
+    __atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static inline bool encoder_queue_pop(encoder_queue_t *q, encoder_event_t *ev)
+{
+    uint32_t tail = q->tail;
+    if (__atomic_load_n(&q->head, __ATOMIC_ACQUIRE) == tail) {
+        return false;
+    }
+    *ev = q->events[tail & ENCODER_QUEUE_MASK];
+    __atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
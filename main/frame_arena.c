@@ -0,0 +1,102 @@
+#include "frame_arena.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_attr.h"
+#include "sdkconfig.h"
+
+#define FRAME_ARENA_ALIGN 16 // Cache-line friendly for PSRAM and DMA
+
+esp_err_t frame_arena_init(frame_arena_t *arena, size_t size, uint32_t caps)
+{
+    arena->base = NULL;
+    arena->size = 0;
+    arena->used = 0;
+    arena->high_water = 0;
+    if (size == 0) {
+        return ESP_OK;
+    }
+
+    size = (size + FRAME_ARENA_ALIGN - 1) & ~(size_t)(FRAME_ARENA_ALIGN - 1);
+    arena->base = heap_caps_aligned_alloc(FRAME_ARENA_ALIGN, size, caps);
+    if (!arena->base) {
+        return ESP_ERR_NO_MEM;
+    }
+    arena->size = size;
+    return ESP_OK;
+}
+
+void frame_arena_deinit(frame_arena_t *arena)
+{
+    if (arena->base) {
+        heap_caps_free(arena->base);
+    }
+    arena->base = NULL;
+    arena->size = 0;
+    arena->used = 0;
+}
+
+void *frame_arena_alloc(frame_arena_t *arena, size_t size)
+{
+    size = (size + FRAME_ARENA_ALIGN - 1) & ~(size_t)(FRAME_ARENA_ALIGN - 1);
+    if (!arena->base || size > arena->size - arena->used) {
+        return NULL;
+    }
+    void *p = arena->base + arena->used;
+    arena->used += size;
+    if (arena->used > arena->high_water) {
+        arena->high_water = arena->used;
+    }
+    return p;
+}
+
+#if CONFIG_HEAP_USE_HOOKS
+static TaskHandle_t s_watch_task = NULL;
+static volatile uint32_t s_heap_calls = 0;
+
+// Weak hooks called by the heap component on every allocation / free
+void IRAM_ATTR esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps)
+{
+    if (s_watch_task && xTaskGetCurrentTaskHandle() == s_watch_task) {
+        s_heap_calls++;
+    }
+}
+
+void IRAM_ATTR esp_heap_trace_free_hook(void *ptr)
+{
+    if (s_watch_task && ptr && xTaskGetCurrentTaskHandle() == s_watch_task) {
+        s_heap_calls++;
+    }
+}
+
+bool frame_arena_heap_watch_supported(void)
+{
+    return true;
+}
+
+void frame_arena_heap_watch_begin(void)
+{
+    s_heap_calls = 0;
+    s_watch_task = xTaskGetCurrentTaskHandle();
+}
+
+uint32_t frame_arena_heap_watch_end(void)
+{
+    s_watch_task = NULL;
+    return s_heap_calls;
+}
+#else
+bool frame_arena_heap_watch_supported(void)
+{
+    return false;
+}
+
+void frame_arena_heap_watch_begin(void)
+{
+}
+
+uint32_t frame_arena_heap_watch_end(void)
+{
+    return 0;
+}
+#endif
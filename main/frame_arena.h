@@ -0,0 +1,38 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Bump allocator for per-frame scratch memory. Sized once when a sequence is
+// loaded, reset at the start of every frame, never returns memory to the heap
+// during playback.
+typedef struct {
+    uint8_t *base;      // Backing block (NULL = arena not set up)
+    size_t size;        // Capacity in bytes
+    size_t used;        // Bytes handed out since the last reset
+    size_t high_water;  // Largest 'used' seen since init
+} frame_arena_t;
+
+// Allocate the backing block with the given heap caps
+esp_err_t frame_arena_init(frame_arena_t *arena, size_t size, uint32_t caps);
+
+// Release the backing block
+void frame_arena_deinit(frame_arena_t *arena);
+
+// Carve 'size' bytes (16-byte aligned) out of the arena; NULL if it does not fit
+void *frame_arena_alloc(frame_arena_t *arena, size_t size);
+
+// Return every allocation at once (call at the start of each frame)
+static inline void frame_arena_reset(frame_arena_t *arena)
+{
+    arena->used = 0;
+}
+
+// Heap-call watch: counts heap_caps_* / malloc / free calls made by the calling
+// task between begin and end. Needs CONFIG_HEAP_USE_HOOKS; otherwise it always
+// reports 0 and frame_arena_heap_watch_supported() returns false.
+bool frame_arena_heap_watch_supported(void);
+void frame_arena_heap_watch_begin(void);
+uint32_t frame_arena_heap_watch_end(void);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+
+// Raw frame pack written by tools/pack_frames.py and flashed straight to the
+// storage partition (CONFIG_T4_FRAME_SOURCE_PACK). Layout, little-endian:
+//   frame_pack_header_t
+//   frame_pack_entry_t[count]
+//   padding up to data_offset (4 KB aligned, so the data can be mmapped)
+//   entry data, in index order, each entry 4-byte aligned (identical entries share one copy)
+// The manifest's frames come first and in manifest order, so playing the
+// sequence reads the data region front to back.
+
+#define FRAME_PACK_MAGIC       "T4PK"
+#define FRAME_PACK_VERSION     1
+#define FRAME_PACK_NAME_LEN    52
+#define FRAME_PACK_DATA_ALIGN  4096
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint16_t version;
+    uint16_t entry_size;    // sizeof(frame_pack_entry_t)
+    uint32_t count;         // Number of entries
+    uint32_t data_offset;   // Start of the data region, from the start of the pack
+    uint32_t data_size;     // Bytes from data_offset to the end of the last entry
+    uint32_t index_crc32;   // CRC-32 of the entry table
+} frame_pack_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t name_hash;     // FNV-1a of name, checked before the string compare
+    uint32_t offset;        // From data_offset
+    uint32_t size;
+    char name[FRAME_PACK_NAME_LEN];  // Path relative to data/ ("output/dog-001.jpg"), NUL-padded
+} frame_pack_entry_t;
+
+_Static_assert(sizeof(frame_pack_header_t) == 24, "frame_pack_header_t layout is shared with pack_frames.py");
+_Static_assert(sizeof(frame_pack_entry_t) == 64, "frame_pack_entry_t layout is shared with pack_frames.py");
+
+static inline uint32_t frame_pack_name_hash(const char *name)
+{
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,119 @@
+#include "frame_source.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include <string.h>
+
+static const char *TAG = "FRAME_SOURCE";
+
+static const frame_source_t *s_source = NULL;
+
+static const frame_source_t *const s_backends[] = {
+    &frame_source_spiffs,
+#if CONFIG_T4_FRAME_SOURCE_LITTLEFS || !defined(ESP_PLATFORM)
+    &frame_source_littlefs,
+#endif
+    &frame_source_pack,
+};
+
+static const frame_source_t *default_source(void)
+{
+#if CONFIG_T4_FRAME_SOURCE_LITTLEFS
+    return &frame_source_littlefs;
+#elif CONFIG_T4_FRAME_SOURCE_PACK
+    return &frame_source_pack;
+#else
+    return &frame_source_spiffs;
+#endif
+}
+
+esp_err_t frame_source_init(const frame_source_t *source)
+{
+    if (!source) {
+        source = default_source();
+    }
+    esp_err_t ret = source->mount();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "❌ Failed to mount %s storage: %s", source->name, esp_err_to_name(ret));
+        return ret;
+    }
+    s_source = source;
+    ESP_LOGI(TAG, "📁 Frames come from %s storage", source->name);
+    return ESP_OK;
+}
+
+const frame_source_t *frame_source_current(void)
+{
+    return s_source;
+}
+
+const frame_source_t *frame_source_find(const char *name)
+{
+    for (size_t i = 0; i < sizeof(s_backends) / sizeof(s_backends[0]); i++) {
+        if (strcmp(s_backends[i]->name, name) == 0) {
+            return s_backends[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t frame_source_open(const char *name, frame_file_t *file)
+{
+    return s_source ? s_source->open(name, file) : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t frame_source_stat(const char *name, size_t *size)
+{
+    return s_source ? s_source->stat(name, size) : ESP_ERR_INVALID_STATE;
+}
+
+size_t frame_source_read(frame_file_t *file, void *dst, size_t len)
+{
+    return s_source->read(file, dst, len);
+}
+
+void frame_source_close(frame_file_t *file)
+{
+    s_source->close(file);
+}
+
+esp_err_t frame_source_locate(const char *name, uint32_t *offset, uint32_t *size)
+{
+    if (!s_source) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return s_source->locate ? s_source->locate(name, offset, size) : ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t frame_source_read_region(uint32_t offset, void *dst, size_t len)
+{
+    if (!s_source) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return s_source->read_region ? s_source->read_region(offset, dst, len) : ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t frame_source_load(const char *name, uint32_t caps, uint8_t **data, size_t *size)
+{
+    frame_file_t file;
+    esp_err_t ret = frame_source_open(name, &file);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    // One spare byte so text entries (the manifest) can be NUL-terminated by the caller
+    uint8_t *buf = heap_caps_malloc(file.size + 1, caps);
+    if (!buf) {
+        frame_source_close(&file);
+        return ESP_ERR_NO_MEM;
+    }
+    size_t got = frame_source_read(&file, buf, file.size);
+    frame_source_close(&file);
+    if (got != file.size) {
+        heap_caps_free(buf);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    buf[got] = 0;
+    *data = buf;
+    *size = got;
+    return ESP_OK;
+}
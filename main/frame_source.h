@@ -0,0 +1,65 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Where the boot image, manifest and frames are read from. The player only
+// goes through this interface, so the storage backend can change without
+// touching the playback code. Names are relative to the storage root, i.e.
+// the data/ directory of the project ("test.jpg", "output/manifest.txt").
+//
+// Backends:
+//  - spiffs:   the partition mounted at STORAGE_BASE_PATH through VFS
+//  - littlefs: the same through LittleFS (directories, faster open/stat)
+//  - pack:     a raw pack from tools/pack_frames.py, read with esp_partition_read
+// CONFIG_T4_FRAME_SOURCE picks the one frame_source_init(NULL) mounts.
+
+typedef struct {
+    void *fp;          // FILE * (filesystem backends)
+    uint32_t offset;   // Absolute partition offset of the entry data (pack)
+    uint32_t size;     // Entry size in bytes, filled in by open
+    uint32_t pos;      // Read position (pack)
+} frame_file_t;
+
+typedef struct {
+    const char *name;
+    esp_err_t (*mount)(void);
+    esp_err_t (*open)(const char *name, frame_file_t *file);
+    esp_err_t (*stat)(const char *name, size_t *size);
+    size_t (*read)(frame_file_t *file, void *dst, size_t len);
+    void (*close)(frame_file_t *file);
+    // Optional, for backends that store entries contiguously (pack); NULL otherwise
+    esp_err_t (*locate)(const char *name, uint32_t *offset, uint32_t *size);
+    esp_err_t (*read_region)(uint32_t offset, void *dst, size_t len);
+} frame_source_t;
+
+extern const frame_source_t frame_source_spiffs;
+extern const frame_source_t frame_source_littlefs;
+extern const frame_source_t frame_source_pack;
+
+// Mount 'source' (NULL = the CONFIG_T4_FRAME_SOURCE backend) and make it current
+esp_err_t frame_source_init(const frame_source_t *source);
+
+// Current backend (NULL before frame_source_init)
+const frame_source_t *frame_source_current(void);
+
+// Look a backend up by name ("spiffs", "littlefs", "pack"); NULL if not built in
+const frame_source_t *frame_source_find(const char *name);
+
+// Operations on the current backend
+esp_err_t frame_source_open(const char *name, frame_file_t *file);
+esp_err_t frame_source_stat(const char *name, size_t *size);
+size_t frame_source_read(frame_file_t *file, void *dst, size_t len);
+void frame_source_close(frame_file_t *file);
+
+// Where an entry sits in the backend's storage, so a run of entries can be
+// fetched with one frame_source_read_region. ESP_ERR_NOT_SUPPORTED on filesystems.
+esp_err_t frame_source_locate(const char *name, uint32_t *offset, uint32_t *size);
+
+// Bulk read of [offset, offset + len) in large chunks, logging progress and MB/s
+esp_err_t frame_source_read_region(uint32_t offset, void *dst, size_t len);
+
+// Read a whole entry into a new buffer from heap_caps_malloc(caps); free it with heap_caps_free
+esp_err_t frame_source_load(const char *name, uint32_t caps, uint8_t **data, size_t *size);
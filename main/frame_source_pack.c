@@ -0,0 +1,219 @@
+// Pack backend: no filesystem, the storage partition holds a frame pack
+// (main/frame_pack.h). The entry table is read once at mount; open and stat
+// are lookups in RAM and reads go straight to esp_partition_read. The player
+// preloads the whole frame run with one read_region.
+
+#include "frame_source.h"
+#include "frame_pack.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "FRAME_PACK";
+
+#define PACK_PARTITION_LABEL "storage"
+
+// Bulk reads map the region through the flash cache and memcpy it out; set to 0
+// (or when the MMU has no room) to use esp_partition_read in aligned chunks instead
+#ifndef PACK_BULK_USE_MMAP
+#define PACK_BULK_USE_MMAP 1
+#endif
+#define PACK_BULK_CHUNK      (64 * 1024)
+#define PACK_MMAP_ALIGN      0x10000      // MMU page size
+#define PACK_PROGRESS_STEP   (512 * 1024)
+
+static const esp_partition_t *s_partition = NULL;
+static frame_pack_entry_t *s_entries = NULL;
+static uint32_t s_count = 0;
+static uint32_t s_data_offset = 0;
+static uint32_t s_next_hint = 0;   // Entry after the last one found; sequences open in pack order
+
+static esp_err_t pack_mount(void)
+{
+    s_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, PACK_PARTITION_LABEL);
+    if (!s_partition) {
+        ESP_LOGE(TAG, "❌ No '%s' partition", PACK_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    frame_pack_header_t hdr;
+    esp_err_t ret = esp_partition_read(s_partition, 0, &hdr, sizeof(hdr));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (memcmp(hdr.magic, FRAME_PACK_MAGIC, sizeof(hdr.magic)) != 0 || hdr.version != FRAME_PACK_VERSION ||
+        hdr.entry_size != sizeof(frame_pack_entry_t)) {
+        ESP_LOGE(TAG, "❌ '%s' does not hold a v%d frame pack (flash one made by tools/pack_frames.py)",
+                 PACK_PARTITION_LABEL, FRAME_PACK_VERSION);
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if ((uint64_t)hdr.data_offset + hdr.data_size > s_partition->size) {
+        ESP_LOGE(TAG, "❌ Pack data (%lu bytes) runs past the partition", (unsigned long)hdr.data_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t table_size = (size_t)hdr.count * sizeof(frame_pack_entry_t);
+    frame_pack_entry_t *entries = malloc(table_size);
+    if (!entries) {
+        return ESP_ERR_NO_MEM;
+    }
+    ret = esp_partition_read(s_partition, sizeof(hdr), entries, table_size);
+    if (ret == ESP_OK && esp_rom_crc32_le(0, (const uint8_t *)entries, table_size) != hdr.index_crc32) {
+        ESP_LOGE(TAG, "❌ Pack index CRC mismatch");
+        ret = ESP_ERR_INVALID_CRC;
+    }
+    for (uint32_t i = 0; ret == ESP_OK && i < hdr.count; i++) {
+        if ((uint64_t)entries[i].offset + entries[i].size > hdr.data_size) {
+            ESP_LOGE(TAG, "❌ Pack entry %.*s out of bounds", FRAME_PACK_NAME_LEN, entries[i].name);
+            ret = ESP_ERR_INVALID_SIZE;
+        }
+        entries[i].name[FRAME_PACK_NAME_LEN - 1] = 0;
+    }
+    if (ret != ESP_OK) {
+        free(entries);
+        return ret;
+    }
+
+    free(s_entries);
+    s_entries = entries;
+    s_count = hdr.count;
+    s_data_offset = hdr.data_offset;
+    s_next_hint = 0;
+    ESP_LOGI(TAG, "📦 Frame pack: %lu entries, %lu bytes of data at 0x%lx",
+             (unsigned long)s_count, (unsigned long)hdr.data_size,
+             (unsigned long)(s_partition->address + s_data_offset));
+    return ESP_OK;
+}
+
+static const frame_pack_entry_t *pack_lookup(const char *name)
+{
+    uint32_t hash = frame_pack_name_hash(name);
+    for (uint32_t n = 0, i = s_next_hint; n < s_count; n++, i = (i + 1 == s_count) ? 0 : i + 1) {
+        if (s_entries[i].name_hash == hash && strcmp(s_entries[i].name, name) == 0) {
+            s_next_hint = (i + 1 == s_count) ? 0 : i + 1;
+            return &s_entries[i];
+        }
+    }
+    return NULL;
+}
+
+static esp_err_t pack_open(const char *name, frame_file_t *file)
+{
+    const frame_pack_entry_t *e = pack_lookup(name);
+    if (!e) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *file = (frame_file_t){ .offset = s_data_offset + e->offset, .size = e->size };
+    return ESP_OK;
+}
+
+static esp_err_t pack_stat(const char *name, size_t *size)
+{
+    const frame_pack_entry_t *e = pack_lookup(name);
+    if (!e) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *size = e->size;
+    return ESP_OK;
+}
+
+static size_t pack_read(frame_file_t *file, void *dst, size_t len)
+{
+    if (len > file->size - file->pos) {
+        len = file->size - file->pos;
+    }
+    if (len == 0 || esp_partition_read(s_partition, file->offset + file->pos, dst, len) != ESP_OK) {
+        return 0;
+    }
+    file->pos += len;
+    return len;
+}
+
+static void pack_close(frame_file_t *file)
+{
+}
+
+static esp_err_t pack_locate(const char *name, uint32_t *offset, uint32_t *size)
+{
+    const frame_pack_entry_t *e = pack_lookup(name);
+    if (!e) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *offset = s_data_offset + e->offset;
+    *size = e->size;
+    return ESP_OK;
+}
+
+static void log_progress(size_t done, size_t step, size_t len)
+{
+    if (done / PACK_PROGRESS_STEP != (done - step) / PACK_PROGRESS_STEP || done == len) {
+        ESP_LOGI(TAG, "📥 %lu/%lu KB", (unsigned long)(done / 1024), (unsigned long)(len / 1024));
+    }
+}
+
+static esp_err_t pack_read_region(uint32_t offset, void *dst, size_t len)
+{
+    if ((uint64_t)offset + len > s_partition->size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    uint8_t *out = dst;
+    const char *how = "esp_partition_read";
+    esp_err_t ret = ESP_FAIL;
+    int64_t start = esp_timer_get_time();
+
+#if PACK_BULK_USE_MMAP
+    uint32_t map_start = offset & ~(uint32_t)(PACK_MMAP_ALIGN - 1);
+    const void *map = NULL;
+    esp_partition_mmap_handle_t handle;
+    ret = esp_partition_mmap(s_partition, map_start, offset - map_start + len, ESP_PARTITION_MMAP_DATA, &map, &handle);
+    if (ret == ESP_OK) {
+        how = "mmap + memcpy";
+        const uint8_t *src = (const uint8_t *)map + (offset - map_start);
+        for (size_t done = 0; done < len;) {
+            size_t n = len - done < PACK_BULK_CHUNK ? len - done : PACK_BULK_CHUNK;
+            memcpy(out + done, src + done, n);
+            done += n;
+            log_progress(done, n, len);
+        }
+        esp_partition_munmap(handle);
+    } else {
+        ESP_LOGW(TAG, "⚠️ Cannot map %lu bytes (%s), reading in chunks", (unsigned long)len, esp_err_to_name(ret));
+    }
+#endif
+
+    if (ret != ESP_OK) {
+        // The first chunk ends on a chunk boundary, so the rest are aligned
+        for (size_t done = 0; done < len;) {
+            size_t n = PACK_BULK_CHUNK - (offset + done) % PACK_BULK_CHUNK;
+            if (n > len - done) {
+                n = len - done;
+            }
+            ret = esp_partition_read(s_partition, offset + done, out + done, n);
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "❌ Read at 0x%lx failed: %s", (unsigned long)(offset + done), esp_err_to_name(ret));
+                return ret;
+            }
+            done += n;
+            log_progress(done, n, len);
+        }
+    }
+
+    int64_t elapsed = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "🚚 %lu bytes via %s in %lld us (%.2f MB/s)", (unsigned long)len, how, (long long)elapsed,
+             elapsed > 0 ? (double)len / (double)elapsed : 0.0);
+    return ESP_OK;
+}
+
+const frame_source_t frame_source_pack = {
+    .name = "pack",
+    .mount = pack_mount,
+    .open = pack_open,
+    .stat = pack_stat,
+    .read = pack_read,
+    .close = pack_close,
+    .locate = pack_locate,
+    .read_region = pack_read_region,
+};
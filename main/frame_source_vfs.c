@@ -0,0 +1,147 @@
+// Filesystem backends: SPIFFS or LittleFS mounted at STORAGE_BASE_PATH and read
+// through VFS. Both share the file operations and differ only in the mount.
+
+#include "frame_source.h"
+#include "image_display.h" // For STORAGE_BASE_PATH
+#include "esp_log.h"
+#include "esp_spiffs.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+#include <sys/stat.h>
+
+#if CONFIG_T4_FRAME_SOURCE_LITTLEFS || !defined(ESP_PLATFORM)
+#include "esp_littlefs.h"
+#endif
+
+static const char *TAG = "FRAME_SOURCE";
+
+#define STORAGE_PARTITION_LABEL "storage"
+#define FRAME_SOURCE_NAME_MAX 128
+#define VFS_PATH_MAX (sizeof(STORAGE_BASE_PATH) + FRAME_SOURCE_NAME_MAX)
+
+static bool vfs_path(const char *name, char *path, size_t len)
+{
+    int written = snprintf(path, len, STORAGE_BASE_PATH "/%s", name);
+    return written > 0 && (size_t)written < len;
+}
+
+static esp_err_t vfs_open(const char *name, frame_file_t *file)
+{
+    char path[VFS_PATH_MAX];
+    if (!vfs_path(name, path, sizeof(path))) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    // fstat on the open file saves SPIFFS a second walk over its object table
+    struct stat st;
+    if (fstat(fileno(f), &st) != 0) {
+        fclose(f);
+        return ESP_FAIL;
+    }
+    *file = (frame_file_t){ .fp = f, .size = (uint32_t)st.st_size };
+    return ESP_OK;
+}
+
+static esp_err_t vfs_stat(const char *name, size_t *size)
+{
+    char path[VFS_PATH_MAX];
+    struct stat st;
+    if (!vfs_path(name, path, sizeof(path))) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (stat(path, &st) != 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *size = (size_t)st.st_size;
+    return ESP_OK;
+}
+
+static size_t vfs_read(frame_file_t *file, void *dst, size_t len)
+{
+    return fread(dst, 1, len, file->fp);
+}
+
+static void vfs_close(frame_file_t *file)
+{
+    if (file->fp) {
+        fclose(file->fp);
+        file->fp = NULL;
+    }
+}
+
+static void log_usage(const char *fs, size_t total, size_t used)
+{
+    ESP_LOGI(TAG, "📊 %s: total: %lu, used: %lu, free: %lu (%d%% used)", fs,
+             (unsigned long)total, (unsigned long)used, (unsigned long)(total - used),
+             total ? (int)((used * 100) / total) : 0);
+}
+
+static esp_err_t spiffs_mount(void)
+{
+    ESP_LOGI(TAG, "📁 Initializing SPIFFS...");
+
+    esp_vfs_spiffs_conf_t conf = {
+        .base_path = STORAGE_BASE_PATH,
+        .partition_label = STORAGE_PARTITION_LABEL,
+        .max_files = 5,
+        .format_if_mount_failed = true
+    };
+
+    esp_err_t ret = esp_vfs_spiffs_register(&conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize SPIFFS (%s)", esp_err_to_name(ret));
+        return ret;
+    }
+
+    size_t total = 0, used = 0;
+    if (esp_spiffs_info(STORAGE_PARTITION_LABEL, &total, &used) == ESP_OK) {
+        log_usage("SPIFFS", total, used);
+    }
+    return ESP_OK;
+}
+
+const frame_source_t frame_source_spiffs = {
+    .name = "spiffs",
+    .mount = spiffs_mount,
+    .open = vfs_open,
+    .stat = vfs_stat,
+    .read = vfs_read,
+    .close = vfs_close,
+};
+
+#if CONFIG_T4_FRAME_SOURCE_LITTLEFS || !defined(ESP_PLATFORM)
+static esp_err_t littlefs_mount(void)
+{
+    ESP_LOGI(TAG, "📁 Initializing LittleFS...");
+
+    esp_vfs_littlefs_conf_t conf = {
+        .base_path = STORAGE_BASE_PATH,
+        .partition_label = STORAGE_PARTITION_LABEL,
+        .format_if_mount_failed = false,  // The image is built from data/ at flash time
+    };
+
+    esp_err_t ret = esp_vfs_littlefs_register(&conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize LittleFS (%s)", esp_err_to_name(ret));
+        return ret;
+    }
+
+    size_t total = 0, used = 0;
+    if (esp_littlefs_info(STORAGE_PARTITION_LABEL, &total, &used) == ESP_OK) {
+        log_usage("LittleFS", total, used);
+    }
+    return ESP_OK;
+}
+
+const frame_source_t frame_source_littlefs = {
+    .name = "littlefs",
+    .mount = littlefs_mount,
+    .open = vfs_open,
+    .stat = vfs_stat,
+    .read = vfs_read,
+    .close = vfs_close,
+};
+#endif
@@ -1,10 +1,9 @@
 #include "image_display.h" // For preloaded_jpeg_frame_t
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
 #include "esp_err.h"
-#include "esp_spiffs.h"
-#include "esp_vfs.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_vendor.h"
 #include "esp_lcd_panel_ops.h"
@@ -13,13 +12,21 @@
 #include "driver/spi_master.h"
 #include "jpeg_decoder.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
-#include <sys/stat.h>
-#include <dirent.h>
 #include "esp_heap_caps.h"
 #include "esp_timer.h"
 #include <assert.h>
-#include "encoder.h"
+#include "speed_control.h"
+#include "perf_telemetry.h"
+#include "frame_arena.h"
+#include "decode_bench.h"
+#include "frame_source.h"
+#include "storage_bench.h"
+#include "span_trace.h"
+#include "q565.h"
+#include "rgb565_blend.h"
+#include "rgb565_scale.h"
 
 static const char *TAG = "T4_IMAGE_DISPLAY";
 
@@ -48,25 +55,146 @@ extern esp_lcd_panel_handle_t panel_handle;
 // #define JPEG_DECODE_TIMEOUT_MS 1000 // Unused
 
 // Add these at the top with other globals
+#define CLIP_PENDING_NONE (-2)
+
 static preloaded_jpeg_frame_t* g_preloaded_frames = NULL;
 static uint8_t* g_all_jpeg_data_psram = NULL;
 static uint8_t* g_common_out_buf = NULL;
-static uint8_t* g_common_work_buf = NULL;
+static uint8_t* g_common_work_buf = NULL;   // Bulk tjpgd work pool (PSRAM)
+static uint8_t* g_fast_work_buf = NULL;     // Hot part of the tjpgd work pool (internal DRAM), may be NULL
 static int g_num_loaded_frames = 0;
 static bool g_frames_loaded = false;
+static frame_arena_t g_frame_arena;          // Per-frame decode scratch, sized at sequence load
+static uint32_t g_frame_path_heap_calls = 0; // Heap calls seen inside the frame path (must stay 0)
+static const uint8_t* g_shown_frame_data = NULL; // JPEG data currently on screen (NULL = unknown / cleared)
+static bool g_shown_preview = false;              // ...and whether it is a scrub preview of that data
+static int g_shown_index = -1;                    // Frame index on screen, -1 = none
+static uint16_t* g_band_bufs[2] = { NULL, NULL }; // Internal DMA bounce buffers for streamed upscaling
+static uint32_t g_band_seq[2] = { 0, 0 };         // Draw sequence number last sent from each band buffer
+static image_display_clip_t* g_clips = NULL;      // Clip table, in manifest order
+static int g_num_clips = 0;
+static volatile int s_current_clip = -1;          // Clip being looped, -1 = whole manifest
+static volatile int s_pending_clip = CLIP_PENDING_NONE;  // Set by image_display_select_clip, taken per frame
+
+// Upscaled frames are generated band by band (this many source rows) straight into the DMA
+// bounce buffers while the previous band is on the bus; the full-size frame never exists
+#ifndef STREAM_UPSCALE_TO_DMA
+#define STREAM_UPSCALE_TO_DMA  1
+#endif
+#define UPSCALE_BAND_SRC_ROWS  8
+#define UPSCALE_MAX_FACTOR     3
+#define UPSCALE_BAND_BUF_SIZE  (LOGICAL_DISPLAY_WIDTH * UPSCALE_BAND_SRC_ROWS * UPSCALE_MAX_FACTOR * 2)
+
+// Scrub previews (CONFIG_T4_KNOB_SCRUB): while the knob turns, JPEG frames are decoded at this
+// tjpgd scale and blown up to the display. 1/8 is each block's DC value with no IDCT at all;
+// JPEG_IMAGE_SCALE_1_4 looks better but runs the IDCT and averages.
+#ifndef SCRUB_PREVIEW_SCALE
+#define SCRUB_PREVIEW_SCALE    JPEG_IMAGE_SCALE_1_8
+#endif
+#define SCRUB_POLL_MS          10  // Frame interval while scrubbing, so each detent shows at once
+
+// Frame sizes that are not a whole fraction of the display: 0 = drawn at native size, centred
+// (3× if it fits); 1 = scaled to fit, letterboxed; 2 = scaled to fill, centre-cropped.
+// Sizes that come out at exactly k× still use the nearest-neighbour kernels.
+#ifndef SCALE_FIT_MODE
+#define SCALE_FIT_MODE         1
+#endif
+#define SCALE_MAP_CACHE        4   // Source sizes whose index tables are kept
+
+// Lookahead: the slack left before the next frame is due decodes the frames after it into a
+// ring of native-size RGB565 slots in PSRAM, and playback draws those without decoding.
+// The budget is split into as many slots as the largest frame allows; 0 disables the ring.
+#ifndef LOOKAHEAD_PSRAM_BUDGET
+#define LOOKAHEAD_PSRAM_BUDGET (256 * 1024)
+#endif
+#define LOOKAHEAD_MAX_SLOTS    8
+#define LOOKAHEAD_MARGIN_US    2000  // Left free before the deadline so a late decode does not push the frame
+
+// Temporal blend (CONFIG_T4_TEMPORAL_BLEND): cross-fades of the frame on screen and the next one,
+// one per BLEND_INTERVAL_MS of frame delay after the first, at most BLEND_MAX_STEPS per frame
+#define BLEND_INTERVAL_MS      33
+#define BLEND_MAX_STEPS        4
+
+// Heap-call watch on the steady-state frame path: debug only, because the hooks run on every
+// allocation in the system. Turn on CONFIG_HEAP_USE_HOOKS (menuconfig → Component config → Heap
+// memory debugging → Use allocation and free hooks) to log frames that call the heap; set this
+// to 1 as well to abort on the first one (abort(), not assert(), so NDEBUG builds still stop).
+// The host players build with both, so ctest fails on a new allocation in the frame path.
+#ifndef FRAME_PATH_ASSERT_NO_HEAP
+#define FRAME_PATH_ASSERT_NO_HEAP 0
+#endif
+
+// Set to N > 0 to benchmark work-pool placements over N passes of the sequence before playback
+#ifndef DECODE_BENCH_PASSES
+#define DECODE_BENCH_PASSES 0
+#endif
+
+// Set to N > 0 to time stat/open/sequential read of every frame on the frame source before preload
+#ifndef STORAGE_BENCH_PASSES
+#define STORAGE_BENCH_PASSES 0
+#endif
 
 extern volatile uint32_t g_frame_delay_ms;
 
+// Stage timings of the most recent decode_and_display_jpeg call (read by the player for telemetry)
+static perf_frame_record_t s_frame_timing;
+static int64_t s_draw_start_us = 0;
+static volatile uint32_t s_color_done_us = 0;  // Written from the panel IO ISR; 32 bits so reads are atomic
+
+// Every draw goes through panel_draw(); one colour-done callback arrives per draw, in order
+static uint32_t s_draws_submitted = 0;
+static volatile uint32_t s_draws_completed = 0;  // Written from the panel IO ISR
+static SemaphoreHandle_t s_trans_done_sem = NULL;   // Given per completed draw, created when the player starts
+
+bool IRAM_ATTR image_display_on_color_trans_done(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t need_yield = pdFALSE;
+    s_color_done_us = (uint32_t)esp_timer_get_time();
+    s_draws_completed++;
+    SPAN_INSTANT(SPAN_DMA_DONE, s_draws_completed);
+    if (s_trans_done_sem) {
+        xSemaphoreGiveFromISR(s_trans_done_sem, &need_yield);
+    }
+    return need_yield == pdTRUE;
+}
+
+// Draw a bitmap and remember its sequence number (the data must stay valid until that draw completes)
+static esp_err_t panel_draw(int x_start, int y_start, int x_end, int y_end, const void *data, uint32_t *seq)
+{
+    uint32_t n = ++s_draws_submitted;
+    SPAN_BEGIN(SPAN_DRAW_SUBMIT, n);
+    esp_err_t ret = esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end, y_end, data);
+    SPAN_END(SPAN_DRAW_SUBMIT, n);
+    if (ret != ESP_OK) {
+        s_draws_submitted--; // Never reached the bus, so no completion callback
+    } else if (seq) {
+        *seq = n;
+    }
+    return ret;
+}
+
+// Block until the draw with sequence number 'seq' has left the bus
+static esp_err_t panel_wait_draw_done(uint32_t seq, TickType_t timeout)
+{
+    while ((int32_t)(s_draws_completed - seq) < 0) {
+        if (!s_trans_done_sem || xSemaphoreTake(s_trans_done_sem, timeout) != pdTRUE) {
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+    return ESP_OK;
+}
+
 #include <assert.h>
 
 /*-----------------------------------------------------------------------
- * Optional 2× up-scalers controlled by UPSCALE_MODE (see image_display.h)
+ * Optional 2× up-scalers controlled by UPSCALE_MODE (see image_display.h),
+ * kernels in rgb565_scale.c
  *   0 – none
  *   1 – nearest-neighbour (already very fast)
- *   2 – bilinear (slightly smoother, ~2-3 ms extra at 160×120)
+ *   2 – bilinear 2×, fixed point (smoother; 3× and previews stay nearest-neighbour)
  *---------------------------------------------------------------------*/
 
-#if UPSCALE_MODE == 1
+#if UPSCALE_MODE >= 1
 // Optional ordered-dither variant: instead of making all 4 pixels in the 2×2
 // block identical, sample the neighbouring source pixels in a Bayer-like
 // pattern (TL = centre, TR = right, BL = below, BR = diagonal). This gives a
@@ -106,63 +234,270 @@ static void nn_scale_dither_2x_rgb565(const uint16_t *src, uint16_t *dst, int sr
 }
 #endif // USE_DITHERED_NN
 
-static void nn_scale_2x_rgb565(const uint16_t *src, uint16_t *dst, int src_w, int src_h)
+// The 2× case goes through the bilinear kernel in UPSCALE_MODE 2
+static inline bool use_bilinear(int factor, int src_w)
 {
-    assert(src_w * 2 == LOGICAL_DISPLAY_WIDTH && src_h * 2 == LOGICAL_DISPLAY_HEIGHT);
-    for (int y = 0; y < src_h; y++) {
-        const uint16_t *s_row = src + y * src_w;
-        uint16_t *d_row0 = dst + (y * 2) * LOGICAL_DISPLAY_WIDTH;
-        uint16_t *d_row1 = d_row0 + LOGICAL_DISPLAY_WIDTH;
-        for (int x = 0; x < src_w; x++) {
-            uint16_t pix = s_row[x];
-            int d_idx = x * 2;
-            d_row0[d_idx] = pix;
-            d_row0[d_idx + 1] = pix;
-            d_row1[d_idx] = pix;
-            d_row1[d_idx + 1] = pix;
+    return UPSCALE_MODE == 2 && factor == 2 && src_w <= RGB565_BILINEAR_MAX_SRC_W;
+}
+
+#if SCALE_FIT_MODE
+static rgb565_scale_map_t g_scale_maps[SCALE_MAP_CACHE];   // Built at preload, one per frame size
+static int g_scale_maps_used = 0;
+static rgb565_scale_map_t g_scale_map_spare;   // Any size preload had no slot for, rebuilt on a miss
+static bool g_scale_map_spare_valid = false;
+static bool g_scale_map_overflow_warned = false;
+
+static const rgb565_scale_map_t* scale_map_find(int width, int height)
+{
+    for (int m = 0; m < g_scale_maps_used; m++) {
+        if (g_scale_maps[m].src_w == width && g_scale_maps[m].src_h == height) {
+            return &g_scale_maps[m];
         }
     }
+    if (g_scale_map_spare_valid && g_scale_map_spare.src_w == width && g_scale_map_spare.src_h == height) {
+        return &g_scale_map_spare;
+    }
+    return NULL;
 }
 
-// 3× nearest-neighbour (for 106×80 → 318×240). We still use the logical
-// display stride (320) so the 1-pixel margins on left/right stay black.
-static void nn_scale_3x_rgb565(const uint16_t *src, uint16_t *dst, int src_w, int src_h)
+static void scale_map_build(rgb565_scale_map_t* map, int width, int height)
 {
-    int dst_w = src_w * 3;
-    for (int y = 0; y < src_h; y++) {
-        const uint16_t *s_row = src + y * src_w;
-        uint16_t *d_row0 = dst + (y * 3) * dst_w;
-        uint16_t *d_row1 = d_row0 + dst_w;
-        uint16_t *d_row2 = d_row1 + dst_w;
+    rgb565_scale_map_init(map, width, height, LOGICAL_DISPLAY_WIDTH, LOGICAL_DISPLAY_HEIGHT, SCALE_FIT_MODE == 2);
+}
 
-        for (int x = 0; x < src_w; x++) {
-            uint16_t pix = s_row[x];
-            int dx = x * 3;
+// Index tables for a frame about to be drawn: the preloaded ones, else the spare slot
+static const rgb565_scale_map_t* scale_map_for(int width, int height)
+{
+    const rgb565_scale_map_t* map = scale_map_find(width, height);
+    if (map == NULL) {
+        scale_map_build(&g_scale_map_spare, width, height);
+        g_scale_map_spare_valid = true;
+        map = &g_scale_map_spare;
+    }
+    return map;
+}
+
+// Build the index tables for a preloaded frame size. Called once per frame from the preload
+// loop; sizes past the cache share the spare slot, with one warning.
+static const rgb565_scale_map_t* scale_map_preload(int width, int height)
+{
+    const rgb565_scale_map_t* cached = scale_map_find(width, height);
+    if (cached) {
+        return cached;
+    }
+    if (g_scale_maps_used == SCALE_MAP_CACHE) {
+        if (!g_scale_map_overflow_warned) {
+            ESP_LOGW(TAG, "⚠️ More than %d frame sizes: tables for %dx%d and later sizes are rebuilt on every "
+                     "size change (raise SCALE_MAP_CACHE)", SCALE_MAP_CACHE, width, height);
+            g_scale_map_overflow_warned = true;
+        }
+        return scale_map_for(width, height);
+    }
+    rgb565_scale_map_t* map = &g_scale_maps[g_scale_maps_used++];
+    scale_map_build(map, width, height);
+    ESP_LOGI(TAG, "📐 %dx%d frames %s to %dx%d", width, height, SCALE_FIT_MODE == 2 ? "fill" : "fit",
+             map->dst_w, map->dst_h);
+    return map;
+}
+#endif
+
+// Upscale the native frame band by band into the two DMA bounce buffers, sending each
+// band while the next one is generated. With a scale map, bands are map rows instead.
+static esp_err_t stream_upscaled_frame(const uint16_t *src, int src_w, int src_h, int factor,
+                                       const rgb565_scale_map_t *map, int x_offset, int y_offset)
+{
+    // Bands count source rows (each 'factor' output rows tall) or output rows of the map
+    const int unit = map ? 1 : factor;
+    const int dst_w = map ? map->dst_w : src_w * factor;
+    const int units = map ? map->dst_h : src_h;
+    int64_t fill_us = 0, submit_us = 0;
+    esp_err_t ret = ESP_OK;
+
+    // Preview factors make each source row tall, so fewer of them fit a band
+    int band_rows = UPSCALE_BAND_BUF_SIZE / (dst_w * unit * 2);
+    if (!map && band_rows > UPSCALE_BAND_SRC_ROWS) {
+        band_rows = UPSCALE_BAND_SRC_ROWS;
+    }
+
+    s_draw_start_us = esp_timer_get_time();
+    for (int sy = 0, band = 0; sy < units; sy += band_rows, band++) {
+        int rows = (units - sy < band_rows) ? units - sy : band_rows;
+        int b = band & 1;
+
+        // The bus must be done with this buffer's previous band before we overwrite it
+        ret = panel_wait_draw_done(g_band_seq[b], pdMS_TO_TICKS(100));
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "❌ Timed out waiting for band buffer %d", b);
+            break;
+        }
 
-            d_row0[dx] = d_row0[dx + 1] = d_row0[dx + 2] = pix;
-            d_row1[dx] = d_row1[dx + 1] = d_row1[dx + 2] = pix;
-            d_row2[dx] = d_row2[dx + 1] = d_row2[dx + 2] = pix;
+        int64_t fill_start = esp_timer_get_time();
+        SPAN_BEGIN(SPAN_SCALE, sy);
+        if (map) {
+            table_scale_rows_rgb565(src, g_band_bufs[b], map, sy, rows);
+        } else if (use_bilinear(factor, src_w)) {
+            bilinear_scale_2x_rgb565(src, g_band_bufs[b], src_w, src_h, sy, rows, true);
+        } else {
+            nn_scale_band_rgb565(src + sy * src_w, g_band_bufs[b], src_w, rows, factor);
+        }
+        SPAN_END(SPAN_SCALE, sy);
+        int64_t submit_start = esp_timer_get_time();
+        int dy = y_offset + sy * unit;
+        ret = panel_draw(x_offset, dy, x_offset + dst_w, dy + rows * unit, g_band_bufs[b], &g_band_seq[b]);
+        submit_us += esp_timer_get_time() - submit_start;
+        fill_us += submit_start - fill_start;
+        if (ret != ESP_OK) {
+            break;
         }
     }
+    s_frame_timing.scale_us = (uint32_t)fill_us;
+    s_frame_timing.spi_submit_us = (uint32_t)submit_us;
+    return ret;
 }
 #endif // UPSCALE_MODE switch
 
-// Function to decode and display JPEG image from a data buffer
-esp_err_t decode_and_display_jpeg(const uint8_t* jpeg_data, size_t jpeg_data_size, 
-                                  uint8_t* external_out_buffer, size_t external_out_buffer_size, 
-                                  uint8_t* external_work_buffer, size_t external_work_buffer_size) {
-    if (jpeg_data == NULL || jpeg_data_size == 0) {
-        ESP_LOGE(TAG, "❌ Invalid JPEG data pointer or size");
+// Integer upscale that fits the logical display: 2× for exact half-res, 3× if it fits, else 1.
+// With SCALE_FIT_MODE the fit/fill size in 'map' decides: k when that is exactly k× the frame,
+// else 0 (index-table scaler).
+static int pick_upscale_factor(int width, int height, const rgb565_scale_map_t* map)
+{
+#if UPSCALE_MODE >= 1 && SCALE_FIT_MODE
+    int k = map->dst_w / width;
+    return (k >= 1 && map->dst_w == width * k && map->dst_h == height * k) ? k : 0;
+#else
+    (void)map;
+    if (width * 2 == LOGICAL_DISPLAY_WIDTH && height * 2 == LOGICAL_DISPLAY_HEIGHT) {
+        return 2;
+    } else if (width * 3 <= LOGICAL_DISPLAY_WIDTH && height * 3 <= LOGICAL_DISPLAY_HEIGHT) {
+        return 3;
+    }
+    return 1;
+#endif
+}
+
+// Scrub previews are blown up as far as they fit (20×15 at 1/8 → 16×)
+static int pick_preview_factor(int width, int height)
+{
+    int fx = LOGICAL_DISPLAY_WIDTH / width, fy = LOGICAL_DISPLAY_HEIGHT / height;
+    int factor = fx < fy ? fx : fy;
+    return factor > 1 ? factor : 1;
+}
+
+// 32-bit FNV-1a, cheap enough to run over every frame at preload
+static uint32_t fnv1a_32(const uint8_t *data, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Length of the clip part of a frame name: up to the last '-', else the extension
+static int clip_name_len(const char *frame)
+{
+    const char *end = strrchr(frame, '-');
+    if (!end) {
+        end = strrchr(frame, '.');
+    }
+    return end ? (int)(end - frame) : (int)strlen(frame);
+}
+
+static bool clip_name_matches(const char *clip_name, const char *frame)
+{
+    int len = clip_name_len(frame);
+    if (len > CLIP_NAME_LEN - 1) {
+        len = CLIP_NAME_LEN - 1;
+    }
+    return (int)strlen(clip_name) == len && strncmp(clip_name, frame, len) == 0;
+}
+
+int image_display_clip_count(void)
+{
+    return g_num_clips;
+}
+
+const image_display_clip_t* image_display_clip(int index)
+{
+    return (index >= 0 && index < g_num_clips) ? &g_clips[index] : NULL;
+}
+
+int image_display_find_clip(const char* name)
+{
+    for (int c = 0; c < g_num_clips; c++) {
+        if (strcmp(g_clips[c].name, name) == 0) {
+            return c;
+        }
+    }
+    return -1;
+}
+
+esp_err_t image_display_select_clip(int index)
+{
+    if (index < -1 || index >= g_num_clips) {
         return ESP_ERR_INVALID_ARG;
     }
+    s_pending_clip = index;
+    return ESP_OK;
+}
+
+int image_display_current_clip(void)
+{
+    return s_current_clip;
+}
+
+// Frame size for either codec; Q565 frames (main/q565.h) are told apart from JPEG by their magic
+static esp_err_t frame_get_info(const uint8_t *data, size_t size, esp_jpeg_image_output_t *info)
+{
+    if (q565_is_frame(data, size)) {
+        uint16_t width = 0, height = 0;
+        esp_err_t ret = q565_get_info(data, size, &width, &height);
+        *info = (esp_jpeg_image_output_t){ .width = width, .height = height, .output_len = (size_t)width * height * 2 };
+        return ret;
+    }
+    esp_jpeg_image_cfg_t cfg = {
+        .indata = (uint8_t*)data,
+        .indata_size = size,
+        .out_format = JPEG_IMAGE_FORMAT_RGB565,
+    };
+    return esp_jpeg_get_image_info(&cfg, info);
+}
+
+// Per-frame scratch comes from the player's arena; only without one (boot image) do we touch the heap
+static void *decode_scratch_alloc(size_t size, bool *from_heap)
+{
+    if (g_frame_arena.base) {
+        *from_heap = false;
+        return frame_arena_alloc(&g_frame_arena, size);
+    }
+    void *p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    *from_heap = (p != NULL);
+    return p;
+}
+
+// Decode a JPEG or Q565 frame into 'outbuf' (panel byte order) and record the decode stage timings
+static esp_err_t decode_frame_pixels(const uint8_t* jpeg_data, size_t jpeg_data_size, bool is_q565,
+                                     uint8_t* outbuf, size_t outbuf_size, esp_jpeg_image_output_t* jpeg_info,
+                                     uint8_t* external_work_buffer, size_t external_work_buffer_size,
+                                     esp_jpeg_image_scale_t scale) {
+    if (is_q565) {
+        // Q565 needs no work pool and writes panel-order pixels directly
+        int64_t decode_start = esp_timer_get_time();
+        SPAN_BEGIN(SPAN_Q565_DECODE, 0);
+        esp_err_t ret = q565_decode(jpeg_data, jpeg_data_size, (uint16_t*)outbuf, outbuf_size / 2, true);
+        SPAN_END(SPAN_Q565_DECODE, 0);
+        s_frame_timing.decode_us = (uint32_t)(esp_timer_get_time() - decode_start);
+        return ret;
+    }
 
     esp_jpeg_image_cfg_t jpeg_cfg = {
         .indata = (uint8_t*)jpeg_data,  // Cast away const to match API
         .indata_size = jpeg_data_size,
-        .outbuf = NULL, 
-        .outbuf_size = 0,
+        .outbuf = outbuf,
+        .outbuf_size = outbuf_size,
         .out_format = JPEG_IMAGE_FORMAT_RGB565,
-        .out_scale = JPEG_IMAGE_SCALE_0,  // No scaling for maximum speed
+        .out_scale = scale,               // JPEG_IMAGE_SCALE_0 except for scrub previews
         .flags = { 
             .swap_color_bytes = 1         // BGR format for ILI9341
         },
@@ -173,91 +508,161 @@ esp_err_t decode_and_display_jpeg(const uint8_t* jpeg_data, size_t jpeg_data_siz
     if (external_work_buffer != NULL) {
         jpeg_cfg.advanced.working_buffer = external_work_buffer;
         jpeg_cfg.advanced.working_buffer_size = external_work_buffer_size;
+        // Hot tables and MCU buffers go to internal RAM when the player has a fast pool
+        if (g_fast_work_buf != NULL) {
+            jpeg_cfg.advanced.fast_working_buffer = g_fast_work_buf;
+            jpeg_cfg.advanced.fast_working_buffer_size = JPEG_FAST_WORK_BUFFER_SIZE;
+        }
+    }
+
+    // PERFORMANCE: Optimized decode with larger work buffers
+#if CONFIG_JD_PROFILE
+    esp_err_t ret = esp_jpeg_decode(&jpeg_cfg, jpeg_info);
+    s_frame_timing.prepare_us = jpeg_info->timing.prepare_us;
+    s_frame_timing.decode_us = jpeg_info->timing.mcu_load_us;
+    s_frame_timing.color_us = jpeg_info->timing.mcu_output_us;
+#else
+    // No stage stamps inside the decoder: the whole decode counts as decode_us
+    int64_t decode_start = esp_timer_get_time();
+    esp_err_t ret = esp_jpeg_decode(&jpeg_cfg, jpeg_info);
+    s_frame_timing.decode_us = (uint32_t)(esp_timer_get_time() - decode_start);
+#endif
+    return ret;
+}
+
+// Decode a frame and draw it; JPEG frames decode at 'scale' (scrub previews), Q565 always at full size.
+// 'decoded' skips the decode: the frame's pixels, already in panel byte order (lookahead ring).
+static esp_err_t decode_and_display_scaled(const uint8_t* jpeg_data, size_t jpeg_data_size,
+                                           uint8_t* external_out_buffer, size_t external_out_buffer_size,
+                                           uint8_t* external_work_buffer, size_t external_work_buffer_size,
+                                           esp_jpeg_image_scale_t scale, const uint16_t* decoded) {
+    if (jpeg_data == NULL || jpeg_data_size == 0) {
+        ESP_LOGE(TAG, "❌ Invalid JPEG data pointer or size");
+        return ESP_ERR_INVALID_ARG;
     }
 
+    memset(&s_frame_timing, 0, sizeof(s_frame_timing));
+    frame_arena_reset(&g_frame_arena);
+
+    bool is_q565 = q565_is_frame(jpeg_data, jpeg_data_size);
     esp_jpeg_image_output_t jpeg_info;
-    esp_err_t ret = esp_jpeg_get_image_info(&jpeg_cfg, &jpeg_info);
+    esp_err_t ret = frame_get_info(jpeg_data, jpeg_data_size, &jpeg_info);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "❌ Failed to get JPEG info");
+        ESP_LOGE(TAG, "❌ Failed to get %s info", is_q565 ? "Q565" : "JPEG");
         return ESP_ERR_INVALID_STATE;
     }
+    if (is_q565) {
+        scale = JPEG_IMAGE_SCALE_0;
+    }
+    jpeg_info.width >>= scale;   // The scale enum is the shift (1/2^scale)
+    jpeg_info.height >>= scale;
 
     uint8_t* outbuf_to_use = NULL;        // Buffer into which JPEG is decoded (could be small or full-size)
-    bool outbuf_allocated_internally = false;
-    int upscale_factor = 1; // 1 means no upscale
-    if (jpeg_info.width * 2 == LOGICAL_DISPLAY_WIDTH && jpeg_info.height * 2 == LOGICAL_DISPLAY_HEIGHT) {
-        upscale_factor = 2;
-    } else if (jpeg_info.width * 3 <= LOGICAL_DISPLAY_WIDTH && jpeg_info.height * 3 <= LOGICAL_DISPLAY_HEIGHT) {
-        upscale_factor = 3;
-    }
-    bool need_upscale = (upscale_factor > 1);
+    bool outbuf_from_heap = false;        // Only when no frame arena is set up (e.g. one-off boot image)
+#if UPSCALE_MODE >= 1 && SCALE_FIT_MODE
+    const rgb565_scale_map_t* fit_map = scale != JPEG_IMAGE_SCALE_0 ? NULL
+                                                                    : scale_map_for(jpeg_info.width, jpeg_info.height);
+#else
+    const rgb565_scale_map_t* fit_map = NULL;
+#endif
+    int upscale_factor = scale != JPEG_IMAGE_SCALE_0 ? pick_preview_factor(jpeg_info.width, jpeg_info.height)
+                                                     : pick_upscale_factor(jpeg_info.width, jpeg_info.height, fit_map); // 1 means no upscale
+    const rgb565_scale_map_t* scale_map = upscale_factor == 0 ? fit_map : NULL;
+    bool need_upscale = (upscale_factor > 1) || scale_map;   // Including fit/fill downscales
 
     size_t actual_outbuf_size_needed = (size_t)jpeg_info.width * jpeg_info.height * 2; // Size for decoded image
 
-    if (need_upscale) {
-        // Allocate a *small* temporary buffer for decode
-        outbuf_to_use = heap_caps_malloc(actual_outbuf_size_needed, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#if UPSCALE_MODE >= 1 && STREAM_UPSCALE_TO_DMA
+    // Streamed upscale only needs the native frame; without band buffers fall back to a full-size frame
+    bool stream_upscale = need_upscale && g_band_bufs[0] != NULL &&
+                          (scale_map ? (size_t)scale_map->dst_w * 2
+                                     : (size_t)jpeg_info.width * upscale_factor * upscale_factor * 2) <= UPSCALE_BAND_BUF_SIZE;
+#else
+    bool stream_upscale = false;
+#endif
+    if (need_upscale && !stream_upscale && external_out_buffer == NULL) {
+        ESP_LOGE(TAG, "❌ No output buffer for the upscaled frame");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (decoded) {
+        // Drawn (or upscaled) straight from the ring slot
+        outbuf_to_use = (uint8_t*)decoded;
+    } else if (need_upscale || external_out_buffer == NULL) {
+        // Small temporary decode buffer (upscale) or fallback full-size output buffer
+        outbuf_to_use = decode_scratch_alloc(actual_outbuf_size_needed, &outbuf_from_heap);
         if (!outbuf_to_use) {
-            ESP_LOGE(TAG, "❌ Failed to allocate temp decode buffer");
+            ESP_LOGE(TAG, "❌ Failed to get %s buffer (%lu bytes)", need_upscale ? "temp decode" : "output",
+                     (unsigned long)actual_outbuf_size_needed);
             return ESP_ERR_NO_MEM;
         }
-        outbuf_allocated_internally = true;
-        jpeg_cfg.outbuf = outbuf_to_use;
-        jpeg_cfg.outbuf_size = actual_outbuf_size_needed;
     } else {
-        // Decode straight into external_out_buffer (or allocate fallback)
-        if (external_out_buffer != NULL) {
-            if (actual_outbuf_size_needed > external_out_buffer_size) {
-                ESP_LOGE(TAG, "❌ External buffer too small. Need: %lu, Have: %lu", 
-                         (unsigned long)actual_outbuf_size_needed, (unsigned long)external_out_buffer_size);
-                return ESP_ERR_NO_MEM;
-            }
-            outbuf_to_use = external_out_buffer;
-            jpeg_cfg.outbuf = outbuf_to_use;
-            jpeg_cfg.outbuf_size = actual_outbuf_size_needed;
-        } else {
-            // Fallback full-size allocate
-            outbuf_to_use = heap_caps_malloc(actual_outbuf_size_needed, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-            if (!outbuf_to_use) {
-                ESP_LOGE(TAG, "❌ Failed to allocate output buffer");
-                return ESP_ERR_NO_MEM;
-            }
-            outbuf_allocated_internally = true;
-            jpeg_cfg.outbuf = outbuf_to_use;
-            jpeg_cfg.outbuf_size = actual_outbuf_size_needed;
+        // Decode straight into external_out_buffer
+        if (actual_outbuf_size_needed > external_out_buffer_size) {
+            ESP_LOGE(TAG, "❌ External buffer too small. Need: %lu, Have: %lu", 
+                     (unsigned long)actual_outbuf_size_needed, (unsigned long)external_out_buffer_size);
+            return ESP_ERR_NO_MEM;
         }
+        outbuf_to_use = external_out_buffer;
+    }
+
+    if (!decoded) {
+        ret = decode_frame_pixels(jpeg_data, jpeg_data_size, is_q565, outbuf_to_use, actual_outbuf_size_needed,
+                                  &jpeg_info, external_work_buffer, external_work_buffer_size, scale);
     }
 
-    // PERFORMANCE: Optimized decode with larger work buffers
-    ret = esp_jpeg_decode(&jpeg_cfg, &jpeg_info);
-    
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "❌ JPEG decode failed");
-        if (outbuf_allocated_internally) {
-            free(outbuf_to_use);
+        ESP_LOGE(TAG, "❌ %s decode failed", is_q565 ? "Q565" : "JPEG");
+        if (outbuf_from_heap) {
+            heap_caps_free(outbuf_to_use);
         }
         return ESP_FAIL;
     }
 
     // Apply optional up-scale
-#if UPSCALE_MODE == 1
+#if UPSCALE_MODE >= 1
+    if (stream_upscale) {
+        int dst_w = scale_map ? scale_map->dst_w : jpeg_info.width * upscale_factor;
+        int dst_h = scale_map ? scale_map->dst_h : jpeg_info.height * upscale_factor;
+        ret = stream_upscaled_frame((const uint16_t*)outbuf_to_use, jpeg_info.width, jpeg_info.height, upscale_factor,
+                                    scale_map, (LOGICAL_DISPLAY_WIDTH - dst_w) / 2, (LOGICAL_DISPLAY_HEIGHT - dst_h) / 2);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "❌ Failed to display image");
+        }
+        if (outbuf_from_heap) {
+            heap_caps_free(outbuf_to_use);
+        }
+        return ret;
+    }
     if (need_upscale) {
-        if (upscale_factor == 2) {
+        int64_t scale_start = esp_timer_get_time();
+        SPAN_BEGIN(SPAN_SCALE, 0);
+        if (scale_map) {
+            table_scale_rows_rgb565((uint16_t*)outbuf_to_use, (uint16_t*)external_out_buffer, scale_map,
+                                    0, scale_map->dst_h);
+        } else if (use_bilinear(upscale_factor, jpeg_info.width)) {
+            bilinear_scale_2x_rgb565((uint16_t*)outbuf_to_use, (uint16_t*)external_out_buffer,
+                                     jpeg_info.width, jpeg_info.height, 0, jpeg_info.height, true);
+        } else if (upscale_factor == 2) {
             nn_scale_2x_rgb565((uint16_t*)outbuf_to_use, (uint16_t*)external_out_buffer,
                                jpeg_info.width, jpeg_info.height);
         } else if (upscale_factor == 3) {
             nn_scale_3x_rgb565((uint16_t*)outbuf_to_use, (uint16_t*)external_out_buffer,
                                jpeg_info.width, jpeg_info.height);
+        } else {
+            nn_scale_band_rgb565((uint16_t*)outbuf_to_use, (uint16_t*)external_out_buffer,
+                                 jpeg_info.width, jpeg_info.height, upscale_factor);
         }
-        // After scaling we can free temp buffer
-        if (outbuf_allocated_internally && outbuf_to_use) {
-            free(outbuf_to_use);
-            outbuf_to_use = NULL;
-            outbuf_allocated_internally = false;
+        SPAN_END(SPAN_SCALE, 0);
+        s_frame_timing.scale_us = (uint32_t)(esp_timer_get_time() - scale_start);
+        // After scaling we can release the temp buffer (arena memory is reclaimed on the next frame)
+        if (outbuf_from_heap) {
+            heap_caps_free(outbuf_to_use);
+            outbuf_from_heap = false;
         }
         // Now pretend the image is full screen for the draw call
-        jpeg_info.width = jpeg_info.width * upscale_factor;
-        jpeg_info.height = jpeg_info.height * upscale_factor;
+        jpeg_info.width = scale_map ? scale_map->dst_w : jpeg_info.width * upscale_factor;
+        jpeg_info.height = scale_map ? scale_map->dst_h : jpeg_info.height * upscale_factor;
         outbuf_to_use = external_out_buffer;
     }
 #endif
@@ -273,95 +678,56 @@ esp_err_t decode_and_display_jpeg(const uint8_t* jpeg_data, size_t jpeg_data_siz
         y_offset = (LOGICAL_DISPLAY_HEIGHT - jpeg_info.height) / 2;
     }
 
-    ret = esp_lcd_panel_draw_bitmap(panel_handle,
-                                    x_offset,
-                                    y_offset,
-                                    x_offset + jpeg_info.width,
-                                    y_offset + jpeg_info.height,
-                                    outbuf_to_use);
-    
+    s_draw_start_us = esp_timer_get_time();
+    ret = panel_draw(x_offset,
+                     y_offset,
+                     x_offset + jpeg_info.width,
+                     y_offset + jpeg_info.height,
+                     outbuf_to_use, NULL);
+    s_frame_timing.spi_submit_us = (uint32_t)(esp_timer_get_time() - s_draw_start_us);
+
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "❌ Failed to display image");
     }
 
-    if (outbuf_allocated_internally && outbuf_to_use) {
-        free(outbuf_to_use);
+    if (outbuf_from_heap) {
+        heap_caps_free(outbuf_to_use);
     }
     return ret;
 }
 
-// Initialize SPIFFS
-esp_err_t init_spiffs(void) {
-    ESP_LOGI(TAG, "📁 Initializing SPIFFS...");
-    
-    esp_vfs_spiffs_conf_t conf = {
-        .base_path = "/spiffs",
-        .partition_label = "storage",
-        .max_files = 5,
-        .format_if_mount_failed = true
-    };
-    
-    esp_err_t ret = esp_vfs_spiffs_register(&conf);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize SPIFFS (%s)", esp_err_to_name(ret));
-        return ret;
-    }
-    
-    size_t total = 0, used = 0;
-    ret = esp_spiffs_info("storage", &total, &used);
-    if (ret == ESP_OK) {
-        ESP_LOGI(TAG, "📊 SPIFFS: total: %lu, used: %lu, free: %lu (%d%% used)", 
-                 (unsigned long)total, (unsigned long)used, (unsigned long)(total - used), (int)((used * 100) / total));
-    }
-    
-    return ESP_OK;
+// Function to decode and display JPEG image from a data buffer
+esp_err_t decode_and_display_jpeg(const uint8_t* jpeg_data, size_t jpeg_data_size,
+                                  uint8_t* external_out_buffer, size_t external_out_buffer_size,
+                                  uint8_t* external_work_buffer, size_t external_work_buffer_size) {
+    return decode_and_display_scaled(jpeg_data, jpeg_data_size, external_out_buffer, external_out_buffer_size,
+                                     external_work_buffer, external_work_buffer_size, JPEG_IMAGE_SCALE_0, NULL);
 }
 
 // Load and display raw RGB565 image
 esp_err_t load_and_display_raw_image(const char* filename) {
     ESP_LOGI(TAG, "🖼️  Loading raw RGB565 image: %s", filename);
     
-    // Check if file exists
-    struct stat st;
-    if (stat(filename, &st) != 0) {
-        ESP_LOGE(TAG, "❌ File not found: %s", filename);
-        return ESP_ERR_NOT_FOUND;
+    // Read the whole file from the frame source
+    uint8_t* file_data = NULL;
+    size_t file_size = 0;
+    esp_err_t load_ret = frame_source_load(filename, MALLOC_CAP_8BIT, &file_data, &file_size);
+    if (load_ret != ESP_OK) {
+        ESP_LOGE(TAG, "❌ Failed to load %s: %s", filename, esp_err_to_name(load_ret));
+        return load_ret;
     }
+    uint16_t* image_data = (uint16_t*)file_data;
     
-    ESP_LOGI(TAG, "📄 File size: %lld bytes", (long long)st.st_size);
+    ESP_LOGI(TAG, "📄 File size: %lu bytes", (unsigned long)file_size);
     
     // Calculate total pixels from file size (RGB565: 2 bytes per pixel)
-    size_t total_pixels = st.st_size / 2;
+    size_t total_pixels = file_size / 2;
     ESP_LOGI(TAG, "📐 Image contains %lu pixels", (unsigned long)total_pixels);
     
-    // Allocate buffer for image data
-    uint16_t* image_data = malloc(st.st_size);
-    if (image_data == NULL) {
-        ESP_LOGE(TAG, "❌ Failed to allocate memory for image data");
-        return ESP_ERR_NO_MEM;
-    }
-    
-    // Read file
-    FILE* f = fopen(filename, "rb");
-    if (f == NULL) {
-        ESP_LOGE(TAG, "❌ Failed to open file");
-        free(image_data);
-        return ESP_ERR_NOT_FOUND;
-    }
-    
-    size_t bytes_read = fread(image_data, 1, st.st_size, f);
-    fclose(f);
-    
-    if (bytes_read != st.st_size) {
-        ESP_LOGE(TAG, "❌ Failed to read complete file");
-        free(image_data);
-        return ESP_ERR_INVALID_SIZE;
-    }
-    
     ESP_LOGI(TAG, "✅ Image loaded successfully, displaying...");
     
     // Display the image with correct BGR endian (no color swapping needed!)
-    esp_err_t ret = esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, LCD_H_RES, LCD_V_RES, image_data);
+    esp_err_t ret = panel_draw(0, 0, LCD_H_RES, LCD_V_RES, image_data, NULL);
     
     if (ret == ESP_OK) {
         ESP_LOGI(TAG, "🎉 Image displayed successfully with correct colors!");
@@ -370,7 +736,7 @@ esp_err_t load_and_display_raw_image(const char* filename) {
     }
     
     // Cleanup
-    free(image_data);
+    heap_caps_free(image_data);
     
     return ret;
 }
@@ -411,7 +777,7 @@ void create_test_pattern(void) {
     }
     
     // Display the pattern
-    esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, LCD_H_RES, LCD_V_RES, pattern);
+    panel_draw(0, 0, LCD_H_RES, LCD_V_RES, pattern, NULL);
     
     free(pattern);
     ESP_LOGI(TAG, "✅ Test pattern displayed!");
@@ -421,15 +787,15 @@ void create_test_pattern(void) {
 void image_display_main(void) {
     ESP_LOGI(TAG, "🚀 Starting T4 Image Display Demo!");
     
-    // Initialize SPIFFS (LCD is already initialized by main.c)
-    ESP_ERROR_CHECK(init_spiffs());
+    // Mount frame storage (LCD is already initialized by main.c)
+    ESP_ERROR_CHECK(frame_source_init(NULL));
     
     // Create a test pattern first
     create_test_pattern();
     vTaskDelay(pdMS_TO_TICKS(2000));
     
     // Try to load and display your image
-    esp_err_t ret = load_and_display_raw_image("/spiffs/images/image.rgb565");
+    esp_err_t ret = load_and_display_raw_image("images/image.rgb565");
     if (ret == ESP_OK) {
         ESP_LOGI(TAG, "🎉 Image displayed successfully with correct colors!");
         ESP_LOGI(TAG, "✅ BGR endian fix worked! No more color swapping needed!");
@@ -453,40 +819,301 @@ void image_display_main(void) {
 // Define buffer sizes for manifest processing
 #define MAX_FILENAME_LEN 256 
 #define MANIFEST_LINE_BUFFER_SIZE (MAX_FILENAME_LEN + 64)
-#define MAX_PATH_LEN (MAX_FILENAME_LEN + 16) // Enough space for "/spiffs/" prefix and some extra
+#define MAX_PATH_LEN (MAX_FILENAME_LEN + 64) // Frame name plus the manifest's directory ("output/")
 #define JPEG_WORK_BUFFER_SIZE_ALLOC 65472  // Required for JD_FASTDECODE=2 (table-based fast decode)
 
-// Performance optimization: Use internal RAM for critical buffers when possible
-#define USE_INTERNAL_RAM_FOR_WORK_BUFFER 0  // Disabled because 65KB won't fit in internal RAM
+// Performance optimization: the 65KB pool won't fit in internal RAM, but its hot part does
+#define USE_INTERNAL_RAM_FOR_FAST_WORK_BUFFER 1  // Split pool: JPEG_FAST_WORK_BUFFER_SIZE in DRAM, rest in PSRAM
+
+// Copy the next manifest line into 'line' without CR/LF; false at the end of the manifest
+static bool manifest_next_line(const char** cursor, const char* end, char* line, size_t line_size)
+{
+    if (*cursor >= end) {
+        return false;
+    }
+    const char* eol = memchr(*cursor, '\n', end - *cursor);
+    size_t len = (eol ? eol : end) - *cursor;
+    size_t copy = len < line_size - 1 ? len : line_size - 1;
+    memcpy(line, *cursor, copy);
+    line[copy] = 0;
+    line[strcspn(line, "\r")] = 0;
+    *cursor = eol ? eol + 1 : end;
+    return true;
+}
+
+typedef struct {
+    const uint8_t* data;         // Frame data decoded into this slot, NULL = empty
+    uint16_t* pixels;            // Native-size RGB565, panel byte order
+    uint32_t draw_seq;           // Last draw that read from the slot
+    perf_frame_record_t timing;  // Decode stages, reported when the frame is shown
+} lookahead_slot_t;
+
+static lookahead_slot_t g_lookahead[LOOKAHEAD_MAX_SLOTS];
+static int g_lookahead_slots = 0;
+static size_t g_lookahead_slot_size = 0;
+static uint32_t g_lookahead_cost_us = 0;   // Estimate of one decode: follows rises at once, decays slowly
+static uint16_t* g_blend_buf = NULL;       // In-between frame, native size (CONFIG_T4_TEMPORAL_BLEND)
+static uint32_t g_blend_seq = 0;           // Last draw that read from g_blend_buf
+
+// Fill in when the frame's colour transfer finished, then hand the record to telemetry
+static void commit_frame_record(perf_frame_record_t* rec, int64_t draw_start)
+{
+    // By now the colour transfer of this frame has normally finished
+    // (wrap-safe: the stamps are the low 32 bits of esp_timer_get_time())
+    uint32_t since_start = s_color_done_us - (uint32_t)draw_start;
+    if (rec->spi_submit_us && (int32_t)since_start >= 0) {
+        rec->spi_complete_us = since_start;
+    } else if (rec->spi_submit_us) {
+        rec->flags |= PERF_FLAG_SPI_PENDING;
+    }
+    perf_telemetry_commit(rec);
+    perf_telemetry_poll();
+}
+
+static void lookahead_free(void)
+{
+    if (g_lookahead_slots) {
+        panel_wait_draw_done(s_draws_submitted, pdMS_TO_TICKS(500));
+    }
+    for (int s = 0; s < g_lookahead_slots; s++) {
+        heap_caps_free(g_lookahead[s].pixels);
+    }
+    memset(g_lookahead, 0, sizeof(g_lookahead));
+    g_lookahead_slots = 0;
+    g_lookahead_slot_size = 0;
+}
+
+// Split LOOKAHEAD_PSRAM_BUDGET into slots of 'frame_len' bytes; fewer than two slots is not worth it
+static void lookahead_init(size_t frame_len)
+{
+    size_t slots = frame_len ? LOOKAHEAD_PSRAM_BUDGET / frame_len : 0;
+    if (slots > LOOKAHEAD_MAX_SLOTS) {
+        slots = LOOKAHEAD_MAX_SLOTS;
+    }
+    for (size_t s = 0; s < slots; s++) {
+        g_lookahead[s].pixels = heap_caps_malloc(frame_len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!g_lookahead[s].pixels) {
+            break;
+        }
+        g_lookahead[s].draw_seq = s_draws_submitted;
+        g_lookahead_slots++;
+    }
+    g_lookahead_slot_size = frame_len;
+    if (g_lookahead_slots < 2) {
+        lookahead_free();
+        ESP_LOGI(TAG, "🔭 Lookahead off (%lu byte budget, %lu byte frames)", (unsigned long)LOOKAHEAD_PSRAM_BUDGET,
+                 (unsigned long)frame_len);
+        return;
+    }
+    ESP_LOGI(TAG, "🔭 Lookahead ring: %d x %lu bytes", g_lookahead_slots, (unsigned long)frame_len);
+}
+
+static lookahead_slot_t* lookahead_find(const uint8_t* data)
+{
+    for (int s = 0; s < g_lookahead_slots; s++) {
+        if (g_lookahead[s].data == data) {
+            return &g_lookahead[s];
+        }
+    }
+    return NULL;
+}
+
+static int lookahead_next(int i, int begin, int end)
+{
+    return i + 1 < end ? i + 1 : begin;
+}
+
+// Whether 'data' is among the frames the ring covers after frame 'cur'
+static bool lookahead_wanted(const uint8_t* data, int cur, int begin, int end)
+{
+    int f = cur;
+    for (int k = 0; k < g_lookahead_slots; k++) {
+        f = lookahead_next(f, begin, end);
+        if (g_preloaded_frames[f].data == data) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Decode the frames after 'cur' (wrapping within [begin, end)) into the ring while another
+// decode still fits before 'deadline_us'. Frames on screen or already in the ring are skipped.
+static void lookahead_fill(int cur, int begin, int end, int64_t deadline_us)
+{
+    int f = cur;
+    for (int k = 0; k < g_lookahead_slots; k++) {
+        f = lookahead_next(f, begin, end);
+        if (f == cur) {
+            break;  // Clip shorter than the ring
+        }
+        const uint8_t* data = g_preloaded_frames[f].data;
+        size_t size = g_preloaded_frames[f].size;
+        if (data == g_shown_frame_data || lookahead_find(data)) {
+            continue;
+        }
+        int64_t start = esp_timer_get_time();
+        if (start + g_lookahead_cost_us > deadline_us) {
+            break;
+        }
+        lookahead_slot_t* slot = NULL;
+        for (int s = 0; s < g_lookahead_slots && !slot; s++) {
+            // The frame on screen stays too: in-betweens are mixed from it
+            if (!g_lookahead[s].data || (g_lookahead[s].data != g_shown_frame_data &&
+                                         !lookahead_wanted(g_lookahead[s].data, cur, begin, end))) {
+                slot = &g_lookahead[s];
+            }
+        }
+        if (!slot || panel_wait_draw_done(slot->draw_seq, pdMS_TO_TICKS(100)) != ESP_OK) {
+            break;
+        }
+        esp_jpeg_image_output_t info;
+        bool is_q565 = q565_is_frame(data, size);
+        if (frame_get_info(data, size, &info) != ESP_OK || info.output_len > g_lookahead_slot_size) {
+            continue;
+        }
+        memset(&s_frame_timing, 0, sizeof(s_frame_timing));
+        slot->data = NULL;
+        if (decode_frame_pixels(data, size, is_q565, (uint8_t*)slot->pixels, info.output_len, &info,
+                                g_common_work_buf, JPEG_WORK_BUFFER_SIZE_ALLOC, JPEG_IMAGE_SCALE_0) == ESP_OK) {
+            slot->data = data;
+            slot->timing = s_frame_timing;
+        }
+        uint32_t cost = (uint32_t)(esp_timer_get_time() - start);
+        g_lookahead_cost_us = cost > g_lookahead_cost_us ? cost : (3 * g_lookahead_cost_us + cost) / 4;
+    }
+}
+
+#if CONFIG_T4_TEMPORAL_BLEND
+// Draw in-betweens of frame 'cur' (on screen since 'frame_start') and the next frame of its clip,
+// evenly spaced over 'delay_ms'. Each one first paces and commits the record of what it replaces;
+// the last one's record is left in 'rec' and 'draw_start' for the caller to pace and commit.
+static void blend_in_betweens(int cur, int begin, int end, int64_t frame_start, uint32_t delay_ms,
+                              perf_frame_record_t* rec, int64_t* draw_start)
+{
+    int steps = (int)(delay_ms / BLEND_INTERVAL_MS) - 1;
+    if (steps > BLEND_MAX_STEPS) {
+        steps = BLEND_MAX_STEPS;
+    }
+    const preloaded_jpeg_frame_t* a = &g_preloaded_frames[cur];
+    const preloaded_jpeg_frame_t* b = &g_preloaded_frames[lookahead_next(cur, begin, end)];
+    esp_jpeg_image_output_t info_a, info_b;
+    if (steps < 1 || !g_blend_buf || a->data != g_shown_frame_data || b->data == a->data || b->clip != a->clip ||
+        frame_get_info(a->data, a->size, &info_a) != ESP_OK || frame_get_info(b->data, b->size, &info_b) != ESP_OK ||
+        info_a.width != info_b.width || info_a.height != info_b.height) {
+        return;
+    }
+
+    int64_t step_us = (int64_t)delay_ms * 1000 / (steps + 1);
+    bool blended = false;
+    for (int k = 1; k <= steps; k++) {
+        int64_t due = frame_start + step_us * k;
+        lookahead_fill(cur, begin, end, due - LOOKAHEAD_MARGIN_US);
+        lookahead_slot_t* sa = lookahead_find(a->data);
+        lookahead_slot_t* sb = lookahead_find(b->data);
+        if (!sa || !sb || panel_wait_draw_done(g_blend_seq, pdMS_TO_TICKS(100)) != ESP_OK) {
+            break;  // The next frame did not fit in the slack: hold what is on screen
+        }
+        int64_t blend_start = esp_timer_get_time();
+        rgb565_blend(sa->pixels, sb->pixels, g_blend_buf, (size_t)info_a.width * info_a.height,
+                     RGB565_BLEND_ONE * k / (steps + 1), true);
+        uint32_t blend_us = (uint32_t)(esp_timer_get_time() - blend_start);
+
+        int64_t sleep_start = esp_timer_get_time();
+        SPAN_BEGIN(SPAN_SLEEP, cur);
+        if (due - sleep_start >= 1000) {
+            vTaskDelay(pdMS_TO_TICKS((uint32_t)((due - sleep_start) / 1000)));
+        }
+        SPAN_END(SPAN_SLEEP, cur);
+        rec->sleep_us = (uint32_t)(esp_timer_get_time() - sleep_start);
+        commit_frame_record(rec, *draw_start);
+
+        esp_err_t ret = decode_and_display_scaled(a->data, a->size, g_common_out_buf,
+                                                  LOGICAL_DISPLAY_WIDTH * LOGICAL_DISPLAY_HEIGHT * 2,
+                                                  g_common_work_buf, JPEG_WORK_BUFFER_SIZE_ALLOC,
+                                                  JPEG_IMAGE_SCALE_0, g_blend_buf);
+        g_blend_seq = s_draws_submitted;
+        *rec = s_frame_timing;
+        rec->frame_index = (uint32_t)cur;
+        rec->decode_us = blend_us;
+        rec->flags |= PERF_FLAG_BLEND | (ret != ESP_OK ? PERF_FLAG_DECODE_ERROR : 0);
+        *draw_start = s_draw_start_us;
+        blended = true;
+        if (ret != ESP_OK) {
+            break;
+        }
+    }
+    // The screen now shows a mix, which is no frame's data
+    if (blended) {
+        g_shown_frame_data = NULL;
+    }
+}
+#endif
+
+// Knob wiggles step to the next or previous clip, from frame 'i''s clip when none is selected
+static void take_wiggle_clip_steps(int i)
+{
+    int clip_steps = speed_control_take_clip_steps();
+    if (clip_steps) {
+        int from = s_current_clip >= 0 ? s_current_clip : g_preloaded_frames[i].clip;
+        image_display_select_clip(((from + clip_steps) % g_num_clips + g_num_clips) % g_num_clips);
+    }
+}
 
 esp_err_t play_jpeg_sequence_from_manifest(const char* manifest_path, uint32_t frame_delay_ms) {
     ESP_LOGI(TAG, "🎬 Playing JPEG sequence from manifest: %s (OPTIMIZED PSRAM preloading)", manifest_path);
     esp_err_t overall_ret = ESP_OK;
 
+    // Every wait on a draw (band buffers, lookahead slots, blends, cleanup) blocks on this
+    if (!s_trans_done_sem) {
+        s_trans_done_sem = xSemaphoreCreateBinary();
+        if (!s_trans_done_sem) {
+            ESP_LOGE(TAG, "❌ Failed to create the draw completion semaphore");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
     // If frames aren't loaded yet, load them
     if (!g_frames_loaded) {
         int num_frames = 0;
         size_t total_jpeg_data_size = 0;
 
+#if STORAGE_BENCH_PASSES > 0
+        storage_bench_run(manifest_path, STORAGE_BENCH_PASSES);
+#endif
+
         // Phase 1: Scan manifest for frame count and total size
         ESP_LOGI(TAG, "🔍 Scanning manifest...");
-        FILE* f = fopen(manifest_path, "r");
-        if (f == NULL) {
+        uint8_t* manifest = NULL;
+        size_t manifest_len = 0;
+        if (frame_source_load(manifest_path, MALLOC_CAP_8BIT, &manifest, &manifest_len) != ESP_OK) {
             ESP_LOGE(TAG, "❌ Failed to open manifest file: %s", manifest_path);
             return ESP_ERR_NOT_FOUND;
         }
+        const char* manifest_end = (const char*)manifest + manifest_len;
+        const char* cursor = (const char*)manifest;
+
+        // Frame names in the manifest are relative to its directory
+        const char* manifest_slash = strrchr(manifest_path, '/');
+        int manifest_dir_len = manifest_slash ? (int)(manifest_slash - manifest_path + 1) : 0;
 
         char line_buffer[MANIFEST_LINE_BUFFER_SIZE];
         char image_path[MAX_PATH_LEN]; 
         int line_count = 0;
 
-        while (fgets(line_buffer, sizeof(line_buffer), f) != NULL) {
-            // Yield every 10 lines for system stability (watchdog disabled)
-            if (++line_count % 10 == 0) {
+        // Clips are runs of frames sharing a name prefix; counted here, indexed in phase 3
+        int num_clips = 0;
+        char last_clip[CLIP_NAME_LEN] = "";
+
+        // Contiguous backends (pack) can preload the whole run of frames with one bulk read
+        bool bulk = true;
+        uint32_t region_start = UINT32_MAX, region_end = 0;
+
+        while (manifest_next_line(&cursor, manifest_end, line_buffer, sizeof(line_buffer))) {
+            // Yield every 10 lines for system stability (watchdog disabled); pack lookups are RAM only
+            if (!bulk && ++line_count % 10 == 0) {
                 vTaskDelay(1);
             }
 
-            line_buffer[strcspn(line_buffer, "\r\n")] = 0;
             if (strlen(line_buffer) == 0) continue;
 
             // Extract filename (first token) and optional size (second token)
@@ -502,14 +1129,22 @@ esp_err_t play_jpeg_sequence_from_manifest(const char* manifest_path, uint32_t f
                 continue;
             }
 
-            int written = snprintf(image_path, sizeof(image_path), "/spiffs/output/%s", filename_only);
+            int written = snprintf(image_path, sizeof(image_path), "%.*s%s", manifest_dir_len, manifest_path, filename_only);
             if (written < 0 || written >= sizeof(image_path)) {
                 ESP_LOGW(TAG, "⚠️ Path truncation, skipping: %s", filename_only);
                 continue;
             }
 
             size_t sz = 0;
-            if (file_size_hint > 0) {
+            uint32_t frame_offset = 0, frame_size = 0;
+            if (bulk && frame_source_locate(image_path, &frame_offset, &frame_size) != ESP_OK) {
+                bulk = false;
+            }
+            if (bulk) {
+                sz = frame_size;
+                if (frame_offset < region_start) region_start = frame_offset;
+                if (frame_offset + frame_size > region_end) region_end = frame_offset + frame_size;
+            } else if (file_size_hint > 0) {
                 sz = file_size_hint;
             } else {
                 unsigned long sz_temp = 0;
@@ -517,9 +1152,9 @@ esp_err_t play_jpeg_sequence_from_manifest(const char* manifest_path, uint32_t f
                     sz = sz_temp;
                 } else {
                     // No size column; stat the file to determine size
-                    struct stat st;
-                    if (stat(image_path, &st) == 0 && st.st_size > 0) {
-                        sz = st.st_size;
+                    size_t st_size = 0;
+                    if (frame_source_stat(image_path, &st_size) == ESP_OK && st_size > 0) {
+                        sz = st_size;
                     }
                 }
             }
@@ -527,138 +1162,213 @@ esp_err_t play_jpeg_sequence_from_manifest(const char* manifest_path, uint32_t f
             if (sz > 0) {
                 total_jpeg_data_size += sz;
                 num_frames++;
+                if (num_clips == 0 || !clip_name_matches(last_clip, filename_only)) {
+                    snprintf(last_clip, sizeof(last_clip), "%.*s", clip_name_len(filename_only), filename_only);
+                    num_clips++;
+                }
             }
         }
-        fclose(f);
 
         if (num_frames == 0) {
             ESP_LOGE(TAG, "❌ No valid frames found in manifest");
+            heap_caps_free(manifest);
             return ESP_ERR_NOT_FOUND;
         }
 
+        // A bulk read only pays off when the run holds little besides these frames (entry padding)
+        size_t region_len = bulk ? region_end - region_start : 0;
+        if (bulk && region_len > total_jpeg_data_size + (size_t)num_frames * 4) {
+            bulk = false;
+        }
+        size_t preload_size = bulk ? region_len : total_jpeg_data_size;
+
         // Phase 2: Allocate buffers if not already allocated
-        ESP_LOGI(TAG, "🧠 Allocating buffers for %d frames (%lu bytes)...", num_frames, (unsigned long)total_jpeg_data_size);
+        ESP_LOGI(TAG, "🧠 Allocating buffers for %d frames (%lu bytes)...", num_frames, (unsigned long)preload_size);
         
         g_preloaded_frames = (preloaded_jpeg_frame_t*)malloc(num_frames * sizeof(preloaded_jpeg_frame_t));
-        if (!g_preloaded_frames) {
+        g_clips = (image_display_clip_t*)malloc(num_clips * sizeof(image_display_clip_t));
+        if (!g_preloaded_frames || !g_clips) {
             ESP_LOGE(TAG, "❌ Failed to allocate frame info array");
+            free(g_preloaded_frames);
+            free(g_clips);
+            g_preloaded_frames = NULL;
+            g_clips = NULL;
+            heap_caps_free(manifest);
             return ESP_ERR_NO_MEM;
         }
 
-        g_all_jpeg_data_psram = heap_caps_malloc(total_jpeg_data_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        g_all_jpeg_data_psram = heap_caps_malloc(preload_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
         if (!g_all_jpeg_data_psram) {
             ESP_LOGE(TAG, "❌ Failed to allocate PSRAM for JPEG data");
             free(g_preloaded_frames);
+            free(g_clips);
             g_preloaded_frames = NULL;
+            g_clips = NULL;
+            heap_caps_free(manifest);
             return ESP_ERR_NO_MEM;
         }
 
-        size_t common_out_buf_size = LOGICAL_DISPLAY_WIDTH * LOGICAL_DISPLAY_HEIGHT * 2;
-        g_common_out_buf = heap_caps_malloc(common_out_buf_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-        if (!g_common_out_buf) {
-            ESP_LOGE(TAG, "❌ Failed to allocate output buffer");
+        g_common_work_buf = heap_caps_malloc(JPEG_WORK_BUFFER_SIZE_ALLOC, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!g_common_work_buf) {
+            ESP_LOGE(TAG, "❌ Failed to allocate work buffer");
             free(g_preloaded_frames);
+            free(g_clips);
             heap_caps_free(g_all_jpeg_data_psram);
             g_preloaded_frames = NULL;
+            g_clips = NULL;
             g_all_jpeg_data_psram = NULL;
+            heap_caps_free(manifest);
             return ESP_ERR_NO_MEM;
         }
 
-        // PERFORMANCE BOOST: Use internal RAM for work buffer if possible for faster access
-#if USE_INTERNAL_RAM_FOR_WORK_BUFFER
-        g_common_work_buf = heap_caps_malloc(JPEG_WORK_BUFFER_SIZE_ALLOC, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
-        if (!g_common_work_buf) {
-            // Fallback to regular malloc if internal RAM is full
-            g_common_work_buf = malloc(JPEG_WORK_BUFFER_SIZE_ALLOC);
+        // PERFORMANCE BOOST: Hot tables and MCU buffers in internal RAM; tjpgd falls back to the bulk pool without it
+#if USE_INTERNAL_RAM_FOR_FAST_WORK_BUFFER
+        g_fast_work_buf = heap_caps_malloc(JPEG_FAST_WORK_BUFFER_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (!g_fast_work_buf) {
+            ESP_LOGW(TAG, "⚠️ No internal RAM for the fast work pool, using PSRAM only");
         }
-#else
-        g_common_work_buf = malloc(JPEG_WORK_BUFFER_SIZE_ALLOC);
 #endif
-        if (!g_common_work_buf) {
-            ESP_LOGE(TAG, "❌ Failed to allocate work buffer");
-            free(g_preloaded_frames);
-            heap_caps_free(g_all_jpeg_data_psram);
-            heap_caps_free(g_common_out_buf);
-            g_preloaded_frames = NULL;
-            g_all_jpeg_data_psram = NULL;
-            g_common_out_buf = NULL;
-            return ESP_ERR_NO_MEM;
-        }
 
-        ESP_LOGI(TAG, "🚀 Work buffer allocated in %s RAM for optimal performance", 
-                 heap_caps_get_free_size(MALLOC_CAP_INTERNAL) > JPEG_WORK_BUFFER_SIZE_ALLOC ? "INTERNAL" : "EXTERNAL");
+        ESP_LOGI(TAG, "🚀 Work pool: %d bytes fast (%s) + %d bytes bulk (PSRAM)",
+                 g_fast_work_buf ? JPEG_FAST_WORK_BUFFER_SIZE : 0, g_fast_work_buf ? "INTERNAL" : "none",
+                 JPEG_WORK_BUFFER_SIZE_ALLOC);
 
 
 
         // Phase 3: Load JPEGs into PSRAM
-        ESP_LOGI(TAG, "⏳ Loading JPEGs into PSRAM...");
-        f = fopen(manifest_path, "r");
-        if (!f) {
-            ESP_LOGE(TAG, "❌ Failed to reopen manifest");
-            goto cleanup;
+        ESP_LOGI(TAG, "⏳ Loading JPEGs into PSRAM (%s)...", bulk ? "one bulk read" : "file by file");
+        cursor = (const char*)manifest;
+        int64_t preload_start = esp_timer_get_time();
+
+        // Bulk: the frame run lands as-is and frames point into it; otherwise frames are appended one by one
+        if (bulk && frame_source_read_region(region_start, g_all_jpeg_data_psram, region_len) != ESP_OK) {
+            ESP_LOGW(TAG, "⚠️ Bulk read failed, loading file by file");
+            bulk = false;
         }
 
         uint8_t* current_psram_pos = g_all_jpeg_data_psram;
         int loaded_frames = 0;
+        int duplicate_frames = 0;
+        size_t preload_bytes = bulk ? region_len : 0;
         line_count = 0;
 
-        while (fgets(line_buffer, sizeof(line_buffer), f) != NULL && loaded_frames < num_frames) {
-            // Yield every 5 lines for system stability (watchdog disabled)
-            if (++line_count % 5 == 0) {
+        while (loaded_frames < num_frames && manifest_next_line(&cursor, manifest_end, line_buffer, sizeof(line_buffer))) {
+            // Yield every 5 lines for system stability (watchdog disabled); nothing to wait on after a bulk read
+            if (!bulk && ++line_count % 5 == 0) {
                 vTaskDelay(1);
             }
 
-            line_buffer[strcspn(line_buffer, "\r\n")] = 0;
             if (strlen(line_buffer) == 0) continue;
 
-            // Parse filename and optional size again
+            // Parse filename, optional size and optional frame delay (ms)
             char filename_only2[MAX_FILENAME_LEN];
-            unsigned long size_hint2 = 0;
-            int tokens = sscanf(line_buffer, "%255s %lu", filename_only2, &size_hint2);
+            unsigned long size_hint2 = 0, delay_hint = 0;
+            int tokens = sscanf(line_buffer, "%255s %lu %lu", filename_only2, &size_hint2, &delay_hint);
             if (tokens < 1) {continue;}
 
             if (strlen(filename_only2) > MAX_FILENAME_LEN - 1){ESP_LOGW(TAG, "⚠️ Filename too long, skipping: %s", filename_only2); continue;}
 
-            int written = snprintf(image_path, sizeof(image_path), "/spiffs/output/%s", filename_only2);
+            int written = snprintf(image_path, sizeof(image_path), "%.*s%s", manifest_dir_len, manifest_path, filename_only2);
             if (written < 0 || written >= sizeof(image_path)) {
                 ESP_LOGW(TAG, "⚠️ Path truncation, skipping: %s", filename_only2);
                 continue;
             }
             
-            FILE* img_f = fopen(image_path, "rb");
-            if (!img_f) {
-                ESP_LOGW(TAG, "⚠️ Cannot open file: %s", image_path);
-                continue;
-            }
+            uint8_t* frame_data = current_psram_pos;
+            size_t file_size = 0;
+            size_t bytes_read = 0;
+            if (bulk) {
+                uint32_t frame_offset = 0, frame_size = 0;
+                if (frame_source_locate(image_path, &frame_offset, &frame_size) != ESP_OK ||
+                    frame_offset < region_start || frame_offset + frame_size > region_end) {
+                    ESP_LOGW(TAG, "⚠️ Not in the preloaded region: %s", image_path);
+                    continue;
+                }
+                frame_data = g_all_jpeg_data_psram + (frame_offset - region_start);
+                file_size = bytes_read = frame_size;
+            } else {
+                frame_file_t img_f;
+                if (frame_source_open(image_path, &img_f) != ESP_OK) {
+                    ESP_LOGW(TAG, "⚠️ Cannot open file: %s", image_path);
+                    continue;
+                }
 
-            // Just use the actual file size, ignore manifest hint
-            struct stat st;
-            if (stat(image_path, &st) != 0) {
-                fclose(img_f);
-                continue;
+                // Just use the actual file size, ignore manifest hint; never overrun the phase 1 total
+                file_size = img_f.size;
+                size_t room = preload_size - (size_t)(current_psram_pos - g_all_jpeg_data_psram);
+                bytes_read = file_size <= room ? frame_source_read(&img_f, current_psram_pos, file_size) : 0;
+                frame_source_close(&img_f);
+                preload_bytes += bytes_read;
             }
-            size_t file_size = st.st_size;
-
-            size_t bytes_read = fread(current_psram_pos, 1, file_size, img_f);
-            fclose(img_f);
 
             if (bytes_read == file_size) {
-                g_preloaded_frames[loaded_frames].data = current_psram_pos;
+                // Repeated frames (GIF holds, ping-pong loops) share the first copy's data
+                uint32_t hash = fnv1a_32(frame_data, bytes_read);
+                int first = -1;
+                for (int j = 0; j < loaded_frames; j++) {
+                    if (g_preloaded_frames[j].hash == hash && g_preloaded_frames[j].size == bytes_read &&
+                        memcmp(g_preloaded_frames[j].data, frame_data, bytes_read) == 0) {
+                        first = j;
+                        break;
+                    }
+                }
+                g_preloaded_frames[loaded_frames].data = first < 0 ? frame_data : g_preloaded_frames[first].data;
                 g_preloaded_frames[loaded_frames].size = bytes_read;
-                current_psram_pos += bytes_read;
+                g_preloaded_frames[loaded_frames].hash = hash;
+
+                // A new name prefix opens the next clip; its first frame's delay is the clip's
+                if (g_num_clips == 0 || (!clip_name_matches(g_clips[g_num_clips - 1].name, filename_only2) && g_num_clips < num_clips)) {
+                    image_display_clip_t* clip = &g_clips[g_num_clips++];
+                    snprintf(clip->name, sizeof(clip->name), "%.*s", clip_name_len(filename_only2), filename_only2);
+                    clip->first_frame = loaded_frames;
+                    clip->frame_count = 0;
+                    clip->delay_ms = delay_hint;
+                }
+                g_clips[g_num_clips - 1].frame_count++;
+                g_preloaded_frames[loaded_frames].clip = g_num_clips - 1;
+                if (first < 0) {
+                    if (!bulk) {
+                        current_psram_pos += bytes_read;
+                    }
+                } else {
+                    duplicate_frames++;
+                }
                 loaded_frames++;
             } else {
                 ESP_LOGW(TAG, "⚠️ File read failed: %s - expected %lu bytes, read %lu bytes", 
                          filename_only2, (unsigned long)file_size, (unsigned long)bytes_read);
             }
                 
-            // Log progress every 20 frames
-            if (loaded_frames % 20 == 0) {
+            // Log progress every 20 frames (the bulk read logs its own)
+            if (!bulk && loaded_frames % 20 == 0) {
                 ESP_LOGI(TAG, "📥 Loaded %d/%d frames...", loaded_frames, num_frames);
                 vTaskDelay(1);
             }
         }
-        fclose(f);
+        heap_caps_free(manifest);
+
+        // Phase 1 sized the buffer for every manifest entry; give back what duplicates (and failed
+        // reads) left unused. A bulk run is kept whole: frames point into it at their pack offsets.
+        size_t psram_used = bulk ? region_len : (size_t)(current_psram_pos - g_all_jpeg_data_psram);
+        if (!bulk && psram_used > 0 && psram_used < preload_size) {
+            uintptr_t old_base = (uintptr_t)g_all_jpeg_data_psram;
+            uint8_t* trimmed = heap_caps_realloc(g_all_jpeg_data_psram, psram_used, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+            if (trimmed) {
+                g_all_jpeg_data_psram = trimmed;
+                if ((uintptr_t)trimmed != old_base) {
+                    for (int j = 0; j < loaded_frames; j++) {
+                        g_preloaded_frames[j].data = trimmed + ((uintptr_t)g_preloaded_frames[j].data - old_base);
+                    }
+                }
+                ESP_LOGI(TAG, "✂️ Frame data trimmed to %lu of %lu bytes", (unsigned long)psram_used,
+                         (unsigned long)preload_size);
+            }
+        }
+
+        int64_t preload_us = esp_timer_get_time() - preload_start;
+        ESP_LOGI(TAG, "⏱️ Preload: %lu bytes in %lld ms (%.2f MB/s, %s)", (unsigned long)preload_bytes,
+                 (long long)(preload_us / 1000), preload_us > 0 ? (double)preload_bytes / (double)preload_us : 0.0,
+                 bulk ? "bulk" : "file by file");
 
         if (loaded_frames == 0) {
             ESP_LOGE(TAG, "❌ Failed to load any frames");
@@ -667,69 +1377,265 @@ esp_err_t play_jpeg_sequence_from_manifest(const char* manifest_path, uint32_t f
         }
 
         g_num_loaded_frames = loaded_frames;
+
+        // Size the per-frame scratch arena once: the largest native frame that gets upscaled
+        size_t scratch_needed = 0;
+        size_t largest_frame = 0;     // Native output size, for the lookahead slots
+        bool any_full_size = false;   // Frames decoded straight into g_common_out_buf
+#if UPSCALE_MODE >= 1 && SCALE_FIT_MODE
+        g_scale_maps_used = 0;        // Scale maps for this manifest's sizes are built below
+        g_scale_map_overflow_warned = false;
+#endif
+        for (int i = 0; i < loaded_frames; i++) {
+            esp_jpeg_image_output_t info;
+            if (frame_get_info(g_preloaded_frames[i].data, g_preloaded_frames[i].size, &info) != ESP_OK) {
+                continue;
+            }
+            if (info.output_len > largest_frame) {
+                largest_frame = info.output_len;
+            }
+#if UPSCALE_MODE >= 1 && SCALE_FIT_MODE
+            const rgb565_scale_map_t* fit_map = scale_map_preload(info.width, info.height);
+#else
+            const rgb565_scale_map_t* fit_map = NULL;
+#endif
+            if (pick_upscale_factor(info.width, info.height, fit_map) == 1) {
+                any_full_size = true;
+#if CONFIG_T4_KNOB_SCRUB && UPSCALE_MODE >= 1
+                // Scrub previews of full-size frames are small and get upscaled
+                size_t preview_len = (size_t)(info.width >> SCRUB_PREVIEW_SCALE) * (info.height >> SCRUB_PREVIEW_SCALE) * 2;
+                if (preview_len > scratch_needed) {
+                    scratch_needed = preview_len;
+                }
+#endif
+            } else if (info.output_len > scratch_needed) {
+                scratch_needed = info.output_len;
+            }
+        }
+
+#if UPSCALE_MODE >= 1 && STREAM_UPSCALE_TO_DMA
+        // Band buffers for streamed upscaling; without them upscaled frames need the full-size buffer
+        if (scratch_needed > 0) {
+            for (int b = 0; b < 2; b++) {
+                g_band_bufs[b] = heap_caps_malloc(UPSCALE_BAND_BUF_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+                g_band_seq[b] = s_draws_submitted;
+            }
+            if (!g_band_bufs[0] || !g_band_bufs[1]) {
+                ESP_LOGW(TAG, "⚠️ No internal DMA memory for band buffers, upscaling into a full-size frame");
+                heap_caps_free(g_band_bufs[0]);
+                heap_caps_free(g_band_bufs[1]);
+                g_band_bufs[0] = g_band_bufs[1] = NULL;
+            } else {
+                ESP_LOGI(TAG, "🌊 Streaming upscale through 2 x %d byte DMA band buffers", UPSCALE_BAND_BUF_SIZE);
+            }
+        }
+#endif
+        if (any_full_size || (scratch_needed > 0 && !g_band_bufs[0])) {
+            g_common_out_buf = heap_caps_malloc(LOGICAL_DISPLAY_WIDTH * LOGICAL_DISPLAY_HEIGHT * 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+            if (!g_common_out_buf) {
+                ESP_LOGE(TAG, "❌ Failed to allocate output buffer");
+                overall_ret = ESP_ERR_NO_MEM;
+                goto cleanup;
+            }
+        }
+        if (frame_arena_init(&g_frame_arena, scratch_needed, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) != ESP_OK) {
+            ESP_LOGE(TAG, "❌ Failed to allocate %lu byte frame arena", (unsigned long)scratch_needed);
+            overall_ret = ESP_ERR_NO_MEM;
+            goto cleanup;
+        }
+        ESP_LOGI(TAG, "🧱 Frame arena: %lu bytes, heap-call watch %s", (unsigned long)g_frame_arena.size,
+                 frame_arena_heap_watch_supported() ? "on" : "off (enable CONFIG_HEAP_USE_HOOKS)");
+#if LOOKAHEAD_PSRAM_BUDGET > 0
+        lookahead_init(largest_frame);
+#endif
+#if CONFIG_T4_TEMPORAL_BLEND
+        // In-betweens are mixed from ring slots, so they need the ring
+        if (g_lookahead_slots) {
+            g_blend_buf = heap_caps_malloc(largest_frame, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+            g_blend_seq = s_draws_submitted;
+        }
+        ESP_LOGI(TAG, "🌗 Temporal blend %s", g_blend_buf ? "on" : "off (needs the lookahead ring)");
+#endif
+
         g_frames_loaded = true;
-        ESP_LOGI(TAG, "✅ Successfully loaded %d frames into PSRAM", loaded_frames);
-    }
+        ESP_LOGI(TAG, "✅ Successfully loaded %d frames into PSRAM (%d duplicates share data, %lu bytes of frame data)",
+                 loaded_frames, duplicate_frames, (unsigned long)psram_used);
+        ESP_LOGI(TAG, "🗂️ %d clips indexed", g_num_clips);
+        for (int c = 0; c < g_num_clips; c++) {
+            ESP_LOGD(TAG, "   %-16s frames %d..%d, delay %lu ms", g_clips[c].name, g_clips[c].first_frame,
+                     g_clips[c].first_frame + g_clips[c].frame_count - 1, (unsigned long)g_clips[c].delay_ms);
+        }
 
-    // Clear the screen to black now that frames are loaded (so loading screen stays visible during loading)
-    {
+        // Clear the screen to black now that frames are loaded (so loading screen stays visible during
+        // loading). Only once: replays and clip switches draw straight over the last frame.
         uint16_t *black_line = calloc(LOGICAL_DISPLAY_WIDTH, sizeof(uint16_t));
         if (black_line) {
             for (int y = 0; y < LOGICAL_DISPLAY_HEIGHT; y++) {
-                esp_lcd_panel_draw_bitmap(panel_handle, 0, y, LOGICAL_DISPLAY_WIDTH, y + 1, black_line);
+                panel_draw(0, y, LOGICAL_DISPLAY_WIDTH, y + 1, black_line, NULL);
             }
             free(black_line);
         }
+        g_shown_frame_data = NULL;
+        g_shown_index = -1;
+
+#if DECODE_BENCH_PASSES > 0
+        decode_bench_run(g_preloaded_frames, g_num_loaded_frames, DECODE_BENCH_PASSES);
+#endif
     }
 
     // Phase 4: Play sequence from PSRAM with OPTIMIZED SPEED (anti-tearing)
     ESP_LOGI(TAG, "▶️ Playing %d frames with display sync...", g_num_loaded_frames);
-    uint32_t frame_start_time;
+    int64_t frame_start_time;
     uint32_t decode_time, total_time;
     
-    for (int i = 0; i < g_num_loaded_frames; i++) {
-        frame_start_time = esp_timer_get_time() / 1000; // Convert to ms
-        
-        uint32_t decode_start = esp_timer_get_time() / 1000;
-        esp_err_t ret = decode_and_display_jpeg(
+    // One pass over the selected clip, or over the whole manifest
+    int clip = s_current_clip;
+    int begin = clip >= 0 ? g_clips[clip].first_frame : 0;
+    int end = clip >= 0 ? begin + g_clips[clip].frame_count : g_num_loaded_frames;
+    for (int i = begin; i < end; i++) {
+        // Clip switch: only the playhead moves, so it costs no more than any other frame
+        int pending = __atomic_exchange_n(&s_pending_clip, CLIP_PENDING_NONE, __ATOMIC_ACQ_REL);
+        if (pending != CLIP_PENDING_NONE) {
+            s_current_clip = pending;
+            if (pending >= 0) {
+                i = begin = g_clips[pending].first_frame;
+                end = begin + g_clips[pending].frame_count;
+                uint32_t delay = g_clips[pending].delay_ms;
+                if (delay) {
+                    g_frame_delay_ms = delay < SPEED_DELAY_MIN_MS ? SPEED_DELAY_MIN_MS : delay > SPEED_DELAY_MAX_MS ? SPEED_DELAY_MAX_MS : delay;
+                }
+            } else {
+                begin = 0;
+                end = g_num_loaded_frames;
+            }
+            ESP_LOGI(TAG, "🔀 Clip: %s from frame %d, %lu ms per frame", pending >= 0 ? g_clips[pending].name : "all",
+                     i, (unsigned long)g_frame_delay_ms);
+        }
+
+#if CONFIG_T4_KNOB_SCRUB
+        // Scrub: detents move the playhead from the frame on screen (wrapping within the clip),
+        // and frames are cheap previews until the knob settles. A wiggle switches clip as it
+        // does without scrub, from the next frame on.
+        int scrubbed = speed_control_poll_scrub();
+        take_wiggle_clip_steps(i);
+        bool preview = UPSCALE_MODE >= 1 && speed_control_scrubbing((uint32_t)esp_timer_get_time());
+        if ((scrubbed || preview) && g_shown_index >= begin && g_shown_index < end) {
+            int len = end - begin;
+            i = begin + ((g_shown_index - begin + scrubbed) % len + len) % len;
+        }
+#else
+        const bool preview = false;
+#endif
+        uint32_t frame_delay_ms = preview ? SCRUB_POLL_MS : g_frame_delay_ms;
+
+        frame_start_time = esp_timer_get_time();
+
+        // Identical to what is already on screen: hold it, no decode and no SPI transfer
+        if (g_preloaded_frames[i].data == g_shown_frame_data && g_shown_preview == preview) {
+            perf_frame_record_t rec = { .frame_index = (uint32_t)i, .flags = PERF_FLAG_DUPLICATE };
+            g_shown_index = i;
+            if (g_lookahead_slots && !preview) {
+                lookahead_fill(i, begin, end, frame_start_time + (int64_t)frame_delay_ms * 1000 - LOOKAHEAD_MARGIN_US);
+            }
+            int64_t sleep_start = esp_timer_get_time();
+            total_time = (uint32_t)((sleep_start - frame_start_time) / 1000);
+            SPAN_BEGIN(SPAN_SLEEP, i);
+            if (total_time < frame_delay_ms) {
+                vTaskDelay(pdMS_TO_TICKS(frame_delay_ms - total_time));
+            }
+            SPAN_END(SPAN_SLEEP, i);
+            rec.sleep_us = (uint32_t)(esp_timer_get_time() - sleep_start);
+            perf_telemetry_commit(&rec);
+            perf_telemetry_poll();
+            continue;
+        }
+
+        // Decoded ahead in an earlier frame's slack: only the draw is left
+        lookahead_slot_t* ahead = preview ? NULL : lookahead_find(g_preloaded_frames[i].data);
+
+        frame_arena_heap_watch_begin();
+        SPAN_BEGIN(SPAN_FRAME, i);
+        esp_err_t ret = decode_and_display_scaled(
             g_preloaded_frames[i].data,
             g_preloaded_frames[i].size,
             g_common_out_buf,
             LOGICAL_DISPLAY_WIDTH * LOGICAL_DISPLAY_HEIGHT * 2,
             g_common_work_buf,
-            JPEG_WORK_BUFFER_SIZE_ALLOC
+            JPEG_WORK_BUFFER_SIZE_ALLOC,
+            preview ? SCRUB_PREVIEW_SCALE : JPEG_IMAGE_SCALE_0,
+            ahead ? ahead->pixels : NULL
         );
-        decode_time = (esp_timer_get_time() / 1000) - decode_start;
+        SPAN_END(SPAN_FRAME, i);
+        uint32_t heap_calls = frame_arena_heap_watch_end();
+        decode_time = (uint32_t)((esp_timer_get_time() - frame_start_time) / 1000);
+        if (heap_calls) {
+            g_frame_path_heap_calls += heap_calls;
+            ESP_LOGW(TAG, "⚠️ Frame %d made %lu heap calls on the frame path", i, (unsigned long)heap_calls);
+#if FRAME_PATH_ASSERT_NO_HEAP
+            abort();
+#endif
+        }
+
+        perf_frame_record_t rec = s_frame_timing;
+        rec.frame_index = (uint32_t)i;
+        if (preview) {
+            rec.flags |= PERF_FLAG_PREVIEW;
+        }
+        if (ahead) {
+            ahead->draw_seq = s_draws_submitted;
+            rec.prepare_us = ahead->timing.prepare_us;
+            rec.decode_us = ahead->timing.decode_us;
+            rec.color_us = ahead->timing.color_us;
+            rec.flags |= PERF_FLAG_LOOKAHEAD;
+        }
+        int64_t draw_start = s_draw_start_us;
 
         if (ret != ESP_OK) {
             ESP_LOGW(TAG, "⚠️ Frame %d display failed: %s", i, esp_err_to_name(ret));
             if (overall_ret == ESP_OK) overall_ret = ret;
+            rec.flags |= PERF_FLAG_DECODE_ERROR;
+            g_shown_frame_data = NULL;
+        } else {
+            g_shown_frame_data = g_preloaded_frames[i].data;
+            g_shown_preview = preview;
         }
+        g_shown_index = i;
 
-        total_time = (esp_timer_get_time() / 1000) - frame_start_time;
+        total_time = (uint32_t)((esp_timer_get_time() - frame_start_time) / 1000);
         
         // Performance logging every 50 frames
         if (i % 50 == 0) {
-            ESP_LOGI(TAG, "🏎️ Frame %d: decode=%lums, total=%lums, target=%lums", i, decode_time, total_time, g_frame_delay_ms);
+            ESP_LOGI(TAG, "🏎️ Frame %d: decode=%lums, total=%lums, target=%lums, heap calls=%lu, arena peak=%lu",
+                     i, decode_time, total_time, g_frame_delay_ms,
+                     (unsigned long)g_frame_path_heap_calls, (unsigned long)g_frame_arena.high_water);
         }
 
-        // allow real-time adjustment via rotary encoder
-        int step = encoder_get_delta();
-        if (step) {
-            int32_t new_delay = (int32_t)g_frame_delay_ms + step * 10;
-            if (new_delay < 70)  new_delay = 70;   // Above decode time so delays actually matter
-            if (new_delay > 150) new_delay = 150;  // Much slower for visible difference
-            g_frame_delay_ms = (uint32_t)new_delay;
-            ESP_LOGI("ENC","delay=%" PRIu32 " ms", g_frame_delay_ms);
-        }
+#if !CONFIG_T4_KNOB_SCRUB
+        // allow real-time adjustment via rotary encoder; a wiggle steps to the next or previous clip
+        g_frame_delay_ms = speed_control_poll(g_frame_delay_ms);
+        take_wiggle_clip_steps(i);
+        frame_delay_ms = g_frame_delay_ms;
+#endif
 
-        uint32_t min_frame_time = g_frame_delay_ms;
+        uint32_t min_frame_time = frame_delay_ms;
+        if (g_lookahead_slots && !preview) {
+#if CONFIG_T4_TEMPORAL_BLEND
+            blend_in_betweens(i, begin, end, frame_start_time, min_frame_time, &rec, &draw_start);
+#endif
+            lookahead_fill(i, begin, end, frame_start_time + (int64_t)min_frame_time * 1000 - LOOKAHEAD_MARGIN_US);
+            total_time = (uint32_t)((esp_timer_get_time() - frame_start_time) / 1000);
+        }
+        int64_t sleep_start = esp_timer_get_time();
+        SPAN_BEGIN(SPAN_SLEEP, i);
         if (total_time < min_frame_time) {
             vTaskDelay(pdMS_TO_TICKS(min_frame_time - total_time));
         } else {
             // Frame took longer than target, add small sync delay to prevent tearing
             vTaskDelay(pdMS_TO_TICKS(2));
         }
+        SPAN_END(SPAN_SLEEP, i);
+        rec.sleep_us = (uint32_t)(esp_timer_get_time() - sleep_start);
+        commit_frame_record(&rec, draw_start);
     }
 
     return overall_ret;
@@ -739,6 +1645,10 @@ cleanup:
         free(g_preloaded_frames);
         g_preloaded_frames = NULL;
     }
+    free(g_clips);
+    g_clips = NULL;
+    g_num_clips = 0;
+    s_current_clip = -1;
     if (g_all_jpeg_data_psram) {
         heap_caps_free(g_all_jpeg_data_psram);
         g_all_jpeg_data_psram = NULL;
@@ -747,14 +1657,28 @@ cleanup:
         heap_caps_free(g_common_out_buf);
         g_common_out_buf = NULL;
     }
+    // Band buffers may still be on the bus
+    if (g_band_bufs[0] || g_band_bufs[1]) {
+        panel_wait_draw_done(s_draws_submitted, pdMS_TO_TICKS(500));
+        heap_caps_free(g_band_bufs[0]);
+        heap_caps_free(g_band_bufs[1]);
+        g_band_bufs[0] = g_band_bufs[1] = NULL;
+    }
     if (g_common_work_buf) {
-#if USE_INTERNAL_RAM_FOR_WORK_BUFFER
         heap_caps_free(g_common_work_buf);
-#else
-        free(g_common_work_buf);
-#endif
         g_common_work_buf = NULL;
     }
+    if (g_fast_work_buf) {
+        heap_caps_free(g_fast_work_buf);
+        g_fast_work_buf = NULL;
+    }
+    lookahead_free();
+    if (g_blend_buf) {
+        panel_wait_draw_done(g_blend_seq, pdMS_TO_TICKS(500));
+        heap_caps_free(g_blend_buf);
+        g_blend_buf = NULL;
+    }
+    frame_arena_deinit(&g_frame_arena);
     g_frames_loaded = false;
     g_num_loaded_frames = 0;
     return overall_ret;
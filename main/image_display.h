@@ -1,24 +1,68 @@
 #pragma once
 
+#include "sdkconfig.h"
 #include "esp_err.h"
+#include "esp_lcd_panel_io.h"
 #include <stddef.h> // For size_t
 
-#define UPSCALE_MODE 1  // 0 = no upscale, 1 = nearest-neighbour 2×
+#ifndef UPSCALE_MODE
+#define UPSCALE_MODE 1  // 0 = no upscale, 1 = nearest-neighbour 2×, 2 = bilinear 2× (main/rgb565_scale.h)
+#endif
+
+// Mount point of the filesystem frame sources (the host build points this at data/)
+#ifndef STORAGE_BASE_PATH
+#define STORAGE_BASE_PATH "/spiffs"
+#endif
+
+// Internal-DRAM part of the tjpgd work pool: input buffer, dequantizer tables,
+// fast Huffman LUTs and IDCT/MCU buffers (~8.5 KB for 4:2:0 with JD_FASTDECODE=2,
+// ~13.4 KB with JD_FASTDECODE=3 and its 32-bit AC tables)
+#if CONFIG_JD_FASTDECODE == 3
+#define JPEG_FAST_WORK_BUFFER_SIZE (13 * 1024 + 512)
+#else
+#define JPEG_FAST_WORK_BUFFER_SIZE (9 * 1024 + 512)
+#endif
 
 // Structure to hold information about a preloaded JPEG frame
 typedef struct {
-    uint8_t* data; // Pointer to JPEG data in PSRAM
+    uint8_t* data; // Pointer to JPEG data in PSRAM (shared between identical frames)
     size_t size;   // Size of the JPEG data
+    uint32_t hash; // FNV-1a of the JPEG data, used to find duplicates at preload
+    uint16_t clip; // Index into the clip table
 } preloaded_jpeg_frame_t;
 
-// Initialize SPIFFS filesystem
-esp_err_t init_spiffs(void);
+#define CLIP_NAME_LEN 32
+
+// A run of manifest frames from one source clip ("larry-001.jpg".."larry-028.jpg")
+typedef struct {
+    char name[CLIP_NAME_LEN];  // Frame name up to its last '-' ("larry")
+    int first_frame;   // Index of its first preloaded frame
+    int frame_count;
+    uint32_t delay_ms; // Default frame delay from the manifest's third column, 0 = none
+} image_display_clip_t;
 
-// Load and display a raw RGB565 image
+// Load and display a raw RGB565 image (name relative to the storage root)
 esp_err_t load_and_display_raw_image(const char* filename);
 
 // Decode and display a JPEG image from a data buffer
 esp_err_t decode_and_display_jpeg(const uint8_t* jpeg_data, size_t jpeg_data_size, uint8_t* external_out_buffer, size_t external_out_buffer_size, uint8_t* external_work_buffer, size_t external_work_buffer_size);
 
-// Play a sequence of JPEGs listed in a manifest file
-esp_err_t play_jpeg_sequence_from_manifest(const char* manifest_path, uint32_t frame_delay_ms); 
\ No newline at end of file
+// Panel IO colour-transfer-done callback (register as on_color_trans_done); runs in ISR context
+bool image_display_on_color_trans_done(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx);
+
+// Play a sequence of JPEGs listed in a manifest file; the manifest and frames
+// are read through the current frame source ("output/manifest.txt")
+esp_err_t play_jpeg_sequence_from_manifest(const char* manifest_path, uint32_t frame_delay_ms); 
+
+// Clip table, built when the manifest is preloaded (0 clips before that)
+int image_display_clip_count(void);
+const image_display_clip_t* image_display_clip(int index);
+int image_display_find_clip(const char* name);   // -1 if not found
+
+// Loop clip 'index' from the next frame on, or the whole manifest for -1. Safe
+// to call from any task: the player only moves its playhead, so nothing is
+// reloaded or cleared and the switch costs one ordinary frame.
+esp_err_t image_display_select_clip(int index);
+
+// Clip being looped, -1 while playing the whole manifest
+int image_display_current_clip(void);
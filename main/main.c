@@ -9,12 +9,16 @@
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_ili9341.h"
 #include "image_display.h"
+#include "frame_source.h"
 #include <string.h>
 #include <math.h>
 #include <inttypes.h>
 #include <stdio.h>
 #include "esp_heap_caps.h"
 #include "encoder.h"
+#include "speed_control.h"
+#include "perf_telemetry.h"
+#include "span_trace.h"
 #include "esp_timer.h"
 
 static const char *TAG = "T4_DISPLAY";
@@ -41,11 +45,11 @@ void app_main(void)
 {
     ESP_LOGI(TAG, "🚀 Starting T4 Display Sequence Player");
     
-    // Initialize SPIFFS
-    esp_err_t spiffs_ret = init_spiffs(); // Ensure this is declared in image_display.h and defined in image_display.c
-    if (spiffs_ret != ESP_OK) {
-        ESP_LOGE(TAG, "SPIFFS Initialization failed. Halting.");
-        return; // Stop if SPIFFS fails, as we need it for the manifest and images
+    // Mount frame storage (backend picked by CONFIG_T4_FRAME_SOURCE)
+    esp_err_t storage_ret = frame_source_init(NULL);
+    if (storage_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Frame storage initialization failed. Halting.");
+        return; // Stop if storage fails, as we need it for the manifest and images
     }
     
     // Initialize LCD
@@ -71,6 +75,7 @@ void app_main(void)
         .lcd_param_bits = 8,
         .spi_mode = 0,
         .trans_queue_depth = 10,
+        .on_color_trans_done = image_display_on_color_trans_done, // SPI completion time for telemetry
     };
     ESP_ERROR_CHECK(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)SPI2_HOST, &io_config, &io_handle));
     
@@ -113,32 +118,11 @@ void app_main(void)
     }
     
     // Read the JPEG file into memory
-    FILE* f = fopen("/spiffs/test.jpg", "rb");
-    if (!f) {
-        ESP_LOGE(TAG, "❌ Failed to open test.jpg");
-        goto cleanup_test_jpg;
-    }
-    
-    // Get file size
-    fseek(f, 0, SEEK_END);
-    size_t file_size = ftell(f);
-    fseek(f, 0, SEEK_SET);
-    
-    // Allocate buffer for JPEG file
-    uint8_t* jpeg_data = heap_caps_malloc(file_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-    if (!jpeg_data) {
-        ESP_LOGE(TAG, "❌ Failed to allocate JPEG buffer");
-        fclose(f);
-        goto cleanup_test_jpg;
-    }
-    
-    // Read JPEG file
-    size_t bytes_read = fread(jpeg_data, 1, file_size, f);
-    fclose(f);
-    
-    if (bytes_read != file_size) {
-        ESP_LOGE(TAG, "❌ Failed to read complete JPEG file");
-        heap_caps_free(jpeg_data);
+    uint8_t* jpeg_data = NULL;
+    size_t file_size = 0;
+    esp_err_t load_ret = frame_source_load("test.jpg", MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, &jpeg_data, &file_size);
+    if (load_ret != ESP_OK) {
+        ESP_LOGE(TAG, "❌ Failed to load test.jpg: %s", esp_err_to_name(load_ret));
         goto cleanup_test_jpg;
     }
     
@@ -167,24 +151,25 @@ cleanup_test_jpg:
     if (work_buf) heap_caps_free(work_buf);
 
     // --- Play sequence from manifest (test.jpg was only loading screen) --- 
-    const char* manifest_file = "/spiffs/output/manifest.txt";
+    const char* manifest_file = "output/manifest.txt";
 
     ESP_LOGI(TAG, "🎬 Attempting to play sequence from: %s at %" PRIu32 " ms per frame", manifest_file, g_frame_delay_ms);
     
-    // Initialise rotary encoder
-    encoder_init();
+    // Initialise rotary encoder (detents are queued by its ISR and drained per frame)
+    if (encoder_init() != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️ Rotary encoder unavailable, frame delay stays at %" PRIu32 " ms", g_frame_delay_ms);
+    }
+
+    // Per-frame telemetry ring and span trace (dumped over UART on demand)
+    perf_telemetry_init();
+    span_trace_init();
 
     // Loop to continuously play the sequence
     while (1) {
-        // Read encoder every loop; adjust delay in 5-ms steps
-        int step = encoder_get_delta();
-        if (step) {
-            int32_t new_delay = (int32_t)g_frame_delay_ms + step * 5;
-            if (new_delay < 30)  new_delay = 30;
-            if (new_delay > 100) new_delay = 100;
-            g_frame_delay_ms = (uint32_t)new_delay;
-            ESP_LOGI(TAG,"Frame delay set to %" PRIu32 " ms", g_frame_delay_ms);
-        }
+#if !CONFIG_T4_KNOB_SCRUB
+        // Knob turns made between sequences (the player drains them per frame too)
+        g_frame_delay_ms = speed_control_poll(g_frame_delay_ms);
+#endif
         esp_err_t play_ret = play_jpeg_sequence_from_manifest(manifest_file, g_frame_delay_ms);
         if (play_ret == ESP_OK) {
             ESP_LOGI(TAG, "🎉 Sequence finished. Replaying...");
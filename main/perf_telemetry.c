@@ -0,0 +1,128 @@
+#include "perf_telemetry.h"
+#include "span_trace.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_crc.h"
+#include "driver/uart.h"
+#include "sdkconfig.h"
+#include <string.h>
+
+static const char *TAG = "PERF";
+
+#define PERF_UART_NUM       CONFIG_ESP_CONSOLE_UART_NUM
+#define PERF_UART_RX_BUF    256 // Driver minimum is SOC_UART_FIFO_LEN
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t dropped;   // Records overwritten since the last dump
+} perf_dump_header_t;
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint32_t crc32;     // esp_rom_crc32_le(0, records, count * record_size)
+} perf_dump_trailer_t;
+
+static perf_frame_record_t *s_ring = NULL;
+static uint32_t s_head = 0;     // Next slot to write
+static uint32_t s_count = 0;    // Valid records in the ring
+static uint32_t s_dropped = 0;
+static bool s_uart_ready = false;
+
+esp_err_t perf_telemetry_init(void)
+{
+    if (s_ring) {
+        return ESP_OK;
+    }
+
+    // 36 B per record; keep it out of internal RAM
+    s_ring = heap_caps_calloc(PERF_TELEMETRY_RING_LEN, sizeof(perf_frame_record_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!s_ring) {
+        ESP_LOGE(TAG, "❌ Failed to allocate telemetry ring");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // The console UART has no driver by default; we need one for non-blocking reads
+    esp_err_t ret = uart_driver_install(PERF_UART_NUM, PERF_UART_RX_BUF, 0, 0, NULL, 0);
+    if (ret == ESP_OK) {
+        s_uart_ready = true;
+    } else {
+        ESP_LOGW(TAG, "⚠️ UART driver install failed (%s), dumps disabled", esp_err_to_name(ret));
+    }
+
+    ESP_LOGI(TAG, "📈 Telemetry ring: %d records, send '%c' on UART%d to dump",
+             PERF_TELEMETRY_RING_LEN, PERF_TELEMETRY_DUMP_CMD, PERF_UART_NUM);
+    return ESP_OK;
+}
+
+void perf_telemetry_commit(const perf_frame_record_t *rec)
+{
+    if (!s_ring) {
+        return;
+    }
+    s_ring[s_head] = *rec;
+    s_head = (s_head + 1) % PERF_TELEMETRY_RING_LEN;
+    if (s_count < PERF_TELEMETRY_RING_LEN) {
+        s_count++;
+    } else {
+        s_dropped++;
+    }
+}
+
+static void uart_write(const void *data, size_t len, void *ctx)
+{
+    uart_write_bytes(PERF_UART_NUM, data, len);
+}
+
+void perf_telemetry_poll(void)
+{
+    if (!s_uart_ready) {
+        return;
+    }
+    uint8_t cmd;
+    while (uart_read_bytes(PERF_UART_NUM, &cmd, 1, 0) == 1) {
+        if (cmd == PERF_TELEMETRY_DUMP_CMD) {
+            perf_telemetry_flush();
+        } else if (cmd == SPAN_TRACE_DUMP_CMD) {
+            span_trace_dump(uart_write, NULL);
+            uart_wait_tx_done(PERF_UART_NUM, portMAX_DELAY);
+        }
+    }
+}
+
+void perf_telemetry_flush(void)
+{
+    if (!s_ring || !s_uart_ready) {
+        return;
+    }
+
+    perf_dump_header_t hdr = {
+        .version = PERF_TELEMETRY_VERSION,
+        .record_size = sizeof(perf_frame_record_t),
+        .count = s_count,
+        .dropped = s_dropped,
+    };
+    memcpy(hdr.magic, PERF_TELEMETRY_MAGIC, sizeof(hdr.magic));
+    uart_write_bytes(PERF_UART_NUM, &hdr, sizeof(hdr));
+
+    // Oldest record first; the ring may wrap so write it in up to two pieces
+    uint32_t tail = (s_head + PERF_TELEMETRY_RING_LEN - s_count) % PERF_TELEMETRY_RING_LEN;
+    uint32_t first = (tail + s_count <= PERF_TELEMETRY_RING_LEN) ? s_count : PERF_TELEMETRY_RING_LEN - tail;
+    uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)&s_ring[tail], first * sizeof(perf_frame_record_t));
+    uart_write_bytes(PERF_UART_NUM, &s_ring[tail], first * sizeof(perf_frame_record_t));
+    if (first < s_count) {
+        crc = esp_rom_crc32_le(crc, (const uint8_t *)s_ring, (s_count - first) * sizeof(perf_frame_record_t));
+        uart_write_bytes(PERF_UART_NUM, s_ring, (s_count - first) * sizeof(perf_frame_record_t));
+    }
+
+    perf_dump_trailer_t trailer = { .crc32 = crc };
+    memcpy(trailer.magic, PERF_TELEMETRY_END_MAGIC, sizeof(trailer.magic));
+    uart_write_bytes(PERF_UART_NUM, &trailer, sizeof(trailer));
+    uart_wait_tx_done(PERF_UART_NUM, portMAX_DELAY);
+
+    s_count = 0;
+    s_dropped = 0;
+}
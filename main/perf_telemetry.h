@@ -0,0 +1,51 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stdint.h>
+
+// Number of per-frame records kept in the ring (oldest records are overwritten)
+#define PERF_TELEMETRY_RING_LEN   1024
+
+// Byte received on the console UART that triggers a dump of the ring
+#define PERF_TELEMETRY_DUMP_CMD   'T'
+
+// Dump framing (see tools/perf_report.py for the host-side parser)
+#define PERF_TELEMETRY_MAGIC      "T4PF"
+#define PERF_TELEMETRY_END_MAGIC  "T4PE"
+#define PERF_TELEMETRY_VERSION    1
+
+// perf_frame_record_t.flags
+#define PERF_FLAG_DECODE_ERROR    (1u << 0) // decode_and_display_jpeg failed for this frame
+#define PERF_FLAG_SPI_PENDING     (1u << 1) // colour transfer had not completed when the record was committed
+#define PERF_FLAG_DUPLICATE       (1u << 2) // same data as the frame on screen; decode and SPI were skipped
+#define PERF_FLAG_PREVIEW         (1u << 3) // reduced-resolution scrub preview (SCRUB_PREVIEW_SCALE)
+#define PERF_FLAG_LOOKAHEAD       (1u << 4) // drawn from the lookahead ring; decode times are from the earlier slack
+#define PERF_FLAG_BLEND           (1u << 5) // in-between of frame_index and the next frame; decode_us is the blend
+
+// One binary record per displayed frame. All times are in microseconds.
+// Layout is fixed (little-endian, packed) because it is parsed on the host.
+typedef struct __attribute__((packed)) {
+    uint32_t frame_index;     // Index into the manifest
+    uint32_t prepare_us;      // jd_prepare: header parse + table build
+    uint32_t decode_us;       // Entropy decoding + IDCT (mcu_load)
+    uint32_t color_us;        // YCbCr->RGB + copy to output buffer (mcu_output)
+    uint32_t scale_us;        // Nearest-neighbour upscale
+    uint32_t spi_submit_us;   // Time spent inside esp_lcd_panel_draw_bitmap
+    uint32_t spi_complete_us; // From draw_bitmap start to the last colour transfer done
+    uint32_t sleep_us;        // Pacing delay after the frame
+    uint16_t flags;           // PERF_FLAG_*
+    uint16_t reserved;
+} perf_frame_record_t;
+
+// Allocate the record ring and install the console UART driver used for dumps
+esp_err_t perf_telemetry_init(void);
+
+// Append a record to the ring (overwrites the oldest one when full)
+void perf_telemetry_commit(const perf_frame_record_t *rec);
+
+// Non-blocking check of the console UART; dumps the ring when PERF_TELEMETRY_DUMP_CMD was received
+// (and the span trace on SPAN_TRACE_DUMP_CMD)
+void perf_telemetry_poll(void);
+
+// Write all buffered records over the console UART and empty the ring
+void perf_telemetry_flush(void);
@@ -0,0 +1,94 @@
+#include "q565.h"
+#include <string.h>
+
+bool q565_is_frame(const uint8_t *data, size_t size)
+{
+    return size >= Q565_HEADER_SIZE && memcmp(data, Q565_MAGIC, 4) == 0;
+}
+
+esp_err_t q565_get_info(const uint8_t *data, size_t size, uint16_t *width, uint16_t *height)
+{
+    if (!q565_is_frame(data, size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *width = (uint16_t)(data[4] | data[5] << 8);
+    *height = (uint16_t)(data[6] | data[7] << 8);
+    return ESP_OK;
+}
+
+esp_err_t q565_decode(const uint8_t *data, size_t size, uint16_t *out, size_t out_pixels, bool swap_bytes)
+{
+    uint16_t width, height;
+    esp_err_t ret = q565_get_info(data, size, &width, &height);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    size_t total = (size_t)width * height;
+    if (total > out_pixels) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // The cache holds pixels in output byte order, so INDEX and RUN are plain copies
+    uint16_t cache[64] = { 0 };
+    const uint8_t *p = data + Q565_HEADER_SIZE;
+    const uint8_t *end = data + size;
+    uint16_t *o = out;
+    uint16_t *o_end = out + total;
+    uint32_t px = 0;       // Previous pixel, RGB565
+    uint16_t px_out = 0;   // Same in output byte order
+
+    while (o < o_end) {
+        if (p >= end) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        uint32_t op = *p++;
+        if (op < Q565_OP_DIFF) {
+            px_out = cache[op];
+            px = swap_bytes ? (uint16_t)(px_out >> 8 | px_out << 8) : px_out;
+            *o++ = px_out;
+            continue;
+        }
+        if (op >= Q565_OP_RUN && op < Q565_OP_RGB) {
+            size_t run = (op & 0x3F) + 1;
+            if (run > (size_t)(o_end - o)) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            while (run--) {
+                *o++ = px_out;
+            }
+            continue;
+        }
+
+        uint32_t r = px >> 11, g = (px >> 5) & 63, b = px & 31;
+        if (op < Q565_OP_LUMA) {
+            r += ((op >> 4) & 3) - 2;
+            g += ((op >> 2) & 3) - 2;
+            b += (op & 3) - 2;
+        } else if (op < Q565_OP_RUN) {
+            if (p >= end) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            int32_t dg = (int32_t)(op & 0x3F) - 32;
+            int32_t dg_half = ((dg + 64) >> 1) - 32;   // floor(dg / 2) without a signed shift
+            uint32_t rb = *p++;
+            r += (int32_t)(rb >> 4) - 8 + dg_half;
+            g += dg;
+            b += (int32_t)(rb & 15) - 8 + dg_half;
+        } else if (op == Q565_OP_RGB) {
+            if (end - p < 2) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            r = p[0] >> 3;
+            g = ((p[0] & 7) << 3) | (p[1] >> 5);
+            b = p[1] & 31;
+            p += 2;
+        } else {
+            return ESP_ERR_INVALID_STATE;   // 0xFF is reserved
+        }
+        px = (r & 31) << 11 | (g & 63) << 5 | (b & 31);
+        px_out = swap_bytes ? (uint16_t)(px >> 8 | px << 8) : (uint16_t)px;
+        cache[Q565_HASH(px)] = px_out;
+        *o++ = px_out;
+    }
+    return ESP_OK;
+}
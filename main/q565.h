@@ -0,0 +1,45 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Q565: lossless frame codec for flat-shaded art, after QOI but on RGB565
+// pixels, so a frame decodes without Huffman tables or IDCT. Written by
+// gif-converter/convert.py --codec q565.
+//
+// Stream: 8-byte header ("q565", width and height as little-endian u16), then
+// ops until width * height pixels are out. The decoder starts with prev = 0
+// (black) and a zeroed 64-entry cache of recent pixels at
+// Q565_HASH(px) = (r * 3 + g * 5 + b * 7) % 64, with r/g/b the 5/6/5-bit fields.
+//   00iiiiii              INDEX  px = cache[i]
+//   01rrggbb              DIFF   r, g, b each prev + (field - 2), i.e. -2..1
+//   10gggggg rrrrbbbb     LUMA   dg = field - 32; r = prev + (field - 8) + floor(dg / 2),
+//                                same for b
+//   11nnnnnn (< 0xFE)     RUN    n + 1 (1..62) copies of prev
+//   0xFE hi lo            RGB    px literal, big-endian
+// Every pixel made by DIFF, LUMA or RGB goes into the cache.
+
+#define Q565_MAGIC        "q565"
+#define Q565_HEADER_SIZE  8
+
+#define Q565_OP_INDEX     0x00
+#define Q565_OP_DIFF      0x40
+#define Q565_OP_LUMA      0x80
+#define Q565_OP_RUN       0xC0
+#define Q565_OP_RGB       0xFE
+#define Q565_MASK_2       0xC0
+#define Q565_RUN_MAX      62
+
+#define Q565_HASH(px)     ((((px) >> 11) * 3 + (((px) >> 5) & 63) * 5 + ((px) & 31) * 7) & 63)
+
+// True if 'data' starts with a Q565 header
+bool q565_is_frame(const uint8_t *data, size_t size);
+
+// Frame size from the header
+esp_err_t q565_get_info(const uint8_t *data, size_t size, uint16_t *width, uint16_t *height);
+
+// Decode into 'out' (width * height pixels, row-major). swap_bytes stores each
+// pixel high byte first, as the JPEG path does for the ILI9341.
+esp_err_t q565_decode(const uint8_t *data, size_t size, uint16_t *out, size_t out_pixels, bool swap_bytes);
@@ -0,0 +1,51 @@
+#include "rgb565_blend.h"
+
+// With two pixels p1:p0 in a word (p0 in the low half), LO holds B0, R0 and G1
+// and HI (after >> 5) holds G0, B1 and R1; neither has two channels closer than
+// 5 bits, so a weighted sum of up to 32 never carries into the next channel.
+#define BLEND_MASK_LO   0x07E0F81Fu
+#define BLEND_MASK_HI   0x07C0F83Fu
+#define BLEND_ROUND_LO  0x02008010u   // 16 in each LO channel's weighted sum
+#define BLEND_ROUND_HI  0x04008010u   // ...and in each HI one
+
+static inline uint32_t swap_bytes_x2(uint32_t x)
+{
+    return ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+}
+
+static inline uint32_t blend_word(uint32_t a, uint32_t b, uint32_t wa, uint32_t wb)
+{
+    uint32_t lo = ((a & BLEND_MASK_LO) * wa + (b & BLEND_MASK_LO) * wb + BLEND_ROUND_LO) >> 5;
+    uint32_t hi = ((a >> 5) & BLEND_MASK_HI) * wa + ((b >> 5) & BLEND_MASK_HI) * wb + BLEND_ROUND_HI;
+    return (lo & BLEND_MASK_LO) | (hi & (BLEND_MASK_HI << 5));
+}
+
+void rgb565_blend(const uint16_t *a, const uint16_t *b, uint16_t *dst, size_t count, int weight, bool swapped)
+{
+    const uint32_t wb = (uint32_t)weight;
+    const uint32_t wa = RGB565_BLEND_ONE - wb;
+    const uint32_t *a32 = (const uint32_t *)a;
+    const uint32_t *b32 = (const uint32_t *)b;
+    uint32_t *d32 = (uint32_t *)dst;
+    size_t words = count / 2;
+
+    if (swapped) {
+        for (size_t i = 0; i < words; i++) {
+            d32[i] = swap_bytes_x2(blend_word(swap_bytes_x2(a32[i]), swap_bytes_x2(b32[i]), wa, wb));
+        }
+    } else {
+        for (size_t i = 0; i < words; i++) {
+            d32[i] = blend_word(a32[i], b32[i], wa, wb);
+        }
+    }
+    if (count & 1) {
+        // Odd tail: the same maths with the pixel in the low half
+        uint32_t pa = a[count - 1], pb = b[count - 1];
+        if (swapped) {
+            pa = swap_bytes_x2(pa);
+            pb = swap_bytes_x2(pb);
+        }
+        uint32_t px = blend_word(pa, pb, wa, wb) & 0xFFFFu;
+        dst[count - 1] = (uint16_t)(swapped ? swap_bytes_x2(px) : px);
+    }
+}
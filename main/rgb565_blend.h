@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Cross-fade of two RGB565 frames, used for the in-between frames of
+// CONFIG_T4_TEMPORAL_BLEND. Works on two pixels per 32-bit word: the six
+// channels are split over two masked copies of the word so that every channel
+// has 5 free bits above it, and each copy is weighted with one multiply.
+
+#define RGB565_BLEND_ONE  32   // Weight of 'b' that gives b; 0 gives a
+
+// dst[i] = (a[i] * (32 - weight) + b[i] * weight) / 32 per channel, rounded.
+// 'swapped' means pixels are stored high byte first (the panel order of the
+// decoders). a, b and dst must be 4-byte aligned; dst may alias a or b.
+void rgb565_blend(const uint16_t *a, const uint16_t *b, uint16_t *dst, size_t count, int weight, bool swapped);
@@ -0,0 +1,219 @@
+#include "rgb565_scale.h"
+#include <string.h>
+
+void nn_scale_2x_rgb565(const uint16_t *src, uint16_t *dst, int src_w, int src_h)
+{
+    const int dst_w = src_w * 2;
+    for (int y = 0; y < src_h; y++) {
+        const uint16_t *s_row = src + y * src_w;
+        uint16_t *d_row0 = dst + (y * 2) * dst_w;
+        uint16_t *d_row1 = d_row0 + dst_w;
+        for (int x = 0; x < src_w; x++) {
+            uint16_t pix = s_row[x];
+            int d_idx = x * 2;
+            d_row0[d_idx] = pix;
+            d_row0[d_idx + 1] = pix;
+            d_row1[d_idx] = pix;
+            d_row1[d_idx + 1] = pix;
+        }
+    }
+}
+
+void nn_scale_3x_rgb565(const uint16_t *src, uint16_t *dst, int src_w, int src_h)
+{
+    int dst_w = src_w * 3;
+    for (int y = 0; y < src_h; y++) {
+        const uint16_t *s_row = src + y * src_w;
+        uint16_t *d_row0 = dst + (y * 3) * dst_w;
+        uint16_t *d_row1 = d_row0 + dst_w;
+        uint16_t *d_row2 = d_row1 + dst_w;
+
+        for (int x = 0; x < src_w; x++) {
+            uint16_t pix = s_row[x];
+            int dx = x * 3;
+
+            d_row0[dx] = d_row0[dx + 1] = d_row0[dx + 2] = pix;
+            d_row1[dx] = d_row1[dx + 1] = d_row1[dx + 2] = pix;
+            d_row2[dx] = d_row2[dx + 1] = d_row2[dx + 2] = pix;
+        }
+    }
+}
+
+// Factors above 3 only come from scrub previews
+void nn_scale_band_rgb565(const uint16_t *src, uint16_t *dst, int src_w, int rows, int factor)
+{
+    const int dst_w = src_w * factor;
+    for (int y = 0; y < rows; y++) {
+        const uint16_t *s_row = src + y * src_w;
+        uint16_t *d_row = dst + (y * factor) * dst_w;
+        if (factor == 2) {
+            for (int x = 0; x < src_w; x++) {
+                uint16_t pix = s_row[x];
+                d_row[x * 2] = pix;
+                d_row[x * 2 + 1] = pix;
+            }
+        } else if (factor == 3) {
+            for (int x = 0; x < src_w; x++) {
+                uint16_t pix = s_row[x];
+                d_row[x * 3] = d_row[x * 3 + 1] = d_row[x * 3 + 2] = pix;
+            }
+        } else {
+            for (int x = 0; x < src_w; x++) {
+                for (int k = 0; k < factor; k++) {
+                    d_row[x * factor + k] = s_row[x];
+                }
+            }
+        }
+        for (int r = 1; r < factor; r++) {
+            memcpy(d_row + r * dst_w, d_row, dst_w * sizeof(uint16_t));
+        }
+    }
+}
+
+// A word holds an output pair (left pixel in the low half). Split into LO (B0, R0, G1)
+// and HI (G0, B1, R1 after >> 5), every channel has 5 free bits above it: room for
+// the 3:1 horizontal sum (x4) and then the 3:1 vertical one (x16).
+#define SCALE_MASK_LO      0x07E0F81Fu
+#define SCALE_MASK_HI      0x07C0F83Fu
+#define BILINEAR_ROUND_LO  0x01004008u   // 8 in each LO channel of the x16 sum
+#define BILINEAR_ROUND_HI  0x02004008u
+
+// Horizontal passes of three consecutive source rows, rotated as the band moves down
+static uint32_t s_hpass[3][2][RGB565_BILINEAR_MAX_SRC_W];
+
+static uint16_t s_native_row[RGB565_BILINEAR_MAX_SRC_W];
+
+static inline uint32_t swap_bytes_x2(uint32_t x)
+{
+    return ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+}
+
+static inline __attribute__((always_inline)) void hpass_pair(uint32_t left, uint32_t cur, uint32_t right,
+                                                             uint32_t *lo, uint32_t *hi)
+{
+    uint32_t centre = cur | cur << 16;
+    uint32_t sides = left | right << 16;
+    *lo = (centre & SCALE_MASK_LO) * 3 + (sides & SCALE_MASK_LO);
+    *hi = ((centre >> 5) & SCALE_MASK_HI) * 3 + ((sides >> 5) & SCALE_MASK_HI);
+}
+
+// Output pair x of a row is 3 * s[x] + s[x - 1] (left) and 3 * s[x] + s[x + 1] (right).
+// Edges are done apart so the inner loop has no clamps and no carried state.
+// noinline: keeps a symbol for the IRAM placement profile (main/linker.lf)
+static __attribute__((noinline)) void bilinear_hpass(const uint16_t *row, int src_w, bool swapped, uint32_t *lo, uint32_t *hi)
+{
+    if (swapped) {
+        // Back to native order two pixels per word, so the pass itself has no per-pixel swaps
+        const uint32_t *in = (const uint32_t *)row;
+        uint32_t *out = (uint32_t *)s_native_row;
+        for (int i = 0; i < src_w / 2; i++) {
+            out[i] = swap_bytes_x2(in[i]);
+        }
+        if (src_w & 1) {
+            s_native_row[src_w - 1] = (uint16_t)(row[src_w - 1] << 8 | row[src_w - 1] >> 8);
+        }
+        row = s_native_row;
+    }
+    int last = src_w - 1;
+    hpass_pair(row[0], row[0], row[last > 0 ? 1 : 0], &lo[0], &hi[0]);
+    for (int x = 1; x < last; x++) {
+        hpass_pair(row[x - 1], row[x], row[x + 1], &lo[x], &hi[x]);
+    }
+    if (last > 0) {
+        hpass_pair(row[last - 1], row[last], row[last], &lo[last], &hi[last]);
+    }
+}
+
+static inline __attribute__((always_inline)) uint32_t bilinear_pack(uint32_t lo, uint32_t hi, bool swapped)
+{
+    uint32_t px = (((lo + BILINEAR_ROUND_LO) >> 4) & SCALE_MASK_LO) |
+                  (((hi + BILINEAR_ROUND_HI) << 1) & (SCALE_MASK_HI << 5));
+    return swapped ? swap_bytes_x2(px) : px;
+}
+
+// Vertical pass: 3 * the row's own horizontal pass plus the one above (even output row) or below (odd)
+static inline __attribute__((always_inline)) void vpass_rows(const uint32_t *ulo, const uint32_t *uhi,
+                                                             const uint32_t *mlo, const uint32_t *mhi,
+                                                             const uint32_t *dlo, const uint32_t *dhi,
+                                                             uint32_t *d_row0, uint32_t *d_row1, int n, bool swapped)
+{
+    for (int x = 0; x < n; x++) {
+        uint32_t clo = mlo[x] * 3, chi = mhi[x] * 3;
+        d_row0[x] = bilinear_pack(clo + ulo[x], chi + uhi[x], swapped);
+        d_row1[x] = bilinear_pack(clo + dlo[x], chi + dhi[x], swapped);
+    }
+}
+
+void bilinear_scale_2x_rgb565(const uint16_t *src, uint16_t *dst, int src_w, int src_h, int y0, int rows,
+                              bool swapped)
+{
+    const int dst_words = src_w;   // One output pair per source pixel
+    int up = 0, mid = 1, down = 2;
+    bilinear_hpass(src + (y0 > 0 ? y0 - 1 : 0) * src_w, src_w, swapped, s_hpass[up][0], s_hpass[up][1]);
+    bilinear_hpass(src + y0 * src_w, src_w, swapped, s_hpass[mid][0], s_hpass[mid][1]);
+
+    for (int y = y0; y < y0 + rows; y++) {
+        int below = y + 1 < src_h ? y + 1 : y;
+        bilinear_hpass(src + below * src_w, src_w, swapped, s_hpass[down][0], s_hpass[down][1]);
+
+        const uint32_t *ulo = s_hpass[up][0], *uhi = s_hpass[up][1];
+        const uint32_t *mlo = s_hpass[mid][0], *mhi = s_hpass[mid][1];
+        const uint32_t *dlo = s_hpass[down][0], *dhi = s_hpass[down][1];
+        uint32_t *d_row0 = (uint32_t *)(dst + (y - y0) * 2 * (src_w * 2));
+        uint32_t *d_row1 = d_row0 + dst_words;
+        if (swapped) {
+            vpass_rows(ulo, uhi, mlo, mhi, dlo, dhi, d_row0, d_row1, src_w, true);
+        } else {
+            vpass_rows(ulo, uhi, mlo, mhi, dlo, dhi, d_row0, d_row1, src_w, false);
+        }
+
+        int spent = up;
+        up = mid;
+        mid = down;
+        down = spent;
+    }
+}
+
+// Source index under the centre of output pixel d, out of 'out_len' pixels covering 'src_len'
+// (offset by 'crop' output pixels when the scaled frame is cropped)
+static void scale_map_axis(uint16_t *idx, int dst_len, int crop, int out_len, int src_len)
+{
+    for (int d = 0; d < dst_len; d++) {
+        int s = (int)(((int64_t)(2 * (d + crop) + 1) * src_len) / (2 * out_len));
+        idx[d] = (uint16_t)(s < src_len ? s : src_len - 1);
+    }
+}
+
+void rgb565_scale_map_init(rgb565_scale_map_t *map, int src_w, int src_h, int target_w, int target_h, bool fill)
+{
+    // Width decides the ratio when target_w / src_w is the smaller one (fit) or the larger one (fill)
+    bool by_width = ((int64_t)target_w * src_h <= (int64_t)target_h * src_w) != fill;
+    int scaled_w = by_width ? target_w : (int)(((int64_t)src_w * target_h + src_h / 2) / src_h);
+    int scaled_h = by_width ? (int)(((int64_t)src_h * target_w + src_w / 2) / src_w) : target_h;
+
+    map->src_w = (uint16_t)src_w;
+    map->src_h = (uint16_t)src_h;
+    map->fill = fill;
+    map->dst_w = (uint16_t)(scaled_w < target_w ? scaled_w : target_w);
+    map->dst_h = (uint16_t)(scaled_h < target_h ? scaled_h : target_h);
+    scale_map_axis(map->col, map->dst_w, (scaled_w - map->dst_w) / 2, scaled_w, src_w);
+    scale_map_axis(map->row, map->dst_h, (scaled_h - map->dst_h) / 2, scaled_h, src_h);
+}
+
+void table_scale_rows_rgb565(const uint16_t *src, uint16_t *dst, const rgb565_scale_map_t *map, int dy0, int rows)
+{
+    const int dst_w = map->dst_w;
+    const uint16_t *col = map->col;
+    for (int y = 0; y < rows; y++) {
+        uint16_t *d_row = dst + y * dst_w;
+        int sy = map->row[dy0 + y];
+        if (y > 0 && sy == map->row[dy0 + y - 1]) {
+            memcpy(d_row, d_row - dst_w, dst_w * sizeof(uint16_t));
+            continue;
+        }
+        const uint16_t *s_row = src + sy * map->src_w;
+        for (int x = 0; x < dst_w; x++) {
+            d_row[x] = s_row[col[x]];
+        }
+    }
+}
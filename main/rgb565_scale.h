@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Upscalers for RGB565 frames: integer factors, plus index tables for any other
+// ratio. Destinations are packed: each output row follows the previous one directly.
+
+// Widest source frame the bilinear scaler takes (2x gives the 320-pixel display)
+#define RGB565_BILINEAR_MAX_SRC_W  160
+
+// Largest output of the index-table scaler (the logical display)
+#define RGB565_SCALE_MAX_DST_W     320
+#define RGB565_SCALE_MAX_DST_H     240
+
+// Source column of every output column and source row of every output row,
+// for one source size scaled to fit (letterboxed) or fill (centre-cropped) a target
+typedef struct {
+    uint16_t src_w, src_h;
+    uint16_t dst_w, dst_h;     // Output size: fit keeps the aspect within the target, fill is the target
+    bool fill;
+    uint16_t col[RGB565_SCALE_MAX_DST_W];
+    uint16_t row[RGB565_SCALE_MAX_DST_H];
+} rgb565_scale_map_t;
+
+// Nearest-neighbour 2x / 3x of a whole frame
+void nn_scale_2x_rgb565(const uint16_t *src, uint16_t *dst, int src_w, int src_h);
+void nn_scale_3x_rgb565(const uint16_t *src, uint16_t *dst, int src_w, int src_h);
+
+// Nearest-neighbour of 'rows' source rows, 'factor' times in both directions;
+// only the first copy of each row is computed, the rest are memcpy
+void nn_scale_band_rgb565(const uint16_t *src, uint16_t *dst, int src_w, int rows, int factor);
+
+// Bilinear 2x of source rows [y0, y0 + rows) of a src_w x src_h frame into
+// 2 * rows destination rows; rows y0 - 1 and y0 + rows are read when they exist.
+// Each output pixel is 9/16 of its source pixel and 3/16, 3/16, 1/16 of the
+// neighbours towards it (edges clamped), computed two pixels per 32-bit word in
+// fixed point. 'swapped': pixels are stored high byte first (panel order).
+// src_w <= RGB565_BILINEAR_MAX_SRC_W; src and dst must be 4-byte aligned.
+void bilinear_scale_2x_rgb565(const uint16_t *src, uint16_t *dst, int src_w, int src_h, int y0, int rows,
+                              bool swapped);
+
+// Build the index tables for src_w x src_h into target_w x target_h (at most
+// RGB565_SCALE_MAX_DST_*). Output pixels sample the source pixel under their centre.
+void rgb565_scale_map_init(rgb565_scale_map_t *map, int src_w, int src_h, int target_w, int target_h, bool fill);
+
+// Output rows [dy0, dy0 + rows) of 'map' into a packed dst (map->dst_w stride).
+// A row that samples the same source row as the one above it is a memcpy.
+void table_scale_rows_rgb565(const uint16_t *src, uint16_t *dst, const rgb565_scale_map_t *map, int dy0, int rows);
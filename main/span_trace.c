@@ -0,0 +1,145 @@
+#include "span_trace.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_crc.h"
+#include <string.h>
+
+#if CONFIG_T4_SPAN_TRACE
+#include "tjpgd.h"
+
+static const char *TAG = "SPAN";
+
+#define SPAN_RING_LEN   CONFIG_T4_SPAN_TRACE_RING_LEN
+#define SPAN_RING_MASK  (SPAN_RING_LEN - 1)
+_Static_assert((SPAN_RING_LEN & SPAN_RING_MASK) == 0, "T4_SPAN_TRACE_RING_LEN must be a power of two");
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint16_t version;
+    uint16_t record_size;
+    uint16_t cores;
+    uint16_t reserved;
+} span_dump_header_t;
+
+// Followed by 'count' span_event_t, oldest first
+typedef struct __attribute__((packed)) {
+    uint32_t core;
+    uint32_t count;
+    uint32_t dropped;   // Events overwritten since the last dump
+} span_dump_core_t;
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint32_t crc32;     // esp_rom_crc32_le over everything between header and trailer
+} span_dump_trailer_t;
+
+// One ring per core: only tasks and ISRs on that core write it, and they
+// reserve slots with an atomic increment, so recording never takes a lock
+static span_event_t *s_rings[portNUM_PROCESSORS];
+static uint32_t s_head[portNUM_PROCESSORS];     // Total events ever reserved
+static uint32_t s_dumped[portNUM_PROCESSORS];   // s_head at the last dump
+
+esp_err_t span_trace_init(void)
+{
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        if (s_rings[core]) {
+            continue;
+        }
+        // Written from the colour-done ISR, so keep the rings in internal RAM
+        s_rings[core] = heap_caps_calloc(SPAN_RING_LEN, sizeof(span_event_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (!s_rings[core]) {
+            ESP_LOGE(TAG, "❌ Failed to allocate span ring for core %d", core);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    ESP_LOGI(TAG, "🧵 Span trace: %d events per core, send '%c' on the console UART to dump",
+             SPAN_RING_LEN, SPAN_TRACE_DUMP_CMD);
+    return ESP_OK;
+}
+
+void IRAM_ATTR span_trace_record(span_id_t id, uint8_t phase, uint32_t arg)
+{
+    uint32_t core = (uint32_t)xPortGetCoreID();
+    span_event_t *ring = s_rings[core];
+    if (!ring) {
+        return;
+    }
+    uint32_t slot = __atomic_fetch_add(&s_head[core], 1, __ATOMIC_RELAXED) & SPAN_RING_MASK;
+    ring[slot].ts_us = (uint32_t)esp_timer_get_time();
+    ring[slot].id = (uint16_t)id;
+    ring[slot].phase = phase;
+    ring[slot].core = (uint8_t)core;
+    ring[slot].arg = arg;
+}
+
+// Decoder stages reported by esp_jpeg (CONFIG_JD_TRACE)
+#if JD_TRACE
+void jd_trace(uint8_t point, uint8_t begin, uint16_t arg)
+{
+    static const span_id_t ids[] = {
+        [JD_TRACE_PREPARE] = SPAN_JD_PREPARE,
+        [JD_TRACE_DECOMP] = SPAN_JD_DECOMP,
+        [JD_TRACE_MCU_ROW] = SPAN_MCU_ROW,
+    };
+    if (point < sizeof(ids) / sizeof(ids[0])) {
+        span_trace_record(ids[point], begin ? SPAN_PHASE_BEGIN : SPAN_PHASE_END, arg);
+    }
+}
+#endif
+
+void span_trace_dump(span_trace_write_fn write, void *ctx)
+{
+    span_dump_header_t hdr = {
+        .version = SPAN_TRACE_VERSION,
+        .record_size = sizeof(span_event_t),
+        .cores = portNUM_PROCESSORS,
+    };
+    memcpy(hdr.magic, SPAN_TRACE_MAGIC, sizeof(hdr.magic));
+    write(&hdr, sizeof(hdr), ctx);
+
+    uint32_t crc = 0;
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        // Events recorded while we write may overwrite the oldest ones; the host tool drops stray ends
+        uint32_t head = __atomic_load_n(&s_head[core], __ATOMIC_ACQUIRE);
+        uint32_t pending = head - s_dumped[core];
+        span_dump_core_t info = {
+            .core = (uint32_t)core,
+            .count = pending < SPAN_RING_LEN ? pending : SPAN_RING_LEN,
+            .dropped = pending > SPAN_RING_LEN ? pending - SPAN_RING_LEN : 0,
+        };
+        crc = esp_rom_crc32_le(crc, (const uint8_t *)&info, sizeof(info));
+        write(&info, sizeof(info), ctx);
+
+        // Oldest event first; the ring may wrap so write it in up to two pieces
+        const span_event_t *ring = s_rings[core];
+        uint32_t tail = (head - info.count) & SPAN_RING_MASK;
+        uint32_t first = (tail + info.count <= SPAN_RING_LEN) ? info.count : SPAN_RING_LEN - tail;
+        if (ring && first) {
+            crc = esp_rom_crc32_le(crc, (const uint8_t *)&ring[tail], first * sizeof(span_event_t));
+            write(&ring[tail], first * sizeof(span_event_t), ctx);
+        }
+        if (ring && first < info.count) {
+            crc = esp_rom_crc32_le(crc, (const uint8_t *)ring, (info.count - first) * sizeof(span_event_t));
+            write(ring, (info.count - first) * sizeof(span_event_t), ctx);
+        }
+        s_dumped[core] = head;
+    }
+
+    span_dump_trailer_t trailer = { .crc32 = crc };
+    memcpy(trailer.magic, SPAN_TRACE_END_MAGIC, sizeof(trailer.magic));
+    write(&trailer, sizeof(trailer), ctx);
+}
+#else
+esp_err_t span_trace_init(void)
+{
+    return ESP_OK;
+}
+
+void span_trace_dump(span_trace_write_fn write, void *ctx)
+{
+}
+#endif
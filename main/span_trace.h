@@ -0,0 +1,64 @@
+#pragma once
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Begin/end spans of the decode/display pipeline, recorded with a timestamp and
+// the core ID into one lock-free ring per core. Enable with CONFIG_T4_SPAN_TRACE;
+// otherwise the macros compile to nothing. Dump with 'S' on the console UART and
+// convert with tools/trace_to_chrome.py.
+
+// Byte received on the console UART that triggers a dump (see perf_telemetry_poll)
+#define SPAN_TRACE_DUMP_CMD   'S'
+
+// Dump framing (see tools/trace_to_chrome.py for the host-side parser)
+#define SPAN_TRACE_MAGIC      "T4TR"
+#define SPAN_TRACE_END_MAGIC  "T4TE"
+#define SPAN_TRACE_VERSION    1
+
+// Span IDs; names and meaning of 'arg' are listed in tools/trace_to_chrome.py
+typedef enum {
+    SPAN_FRAME = 0,     // One manifest frame, decode to draw submission (arg: frame index)
+    SPAN_JD_PREPARE,    // jd_prepare
+    SPAN_JD_DECOMP,     // jd_decomp
+    SPAN_MCU_ROW,       // One row of MCUs inside jd_decomp (arg: top line)
+    SPAN_SCALE,         // Upscaling a frame or a band (arg: first source row)
+    SPAN_DRAW_SUBMIT,   // esp_lcd_panel_draw_bitmap call (arg: draw sequence number)
+    SPAN_DMA_DONE,      // Instant: colour transfer finished, from the ISR (arg: draw sequence number)
+    SPAN_SLEEP,         // Pacing delay (arg: frame index)
+    SPAN_Q565_DECODE,   // q565_decode of a whole frame
+    SPAN_ID_COUNT
+} span_id_t;
+
+#define SPAN_PHASE_BEGIN   'B'
+#define SPAN_PHASE_END     'E'
+#define SPAN_PHASE_INSTANT 'i'
+
+// Layout is fixed (little-endian, packed) because it is parsed on the host
+typedef struct __attribute__((packed)) {
+    uint32_t ts_us;   // esp_timer_get_time(), low 32 bits (the host tool unwraps)
+    uint16_t id;      // span_id_t
+    uint8_t phase;    // SPAN_PHASE_*
+    uint8_t core;     // Core the event was recorded on
+    uint32_t arg;
+} span_event_t;
+
+#if CONFIG_T4_SPAN_TRACE
+void span_trace_record(span_id_t id, uint8_t phase, uint32_t arg);
+#define SPAN_BEGIN(id, arg)   span_trace_record((id), SPAN_PHASE_BEGIN, (uint32_t)(arg))
+#define SPAN_END(id, arg)     span_trace_record((id), SPAN_PHASE_END, (uint32_t)(arg))
+#define SPAN_INSTANT(id, arg) span_trace_record((id), SPAN_PHASE_INSTANT, (uint32_t)(arg))
+#else
+#define SPAN_BEGIN(id, arg)   ((void)0)
+#define SPAN_END(id, arg)     ((void)0)
+#define SPAN_INSTANT(id, arg) ((void)0)
+#endif
+
+// Allocate the per-core rings (no-op when tracing is disabled)
+esp_err_t span_trace_init(void);
+
+// Write every event recorded since the last dump through 'write' and start over
+typedef void (*span_trace_write_fn)(const void *data, size_t len, void *ctx);
+void span_trace_dump(span_trace_write_fn write, void *ctx);
@@ -0,0 +1,120 @@
+#include "speed_control.h"
+#include "encoder.h"
+#include "esp_log.h"
+
+static const char *TAG = "SPEED";
+
+static speed_control_t s_speed;
+
+// Each quick reversal extends a wiggle; anything else may start one. Returns true on a start.
+static bool wiggle_track(speed_control_t *ctl, const encoder_event_t *ev)
+{
+    if (ctl->last_dir == -ev->dir && ev->ts_us - ctl->last_ts_us < SPEED_WIGGLE_GAP_US) {
+        ctl->wiggle++;
+        return false;
+    }
+    ctl->wiggle = 1;
+    ctl->wiggle_dir = ev->dir;
+    return true;
+}
+
+// Once the detent is recorded: a complete wiggle becomes a clip switch
+static bool wiggle_done(speed_control_t *ctl)
+{
+    if (ctl->wiggle != SPEED_WIGGLE_DETENTS) {
+        return false;
+    }
+    // The next detent starts afresh rather than extending this wiggle
+    ctl->clip_steps += ctl->wiggle_dir;
+    ctl->wiggle = 0;
+    ctl->last_dir = 0;
+    return true;
+}
+
+uint32_t speed_control_step(speed_control_t *ctl, uint32_t delay_ms, const encoder_event_t *ev)
+{
+    if (wiggle_track(ctl, ev)) {
+        ctl->wiggle_delay_ms = delay_ms;
+    }
+
+    // Velocity from the gap to the previous detent; a reversal starts over slow
+    uint32_t step = SPEED_STEP_MIN_MS;
+    if (ctl->last_dir == ev->dir) {
+        uint32_t gap_us = ev->ts_us - ctl->last_ts_us;
+        step = gap_us ? SPEED_STEP_MIN_MS * SPEED_SLOW_DETENT_US / gap_us : SPEED_STEP_MAX_MS;
+        if (step < SPEED_STEP_MIN_MS) step = SPEED_STEP_MIN_MS;
+        if (step > SPEED_STEP_MAX_MS) step = SPEED_STEP_MAX_MS;
+    }
+    ctl->last_ts_us = ev->ts_us;
+    ctl->last_dir = ev->dir;
+
+    if (wiggle_done(ctl)) {
+        return ctl->wiggle_delay_ms;
+    }
+
+    int32_t new_delay = (int32_t)delay_ms + ev->dir * (int32_t)step;
+    if (new_delay < SPEED_DELAY_MIN_MS) new_delay = SPEED_DELAY_MIN_MS;
+    if (new_delay > SPEED_DELAY_MAX_MS) new_delay = SPEED_DELAY_MAX_MS;
+    return (uint32_t)new_delay;
+}
+
+uint32_t speed_control_poll(uint32_t delay_ms)
+{
+    encoder_event_t ev;
+    uint32_t new_delay = delay_ms;
+    int detents = 0;
+    while (encoder_get_event(&ev)) {
+        new_delay = speed_control_step(&s_speed, new_delay, &ev);
+        detents++;
+    }
+    if (new_delay != delay_ms) {
+        ESP_LOGI(TAG, "🎛️ Frame delay %lu -> %lu ms (%d detents)", (unsigned long)delay_ms, (unsigned long)new_delay, detents);
+    }
+    return new_delay;
+}
+
+int speed_control_take_clip_steps(void)
+{
+    int steps = s_speed.clip_steps;
+    s_speed.clip_steps = 0;
+    return steps;
+}
+
+int speed_control_scrub_step(speed_control_t *ctl, const encoder_event_t *ev)
+{
+    if (wiggle_track(ctl, ev)) {
+        ctl->wiggle_frames = 0;
+    }
+
+    // Same velocity measure as the delay steps: one frame per detent at SPEED_SLOW_DETENT_US and slower
+    int frames = 1;
+    if (ctl->last_dir == ev->dir) {
+        uint32_t gap_us = ev->ts_us - ctl->last_ts_us;
+        frames = gap_us ? (int)(SPEED_SLOW_DETENT_US / gap_us) : SCRUB_FRAMES_MAX;
+        if (frames < 1) frames = 1;
+        if (frames > SCRUB_FRAMES_MAX) frames = SCRUB_FRAMES_MAX;
+    }
+    ctl->last_ts_us = ev->ts_us;
+    ctl->last_dir = ev->dir;
+
+    if (wiggle_done(ctl)) {
+        return -ctl->wiggle_frames;   // Back to where the wiggle started
+    }
+    ctl->wiggle_frames += ev->dir * frames;
+    return ev->dir * frames;
+}
+
+int speed_control_poll_scrub(void)
+{
+    encoder_event_t ev;
+    int frames = 0;
+    while (encoder_get_event(&ev)) {
+        frames += speed_control_scrub_step(&s_speed, &ev);
+    }
+    return frames;
+}
+
+bool speed_control_scrubbing(uint32_t now_us)
+{
+    return s_speed.last_dir != 0 && now_us - s_speed.last_ts_us < SCRUB_SETTLE_US;
+}
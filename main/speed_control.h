@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "encoder_core.h"
+
+// Knob -> frame delay model shared by app_main and the player loop. Clockwise
+// slows playback down. The step per detent grows with turning speed: a slow
+// turn moves SPEED_STEP_MIN_MS, a fast spin up to SPEED_STEP_MAX_MS, so one
+// flick crosses the whole range while single clicks still fine-tune.
+#define SPEED_DELAY_MIN_MS    30   // Fastest playback
+#define SPEED_DELAY_MAX_MS    150  // Slowest playback
+#define SPEED_STEP_MIN_MS     2
+#define SPEED_STEP_MAX_MS     24
+#define SPEED_SLOW_DETENT_US  40000  // Detent interval at or above which steps are SPEED_STEP_MIN_MS
+
+// A quick wiggle (SPEED_WIGGLE_DETENTS detents, each reversing the previous
+// one within SPEED_WIGGLE_GAP_US) switches clip instead: next if it starts
+// clockwise, previous otherwise. The frame delay goes back to what it was, or
+// in scrub mode the playhead to where the wiggle started.
+#define SPEED_WIGGLE_DETENTS  3
+#define SPEED_WIGGLE_GAP_US   150000
+
+// With CONFIG_T4_KNOB_SCRUB the knob moves the playhead instead: a detent steps
+// one frame when turned slowly and up to SCRUB_FRAMES_MAX on a fast spin. The
+// player shows reduced-resolution previews until no detent has arrived for
+// SCRUB_SETTLE_US.
+#define SCRUB_FRAMES_MAX      8
+#define SCRUB_SETTLE_US       150000
+
+typedef struct {
+    uint32_t last_ts_us;  // Timestamp of the previous detent
+    int8_t last_dir;      // 0 until the first detent
+    uint8_t wiggle;       // Alternating detents so far
+    int8_t wiggle_dir;    // Direction of the wiggle's first detent
+    uint32_t wiggle_delay_ms;  // Frame delay before the wiggle started
+    int wiggle_frames;    // Frames scrubbed since the wiggle started
+    int clip_steps;       // Clip switches from wiggles, not yet taken
+} speed_control_t;
+
+// Apply one detent to 'delay_ms'; returns the new, clamped delay. A completed
+// wiggle adds to ctl->clip_steps and returns the delay from before it.
+uint32_t speed_control_step(speed_control_t *ctl, uint32_t delay_ms, const encoder_event_t *ev);
+
+// Drain every pending encoder detent into 'delay_ms' without blocking. Returns
+// the new delay, or 'delay_ms' unchanged if the knob has not moved.
+uint32_t speed_control_poll(uint32_t delay_ms);
+
+// Clip switches (+1 next, -1 previous, summed) wiggled since the last call
+int speed_control_take_clip_steps(void);
+
+// Frames one detent moves the playhead (signed, clockwise forward). A completed
+// wiggle adds to ctl->clip_steps and returns the frames that undo it.
+int speed_control_scrub_step(speed_control_t *ctl, const encoder_event_t *ev);
+
+// Drain every pending detent as scrub steps; returns the net frames to move
+int speed_control_poll_scrub(void);
+
+// True while detents are still arriving (the last one under SCRUB_SETTLE_US before now_us)
+bool speed_control_scrubbing(uint32_t now_us);
@@ -0,0 +1,165 @@
+#include "storage_bench.h"
+#include "frame_source.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "STORAGE_BENCH";
+
+#define BENCH_NAME_MAX 128
+
+typedef struct {
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t ops;
+    uint32_t failed;
+} bench_op_t;
+
+static void op_record(bench_op_t *op, int64_t start, bool ok)
+{
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+    if (!ok) {
+        op->failed++;
+        return;
+    }
+    op->ops++;
+    op->total_us += elapsed;
+    if (elapsed < op->min_us) op->min_us = elapsed;
+    if (elapsed > op->max_us) op->max_us = elapsed;
+}
+
+static void op_log(const char *what, const bench_op_t *op)
+{
+    if (op->ops == 0) {
+        ESP_LOGE(TAG, "❌ %-10s every call failed", what);
+        return;
+    }
+    ESP_LOGI(TAG, "📊 %-10s min=%lu us avg=%lu us max=%lu us failed=%lu", what,
+             (unsigned long)op->min_us, (unsigned long)(op->total_us / op->ops),
+             (unsigned long)op->max_us, (unsigned long)op->failed);
+}
+
+// Frame names from the manifest, prefixed with its directory like the player does
+static int load_frame_names(const char *manifest_name, char (**names)[BENCH_NAME_MAX])
+{
+    uint8_t *manifest = NULL;
+    size_t len = 0;
+    if (frame_source_load(manifest_name, MALLOC_CAP_8BIT, &manifest, &len) != ESP_OK) {
+        return -1;
+    }
+    int lines = 1;
+    for (size_t i = 0; i < len; i++) {
+        lines += manifest[i] == '\n';
+    }
+    *names = malloc((size_t)lines * BENCH_NAME_MAX);
+    if (!*names) {
+        heap_caps_free(manifest);
+        return -1;
+    }
+
+    const char *slash = strrchr(manifest_name, '/');
+    int dir_len = slash ? (int)(slash - manifest_name + 1) : 0;
+    int count = 0;
+    for (char *line = strtok((char *)manifest, "\r\n"); line && count < lines; line = strtok(NULL, "\r\n")) {
+        char file[BENCH_NAME_MAX];
+        if (sscanf(line, "%127s", file) != 1) {
+            continue;
+        }
+        int written = snprintf((*names)[count], BENCH_NAME_MAX, "%.*s%s", dir_len, manifest_name, file);
+        if (written > 0 && written < BENCH_NAME_MAX) {
+            count++;
+        }
+    }
+    heap_caps_free(manifest);
+    return count;
+}
+
+esp_err_t storage_bench_run(const char *manifest_name, int passes)
+{
+    const frame_source_t *source = frame_source_current();
+    if (source == NULL || manifest_name == NULL || passes <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char (*names)[BENCH_NAME_MAX] = NULL;
+    int num_frames = load_frame_names(manifest_name, &names);
+    if (num_frames <= 0) {
+        ESP_LOGE(TAG, "❌ No frames in %s", manifest_name);
+        free(names);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Largest frame sizes the read buffer; frames are read whole, as at preload
+    size_t max_size = 0;
+    for (int i = 0; i < num_frames; i++) {
+        size_t size = 0;
+        if (frame_source_stat(names[i], &size) == ESP_OK && size > max_size) {
+            max_size = size;
+        }
+    }
+    uint8_t *buf = max_size ? heap_caps_malloc(max_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : NULL;
+    if (!buf) {
+        ESP_LOGE(TAG, "❌ Failed to allocate %lu byte read buffer", (unsigned long)max_size);
+        free(names);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "⏱️ %s: %d frames x %d passes", source->name, num_frames, passes);
+
+    bench_op_t stat_op = { .min_us = UINT32_MAX };
+    bench_op_t open_op = { .min_us = UINT32_MAX };
+    bench_op_t read_op = { .min_us = UINT32_MAX };
+    uint64_t read_bytes = 0;
+
+    for (int p = 0; p < passes; p++) {
+        for (int i = 0; i < num_frames; i++) {
+            size_t size;
+            int64_t start = esp_timer_get_time();
+            op_record(&stat_op, start, frame_source_stat(names[i], &size) == ESP_OK);
+        }
+        for (int i = 0; i < num_frames; i++) {
+            frame_file_t file;
+            int64_t start = esp_timer_get_time();
+            bool ok = frame_source_open(names[i], &file) == ESP_OK;
+            if (ok) {
+                frame_source_close(&file);
+            }
+            op_record(&open_op, start, ok);
+        }
+        for (int i = 0; i < num_frames; i++) {
+            frame_file_t file;
+            int64_t start = esp_timer_get_time();
+            bool ok = frame_source_open(names[i], &file) == ESP_OK;
+            if (ok) {
+                ok = file.size <= max_size && frame_source_read(&file, buf, file.size) == file.size;
+                read_bytes += ok ? file.size : 0;
+                frame_source_close(&file);
+            }
+            op_record(&read_op, start, ok);
+
+            // Yield now and then so the idle task still runs
+            if (i % 10 == 9) {
+                vTaskDelay(1);
+            }
+        }
+    }
+
+    op_log("stat", &stat_op);
+    op_log("open+close", &open_op);
+    op_log("read", &read_op);
+    if (read_op.total_us > 0) {
+        ESP_LOGI(TAG, "🚚 Sequential read: %llu bytes in %llu us = %.2f MB/s",
+                 (unsigned long long)read_bytes, (unsigned long long)read_op.total_us,
+                 (double)read_bytes / (double)read_op.total_us);
+    }
+
+    heap_caps_free(buf);
+    free(names);
+    return stat_op.ops && open_op.ops && read_op.ops ? ESP_OK : ESP_FAIL;
+}
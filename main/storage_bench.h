@@ -0,0 +1,8 @@
+#pragma once
+
+#include "esp_err.h"
+
+// Time the current frame source on every frame of a manifest, 'passes' times:
+// stat, open+close, and a sequential open/read/close pass (MB/s). Run it once
+// per CONFIG_T4_FRAME_SOURCE backend and compare the logs.
+esp_err_t storage_bench_run(const char *manifest_name, int passes);
@@ -0,0 +1,160 @@
+"""
+tjpgd configuration benchmark
+
+Usage:
+    python decoder_bench.py build-host [--json results.json] [--baseline tools/decoder_bench_baseline.json]
+    python decoder_bench.py build-host --summary-only --json tools/decoder_bench_baseline.json
+
+Runs every jd_bench_<config> binary of the host build (host/CMakeLists.txt
+builds one per combination of JD_FASTDECODE, JD_TBLCLIP, JD_USE_SCALE,
+JD_SZBUF and JD_FORMAT), each of which decodes test.jpg and the whole
+data/output corpus. Prints frames/s, µs per MCU, peak work-pool bytes and an
+output checksum per configuration, and writes all results as JSON.
+
+With --baseline, every configuration is compared against a stored result:
+speed changes beyond --tolerance are flagged, and any checksum change is
+reported (per frame when the baseline has per-frame checksums), because the
+decoder output is expected to stay bit-exact. The committed baseline is a
+--summary-only run; its frames/s are only meaningful on the machine that
+recorded it, the checksums hold everywhere.
+
+--data points the binaries at another corpus (e.g. one written by
+gray_bench --write). --agree checks that configurations differing only in
+JD_FASTDECODE (levels 1 and up, which share the 16-bit sample path) decode
+it to the same checksum.
+"""
+
+import argparse
+import glob
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+
+def run_configs(build_dir, passes, match, data_dir=None):
+    results = []
+    binaries = sorted(glob.glob(os.path.join(build_dir, "jd_bench_*")))
+    binaries = [b for b in binaries if os.access(b, os.X_OK) and (not match or match in b)]
+    if not binaries:
+        print(f"❌ No jd_bench_* binaries in {build_dir} (build the host tree first)")
+        sys.exit(1)
+    with tempfile.TemporaryDirectory() as tmp:
+        for i, binary in enumerate(binaries):
+            out = os.path.join(tmp, "result.json")
+            cmd = [binary, "--passes", str(passes), "--json", out]
+            if data_dir:
+                cmd += ["--data", data_dir]
+            proc = subprocess.run(cmd, capture_output=True, text=True)
+            if not os.path.exists(out):
+                print(f"⚠️  {os.path.basename(binary)} failed: {proc.stderr.strip()}")
+                continue
+            with open(out) as f:
+                results.append(json.load(f))
+            os.remove(out)
+            print(f"   [{i + 1}/{len(binaries)}] {results[-1]['config']}", file=sys.stderr)
+    return results
+
+
+def print_table(results, baseline):
+    base = {r["config"]: r for r in baseline} if baseline else {}
+    print(f"{'config':<30}{'frames/s':>10}{'us/MCU':>9}{'pool B':>9}{'crc':>10}{'errors':>7}"
+          + (f"{'Δ fps':>9}  output" if base else ""))
+    for r in sorted(results, key=lambda r: -r["frames_per_s"]):
+        line = (f"{r['config']:<30}{r['frames_per_s']:>10.1f}{r['us_per_mcu']:>9.3f}"
+                f"{r['pool_bytes_max']:>9}{r['corpus_crc']:>10}{r['errors']:>7}")
+        b = base.get(r["config"])
+        if b:
+            delta = (r["frames_per_s"] / b["frames_per_s"] - 1) * 100 if b["frames_per_s"] else 0
+            same = r["corpus_crc"] == b["corpus_crc"]
+            line += f"{delta:>+8.1f}%  {'same' if same else 'CHANGED'}"
+        elif base:
+            line += f"{'new':>9}"
+        print(line)
+
+
+def compare(results, baseline, tolerance):
+    """Return the number of regressions against the baseline"""
+    base = {r["config"]: r for r in baseline}
+    problems = 0
+    for r in results:
+        b = base.get(r["config"])
+        if not b:
+            continue
+        if r["corpus_crc"] != b["corpus_crc"]:
+            if "checksums" in b:
+                changed = [name for name, crc in r["checksums"].items() if b["checksums"].get(name) != crc]
+                print(f"❌ {r['config']}: output changed in {len(changed)} frames (e.g. {', '.join(changed[:3])})")
+            else:
+                print(f"❌ {r['config']}: output checksum {r['corpus_crc']} vs baseline {b['corpus_crc']}")
+            problems += 1
+        if b["frames_per_s"] and r["frames_per_s"] < b["frames_per_s"] * (1 - tolerance / 100):
+            print(f"⚠️  {r['config']}: {r['frames_per_s']:.1f} frames/s vs baseline {b['frames_per_s']:.1f}")
+            problems += 1
+    return problems
+
+
+def disagreements(results):
+    """Return the number of configuration groups whose JD_FASTDECODE levels (1 and up) decode differently"""
+    groups = {}
+    for r in results:
+        opts = dict(r["options"])
+        if opts.pop("JD_FASTDECODE") >= 1:
+            groups.setdefault(tuple(sorted(opts.items())), []).append(r)
+    problems = 0
+    for group in groups.values():
+        if len(group) < 2:
+            print(f"❌ {group[0]['config']}: no other JD_FASTDECODE level to compare with")
+            problems += 1
+            continue
+        crcs = {r["corpus_crc"] for r in group}
+        if len(crcs) > 1:
+            print("❌ " + ", ".join(f"{r['config']}={r['corpus_crc']}" for r in group))
+            problems += 1
+        if any(r["errors"] for r in group):
+            print("❌ decode errors in " + ", ".join(r["config"] for r in group if r["errors"]))
+            problems += 1
+    return problems
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark tjpgd configurations on the host build.")
+    parser.add_argument('build_dir', help='Host build directory containing the jd_bench_* binaries')
+    parser.add_argument('--passes', type=int, default=3, help='Timed passes per configuration, best is kept (default: 3)')
+    parser.add_argument('--match', type=str, help='Only run configurations whose name contains this string')
+    parser.add_argument('--json', type=str, help='Write all results to this JSON file')
+    parser.add_argument('--summary-only', action='store_true',
+                        help='Leave the per-frame checksums out of --json (for a compact baseline file)')
+    parser.add_argument('--data', type=str, help='Corpus directory for the binaries (default: their built-in data/)')
+    parser.add_argument('--agree', action='store_true',
+                        help='Fail unless every JD_FASTDECODE level >= 1 gives the same checksum per configuration')
+    parser.add_argument('--baseline', type=str, help='JSON results to compare against')
+    parser.add_argument('--tolerance', type=float, default=10.0,
+                        help='Allowed frames/s drop against the baseline in percent (default: 10)')
+    args = parser.parse_args()
+
+    results = run_configs(args.build_dir, args.passes, args.match, args.data)
+    baseline = None
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)["results"]
+
+    print_table(results, baseline)
+    if args.json:
+        if args.summary_only:
+            for r in results:
+                r.pop("checksums", None)
+        with open(args.json, 'w') as f:
+            json.dump({"passes": args.passes, "results": results}, f, indent=1)
+        print(f"💾 Wrote {len(results)} results to {args.json}")
+
+    if baseline and compare(results, baseline, args.tolerance):
+        sys.exit(1)
+    if args.agree and disagreements(results):
+        sys.exit(1)
+    print("✅ Done")
+
+
+if __name__ == '__main__':
+    main()
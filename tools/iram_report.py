@@ -0,0 +1,189 @@
+"""
+IRAM/DRAM placement report for the decoder and scaler hot path
+
+Usage:
+    python iram_report.py build/T4-Display.map [--lf main/linker.lf components/espressif__esp_jpeg/linker.lf]
+                          [--require-placed]
+
+Runs after every firmware link (see the top-level CMakeLists.txt). It reads the
+noflash / noflash_data entries of the linker fragments, looks up where each of
+those symbols was placed in the linker map and prints its size, so the IRAM
+cost of CONFIG_T4_HOT_PATH_IN_IRAM can be compared against the default flash
+placement. Symbols missing from the map were inlined into their caller (or
+unused).
+
+Each entry is matched against the archive its fragment names, so a wrong
+`archive:` line (which ldgen silently ignores) shows up as an error. With
+--require-placed (passed when CONFIG_T4_HOT_PATH_IN_IRAM is set) a listed
+symbol that is in the map but still in flash fails the build.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_LF = [
+    os.path.join(REPO_ROOT, "main", "linker.lf"),
+    os.path.join(REPO_ROOT, "components", "espressif__esp_jpeg", "linker.lf"),
+]
+
+LF_ARCHIVE_RE = re.compile(r"^\s*archive:\s*(\S+)")
+LF_ENTRY_RE = re.compile(r"^\s*(\w+):(\w+)\s+\((noflash|noflash_text|noflash_data)\)")
+MEM_RE = re.compile(r"^(\w+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+OUT_SECTION_RE = re.compile(r"^(\.\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+IN_SECTION_RE = re.compile(r"^ (\.\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S+)")
+MAP_OBJECT_RE = re.compile(r"([^/()]+\.a)\(([^()]+?)\.c(?:pp)?\.obj\)$")
+HOT_PREFIXES = (".literal.", ".text.", ".rodata.", ".data.")
+
+
+def load_hot_symbols(lf_paths):
+    """Return [(archive, object, symbol, scheme)] from the noflash entries of the fragments"""
+    symbols = []
+    archive = None
+    for path in lf_paths:
+        if not os.path.exists(path):
+            print(f"⚠️  Linker fragment not found: {path}")
+            continue
+        with open(path) as lf:
+            for line in lf:
+                m = LF_ARCHIVE_RE.match(line)
+                if m:
+                    archive = m.group(1)
+                    continue
+                m = LF_ENTRY_RE.match(line)
+                if m:
+                    symbols.append((archive,) + m.groups())
+    return symbols
+
+
+def parse_map(map_path):
+    """Return (memory regions {name: (origin, length)}, output sections [(name, addr, size)],
+    input sections [(name, out_section, size, object_file)])"""
+    regions = {}
+    out_sections = []
+    in_sections = []
+    with open(map_path, errors="replace") as mf:
+        lines = mf.read().splitlines()
+
+    state = None
+    current_out = None
+    pending = None
+    for line in lines:
+        if line.startswith("Memory Configuration"):
+            state = "memory"
+            continue
+        if line.startswith("Linker script and memory map"):
+            state = "layout"
+            continue
+        if state == "memory":
+            m = MEM_RE.match(line)
+            if m:
+                regions[m.group(1)] = (int(m.group(2), 16), int(m.group(3), 16))
+            continue
+        if state != "layout":
+            continue
+
+        # Long section names are wrapped onto the next line
+        if pending is not None:
+            line = pending + line
+            pending = None
+        elif re.match(r"^ ?\.\S+$", line):
+            pending = line
+            continue
+
+        m = OUT_SECTION_RE.match(line)
+        if m:
+            current_out = m.group(1)
+            out_sections.append((current_out, int(m.group(2), 16), int(m.group(3), 16)))
+            continue
+        m = IN_SECTION_RE.match(line)
+        if m and current_out:
+            in_sections.append((m.group(1), current_out, int(m.group(3), 16), m.group(4)))
+    return regions, out_sections, in_sections
+
+
+def region_kind(out_section):
+    if out_section.startswith(".iram"):
+        return "IRAM"
+    if out_section.startswith(".dram"):
+        return "DRAM"
+    if out_section.startswith(".flash"):
+        return "flash"
+    return out_section
+
+
+def report(symbols, regions, out_sections, in_sections, require_placed):
+    """Print the placement table; return the number of entries that did not land where listed"""
+    totals = {}
+    errors = 0
+    print(f"🔥 Hot-path placement ({len(symbols)} entries)")
+    print(f"   {'object':<14}{'symbol':<24}{'placed in':<16}{'bytes':>7}")
+    for archive, obj, sym, scheme in symbols:
+        size = 0
+        placed = set()
+        other_archives = set()
+        for name, out, sz, objfile in in_sections:
+            if not name.startswith(HOT_PREFIXES) or name.split(".", 2)[-1] != sym:
+                continue
+            m = MAP_OBJECT_RE.search(objfile)
+            if not m or m.group(2) != obj:
+                continue
+            if m.group(1) != archive:
+                other_archives.add(m.group(1))
+                continue
+            size += sz
+            placed.add(region_kind(out))
+        if other_archives:
+            print(f"   {obj:<14}{sym:<24}❌ fragment names {archive}, map has {', '.join(sorted(other_archives))}")
+            errors += 1
+            continue
+        if not placed:
+            print(f"   {obj:<14}{sym:<24}{'(not in map)':<16}{'-':>7}")
+            continue
+        kind = "/".join(sorted(placed))
+        print(f"   {obj:<14}{sym:<24}{kind:<16}{size:>7}")
+        totals[kind] = totals.get(kind, 0) + size
+        if require_placed and "flash" in placed:
+            print(f"   ❌ {obj}:{sym} is listed as {scheme} but is still in flash")
+            errors += 1
+
+    for kind in ("IRAM", "DRAM", "flash"):
+        if kind in totals:
+            print(f"   Σ {kind:<10}{totals[kind]:>8} bytes")
+
+    # Overall internal RAM headroom
+    for seg, (origin, length) in regions.items():
+        if not seg.startswith(("iram0_0_seg", "dram0_0_seg")):
+            continue
+        used = sum(size for _, addr, size in out_sections if origin <= addr < origin + length)
+        print(f"   {seg:<14} used {used:>7} / {length:>7} bytes ({length - used} free)")
+    return errors
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Report IRAM/DRAM placement of the decoder hot path.")
+    parser.add_argument('map', help='Linker map file (build/<project>.map)')
+    parser.add_argument('--lf', nargs='+', default=DEFAULT_LF, help='Linker fragment files to read entries from')
+    parser.add_argument('--require-placed', action='store_true',
+                        help='Fail if a listed symbol is in the map but still in flash')
+    args = parser.parse_args()
+
+    if not os.path.exists(args.map):
+        print(f"⚠️  Map file not found: {args.map}")
+        return
+    symbols = load_hot_symbols(args.lf)
+    if not symbols:
+        print("⚠️  No noflash entries found in the linker fragments")
+        return
+    regions, out_sections, in_sections = parse_map(args.map)
+    errors = report(symbols, regions, out_sections, in_sections, args.require_placed)
+    if errors:
+        print(f"❌ {errors} hot-path entries not placed as listed in the linker fragments")
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,110 @@
+"""
+Raw frame pack builder for CONFIG_T4_FRAME_SOURCE_PACK
+
+Usage:
+    python pack_frames.py data -o build/frames.pack [--manifest output/manifest.txt] [--partition-size 0x350000]
+
+Packs every file under the data directory into the layout of main/frame_pack.h:
+a header, a table of fixed-size entries (name hash, offset, size, name) with a
+CRC-32, padding to a 4 KB boundary and then the file data, each entry 4-byte
+aligned. The frames listed in the manifest come first and in manifest order, so
+the player can preload them with one bulk read of the start of the data region;
+the remaining files (test.jpg, the manifest itself, raw images) follow in path
+order. Files with identical contents (GIF holds) are stored once and their
+entries share the data. The top-level
+CMakeLists.txt runs this and flashes the result to the "storage" partition.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = b"T4PK"
+VERSION = 1
+NAME_LEN = 52
+DATA_ALIGN = 4096
+ENTRY_ALIGN = 4
+HEADER = struct.Struct("<4sHHIIII")
+ENTRY = struct.Struct("<III%ds" % NAME_LEN)
+DEFAULT_PARTITION_SIZE = 0x350000  # "storage" in partitions.csv
+
+
+def name_hash(name):
+    """FNV-1a, as frame_pack_name_hash()"""
+    h = 2166136261
+    for b in name.encode():
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def collect(data_dir, manifest):
+    """Entry names in pack order: manifest frames, then everything else"""
+    names = []
+    frame_dir = os.path.dirname(manifest)
+    with open(os.path.join(data_dir, manifest)) as f:
+        for line in f:
+            fields = line.split()
+            if fields:
+                name = "/".join(filter(None, [frame_dir, fields[0]]))
+                if name not in names:
+                    names.append(name)
+    others = []
+    for root, dirs, files in os.walk(data_dir):
+        dirs[:] = [d for d in dirs if not d.startswith(".")]
+        for fn in files:
+            if fn.startswith("."):
+                continue
+            rel = os.path.relpath(os.path.join(root, fn), data_dir).replace(os.sep, "/")
+            if rel not in names:
+                others.append(rel)
+    return names + sorted(others)
+
+
+def build(data_dir, manifest):
+    names = collect(data_dir, manifest)
+    table = bytearray()
+    data = bytearray()
+    stored = {}  # contents -> offset
+    for name in names:
+        if len(name.encode()) >= NAME_LEN:
+            sys.exit("name too long for the pack (max %d bytes): %s" % (NAME_LEN - 1, name))
+        path = os.path.join(data_dir, name)
+        if not os.path.isfile(path):
+            sys.exit("listed in the manifest but missing: %s" % path)
+        with open(path, "rb") as f:
+            blob = f.read()
+        if blob not in stored:
+            data += b"\0" * (-len(data) % ENTRY_ALIGN)
+            stored[blob] = len(data)
+            data += blob
+        table += ENTRY.pack(name_hash(name), stored[blob], len(blob), name.encode())
+
+    data_offset = HEADER.size + len(table)
+    data_offset += -data_offset % DATA_ALIGN
+    header = HEADER.pack(MAGIC, VERSION, ENTRY.size, len(names), data_offset, len(data), zlib.crc32(table))
+    pad = b"\xff" * (data_offset - HEADER.size - len(table))  # Erased flash
+    return header + table + pad + data, len(names)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build a raw frame pack for the storage partition")
+    parser.add_argument("data_dir", help="Directory imaged into the storage partition (data/)")
+    parser.add_argument("-o", "--output", required=True, help="Pack file to write")
+    parser.add_argument("--manifest", default="output/manifest.txt", help="Manifest, relative to data_dir")
+    parser.add_argument("--partition-size", type=lambda s: int(s, 0), default=DEFAULT_PARTITION_SIZE,
+                        help="Fail if the pack does not fit (default 0x%x)" % DEFAULT_PARTITION_SIZE)
+    args = parser.parse_args()
+
+    pack, count = build(args.data_dir, args.manifest)
+    if len(pack) > args.partition_size:
+        sys.exit("pack is %d bytes, partition holds %d" % (len(pack), args.partition_size))
+    with open(args.output, "wb") as f:
+        f.write(pack)
+    print("%s: %d entries, %d bytes (%.0f%% of the partition)" %
+          (args.output, count, len(pack), 100.0 * len(pack) / args.partition_size))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,219 @@
+"""
+Per-frame telemetry report for the T4 sequence player
+
+Usage:
+    python perf_report.py capture.bin [--manifest ../data/output/manifest.txt] [--bins 20]
+    python perf_report.py --port /dev/tty.usbserial-XXXX [--baud 115200] [--save capture.bin]
+
+The firmware keeps one binary record per displayed frame in a ring buffer
+(main/perf_telemetry.h) and writes the whole ring over the console UART when
+it receives a 'T'. This script either parses a raw capture of that UART
+(log text around the dump is ignored) or triggers and captures a dump itself
+with --port (requires pyserial).
+
+For every clip (frames are grouped by the "<clip>-NNN.jpg" names in the
+manifest) it prints p50/p90/p99/max per stage and an ASCII histogram per stage.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+import zlib
+from collections import OrderedDict
+
+MAGIC = b"T4PF"
+END_MAGIC = b"T4PE"
+HEADER_FMT = "<4sHHII"      # magic, version, record_size, count, dropped
+TRAILER_FMT = "<4sI"        # magic, crc32
+RECORD_FMT = "<8IHH"        # must match perf_frame_record_t
+DUMP_CMD = b"T"
+
+STAGES = [
+    ("prepare_us", "prepare"),
+    ("decode_us", "entropy+IDCT"),
+    ("color_us", "colour out"),
+    ("scale_us", "scale"),
+    ("spi_submit_us", "SPI submit"),
+    ("spi_complete_us", "SPI complete"),
+    ("sleep_us", "sleep"),
+]
+FIELDS = ["frame_index"] + [s[0] for s in STAGES] + ["flags", "reserved"]
+
+FLAG_DECODE_ERROR = 1 << 0
+FLAG_SPI_PENDING = 1 << 1
+FLAG_DUPLICATE = 1 << 2
+FLAG_PREVIEW = 1 << 3
+FLAG_LOOKAHEAD = 1 << 4
+FLAG_BLEND = 1 << 5
+
+
+def parse_dumps(data):
+    """Find every framed dump in a raw capture and return its records as dicts"""
+    records = []
+    header_size = struct.calcsize(HEADER_FMT)
+    trailer_size = struct.calcsize(TRAILER_FMT)
+    pos = 0
+    while True:
+        pos = data.find(MAGIC, pos)
+        if pos < 0:
+            break
+        if pos + header_size > len(data):
+            break
+        _, version, rec_size, count, dropped = struct.unpack_from(HEADER_FMT, data, pos)
+        body = pos + header_size
+        end = body + rec_size * count
+        if rec_size != struct.calcsize(RECORD_FMT) or end + trailer_size > len(data):
+            print(f"⚠️  Skipping malformed dump at offset {pos} (version {version}, record size {rec_size})")
+            pos += len(MAGIC)
+            continue
+        end_magic, crc = struct.unpack_from(TRAILER_FMT, data, end)
+        if end_magic != END_MAGIC or zlib.crc32(data[body:end]) != crc:
+            print(f"⚠️  Skipping corrupted dump at offset {pos} (bad trailer or CRC)")
+            pos += len(MAGIC)
+            continue
+        if dropped:
+            print(f"ℹ️  Dump at offset {pos}: {dropped} older records were overwritten on the device")
+        for i in range(count):
+            values = struct.unpack_from(RECORD_FMT, data, body + i * rec_size)
+            records.append(dict(zip(FIELDS, values)))
+        pos = end + trailer_size
+    return records
+
+
+def load_clip_names(manifest_path):
+    """Map manifest line index -> clip name ("larry-007.jpg" -> "larry")"""
+    names = []
+    with open(manifest_path) as mf:
+        for line in mf:
+            line = line.strip()
+            if not line:
+                continue
+            fname = line.split()[0]
+            stem = os.path.splitext(fname)[0]
+            names.append(stem.rsplit("-", 1)[0] if "-" in stem else stem)
+    return names
+
+
+def percentile(sorted_values, pct):
+    if not sorted_values:
+        return 0
+    k = (len(sorted_values) - 1) * pct / 100.0
+    lo = int(k)
+    hi = min(lo + 1, len(sorted_values) - 1)
+    return sorted_values[lo] + (sorted_values[hi] - sorted_values[lo]) * (k - lo)
+
+
+def histogram(values, bins, width=40):
+    """Return ASCII histogram lines for a list of microsecond values"""
+    lo, hi = min(values), max(values)
+    if hi == lo:
+        return [f"      {lo:>8} us | {'#' * width} {len(values)}"]
+    step = (hi - lo) / bins
+    counts = [0] * bins
+    for v in values:
+        counts[min(int((v - lo) / step), bins - 1)] += 1
+    peak = max(counts)
+    lines = []
+    for b, c in enumerate(counts):
+        bar = "#" * (round(c * width / peak) if c else 0)
+        lines.append(f"      {int(lo + b * step):>8} us | {bar} {c if c else ''}")
+    return lines
+
+
+def report(records, clip_names, bins):
+    clips = OrderedDict()
+    for rec in records:
+        idx = rec["frame_index"]
+        name = clip_names[idx] if clip_names and idx < len(clip_names) else "all"
+        clips.setdefault(name, []).append(rec)
+
+    for name, all_recs in clips.items():
+        errors = sum(1 for r in all_recs if r["flags"] & FLAG_DECODE_ERROR)
+        pending = sum(1 for r in all_recs if r["flags"] & FLAG_SPI_PENDING)
+        # Duplicate frames are held on screen without decode/SPI, scrub previews decode at a
+        # reduced scale and blended in-betweens do not decode; keep them out of the stage stats
+        previews = sum(1 for r in all_recs if r["flags"] & FLAG_PREVIEW)
+        blends = sum(1 for r in all_recs if r["flags"] & FLAG_BLEND)
+        recs = [r for r in all_recs if not r["flags"] & (FLAG_DUPLICATE | FLAG_PREVIEW | FLAG_BLEND)]
+        skipped = len(all_recs) - len(recs) - previews - blends
+        # Lookahead frames were decoded in an earlier frame's slack; their decode stages still count
+        ahead = sum(1 for r in recs if r["flags"] & FLAG_LOOKAHEAD)
+        print(f"\n🎬 Clip: {name} ({len(all_recs)} frames, {errors} decode errors, {pending} SPI pending, "
+              f"{skipped} duplicates skipped, {previews} scrub previews, {ahead} decoded ahead, "
+              f"{blends} in-betweens)")
+        if not recs:
+            continue
+        print(f"   {'stage':<14}{'p50':>9}{'p90':>9}{'p99':>9}{'max':>9}   (us)")
+        for key, label in STAGES:
+            vals = sorted(r[key] for r in recs)
+            print(f"   {label:<14}{percentile(vals, 50):>9.0f}{percentile(vals, 90):>9.0f}"
+                  f"{percentile(vals, 99):>9.0f}{vals[-1]:>9}")
+        busy = sorted(sum(r[k] for k, _ in STAGES[:5]) for r in recs)
+        print(f"   {'CPU busy':<14}{percentile(busy, 50):>9.0f}{percentile(busy, 90):>9.0f}"
+              f"{percentile(busy, 99):>9.0f}{busy[-1]:>9}")
+        for key, label in STAGES:
+            vals = [r[key] for r in recs]
+            if not any(vals):
+                continue
+            print(f"   📊 {label}")
+            for line in histogram(vals, bins):
+                print(line)
+
+
+def capture_from_port(port, baud, timeout):
+    """Send the dump command and return everything received until the trailer arrives"""
+    try:
+        import serial
+    except ImportError:
+        print("❌ pyserial is required for --port (pip install pyserial)")
+        sys.exit(1)
+    with serial.Serial(port, baud, timeout=0.2) as ser:
+        ser.reset_input_buffer()
+        ser.write(DUMP_CMD)
+        data = bytearray()
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            data += ser.read(4096)
+            end = data.rfind(END_MAGIC)
+            if end >= 0 and len(data) >= end + struct.calcsize(TRAILER_FMT):
+                break
+    return bytes(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Parse T4 per-frame telemetry dumps.")
+    parser.add_argument('capture', nargs='?', help='Raw UART capture containing one or more dumps')
+    parser.add_argument('--port', type=str, help='Serial port to trigger and capture a dump from')
+    parser.add_argument('--baud', type=int, default=115200, help='Serial baud rate (default: 115200)')
+    parser.add_argument('--timeout', type=float, default=10.0, help='Capture timeout in seconds (default: 10)')
+    parser.add_argument('--save', type=str, help='Write the raw capture to this file')
+    parser.add_argument('--manifest', type=str, help='manifest.txt used on the device, to group frames by clip')
+    parser.add_argument('--bins', type=int, default=12, help='Histogram bins per stage (default: 12)')
+    args = parser.parse_args()
+
+    if args.port:
+        data = capture_from_port(args.port, args.baud, args.timeout)
+        if args.save:
+            with open(args.save, 'wb') as f:
+                f.write(data)
+            print(f"💾 Saved {len(data)} bytes to {args.save}")
+    elif args.capture:
+        with open(args.capture, 'rb') as f:
+            data = f.read()
+    else:
+        parser.error("either a capture file or --port is required")
+
+    records = parse_dumps(data)
+    if not records:
+        print("❌ No telemetry records found")
+        sys.exit(1)
+    print(f"✅ Parsed {len(records)} frame records")
+
+    clip_names = load_clip_names(args.manifest) if args.manifest else None
+    report(records, clip_names, args.bins)
+
+
+if __name__ == '__main__':
+    main()
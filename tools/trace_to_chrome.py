@@ -0,0 +1,217 @@
+"""
+Span trace → Chrome trace-event JSON
+
+Usage:
+    python trace_to_chrome.py capture.bin [-o trace.json]
+    python trace_to_chrome.py --port /dev/tty.usbserial-XXXX [--baud 115200] [--save capture.bin] [-o trace.json]
+
+The firmware (CONFIG_T4_SPAN_TRACE) and the host build (t4_host --trace FILE)
+record begin/end events of the decode/display pipeline into one ring per core
+(main/span_trace.h). On the device, send 'S' over the console UART to dump the
+rings; this script parses a raw capture of that UART (log text around the dump
+is ignored) or triggers and captures a dump itself with --port (requires
+pyserial).
+
+Open the output in chrome://tracing or https://ui.perfetto.dev. Every core is
+one track. An extra "SPI transfer" track shows each draw from its submission
+until its colour-done interrupt, so overlap between decoding and bus traffic
+(or the lack of it) is visible at a glance.
+"""
+
+import argparse
+import json
+import struct
+import sys
+import time
+import zlib
+
+MAGIC = b"T4TR"
+END_MAGIC = b"T4TE"
+HEADER_FMT = "<4sHHHH"      # magic, version, record_size, cores, reserved
+CORE_FMT = "<III"           # core, count, dropped
+TRAILER_FMT = "<4sI"        # magic, crc32
+EVENT_FMT = "<IHBBI"        # must match span_event_t
+DUMP_CMD = b"S"
+
+# span_id_t order in main/span_trace.h: (name, meaning of arg)
+SPANS = [
+    ("frame", "frame"),
+    ("jd_prepare", None),
+    ("jd_decomp", None),
+    ("mcu_row", "line"),
+    ("scale", "src_row"),
+    ("draw_submit", "draw"),
+    ("dma_done", "draw"),
+    ("sleep", "frame"),
+    ("q565_decode", None),
+]
+SPAN_DRAW_SUBMIT = 5
+SPAN_DMA_DONE = 6
+SPI_TRACK = 100
+
+
+def parse_dumps(data):
+    """Find every framed dump in a raw capture; return [(core, dropped, [events])]"""
+    dumps = []
+    header_size = struct.calcsize(HEADER_FMT)
+    core_size = struct.calcsize(CORE_FMT)
+    trailer_size = struct.calcsize(TRAILER_FMT)
+    pos = 0
+    while True:
+        pos = data.find(MAGIC, pos)
+        if pos < 0 or pos + header_size > len(data):
+            break
+        _, version, rec_size, cores, _ = struct.unpack_from(HEADER_FMT, data, pos)
+        body = pos + header_size
+        cur = body
+        per_core = []
+        ok = rec_size == struct.calcsize(EVENT_FMT)
+        for _ in range(cores if ok else 0):
+            if cur + core_size > len(data):
+                ok = False
+                break
+            core, count, dropped = struct.unpack_from(CORE_FMT, data, cur)
+            cur += core_size
+            if cur + count * rec_size > len(data):
+                ok = False
+                break
+            events = [struct.unpack_from(EVENT_FMT, data, cur + i * rec_size) for i in range(count)]
+            cur += count * rec_size
+            per_core.append((core, dropped, events))
+        if not ok or cur + trailer_size > len(data):
+            print(f"⚠️  Skipping malformed dump at offset {pos} (version {version})", file=sys.stderr)
+            pos += len(MAGIC)
+            continue
+        end_magic, crc = struct.unpack_from(TRAILER_FMT, data, cur)
+        if end_magic != END_MAGIC or zlib.crc32(data[body:cur]) != crc:
+            print(f"⚠️  Skipping corrupted dump at offset {pos} (bad trailer or CRC)", file=sys.stderr)
+            pos += len(MAGIC)
+            continue
+        dumps.extend(per_core)
+        pos = cur + trailer_size
+    return dumps
+
+
+def unwrap(events):
+    """32-bit µs timestamps → monotonic 64-bit (wraps every ~71 minutes)"""
+    out = []
+    base = 0
+    last = None
+    for ts, sid, phase, core, arg in events:
+        if last is not None and ts < last and last - ts > 0x80000000:
+            base += 1 << 32
+        last = ts
+        out.append((base + ts, sid, chr(phase), core, arg))
+    return out
+
+
+def span_name(sid):
+    return SPANS[sid][0] if sid < len(SPANS) else f"span{sid}"
+
+
+def span_args(sid, arg):
+    label = SPANS[sid][1] if sid < len(SPANS) else "arg"
+    return {label: arg} if label else {}
+
+
+def convert(dumps):
+    trace = []
+    unmatched = 0
+    submits = {}    # draw sequence -> submit timestamp
+    t0 = None
+    cores = set()
+    all_events = []
+    for core, dropped, events in dumps:
+        if dropped:
+            print(f"ℹ️  Core {core}: {dropped} older events were overwritten on the device", file=sys.stderr)
+        all_events.extend(unwrap(events))
+    all_events.sort(key=lambda e: e[0])
+    if all_events:
+        t0 = all_events[0][0]
+
+    stacks = {}     # (core, span id) -> [begin timestamps]
+    for ts, sid, phase, core, arg in all_events:
+        cores.add(core)
+        t = ts - t0
+        if phase == 'B':
+            stacks.setdefault((core, sid), []).append((t, arg))
+            if sid == SPAN_DRAW_SUBMIT:
+                submits[arg] = t
+        elif phase == 'E':
+            stack = stacks.get((core, sid))
+            if not stack:
+                unmatched += 1
+                continue
+            begin, barg = stack.pop()
+            trace.append({"name": span_name(sid), "ph": "X", "ts": begin, "dur": t - begin,
+                          "pid": 0, "tid": core, "args": span_args(sid, barg)})
+        elif phase == 'i':
+            trace.append({"name": span_name(sid), "ph": "i", "s": "t", "ts": t,
+                          "pid": 0, "tid": core, "args": span_args(sid, arg)})
+            if sid == SPAN_DMA_DONE and arg in submits:
+                begin = submits.pop(arg)
+                trace.append({"name": f"draw {arg}", "ph": "X", "ts": begin, "dur": t - begin,
+                              "pid": 0, "tid": SPI_TRACK, "args": {"draw": arg}})
+    unmatched += sum(len(s) for s in stacks.values())
+
+    meta = [{"name": "process_name", "ph": "M", "pid": 0, "args": {"name": "T4 player"}}]
+    for core in sorted(cores):
+        meta.append({"name": "thread_name", "ph": "M", "pid": 0, "tid": core, "args": {"name": f"core {core}"}})
+    meta.append({"name": "thread_name", "ph": "M", "pid": 0, "tid": SPI_TRACK, "args": {"name": "SPI transfer"}})
+    return meta + trace, len(all_events), unmatched
+
+
+def capture_from_port(port, baud, timeout):
+    """Send the dump command and return everything received until the trailer arrives"""
+    try:
+        import serial
+    except ImportError:
+        print("❌ pyserial is required for --port (pip install pyserial)")
+        sys.exit(1)
+    with serial.Serial(port, baud, timeout=0.2) as ser:
+        ser.reset_input_buffer()
+        ser.write(DUMP_CMD)
+        data = bytearray()
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            data += ser.read(4096)
+            end = data.rfind(END_MAGIC)
+            if end >= 0 and len(data) >= end + struct.calcsize(TRAILER_FMT):
+                break
+    return bytes(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert T4 span trace dumps to Chrome trace-event JSON.")
+    parser.add_argument('capture', nargs='?', help='Raw UART capture or t4_host --trace file')
+    parser.add_argument('-o', '--output', type=str, default='trace.json', help='Output JSON (default: trace.json)')
+    parser.add_argument('--port', type=str, help='Serial port to trigger and capture a dump from')
+    parser.add_argument('--baud', type=int, default=115200, help='Serial baud rate (default: 115200)')
+    parser.add_argument('--timeout', type=float, default=10.0, help='Capture timeout in seconds (default: 10)')
+    parser.add_argument('--save', type=str, help='Write the raw capture to this file')
+    args = parser.parse_args()
+
+    if args.port:
+        data = capture_from_port(args.port, args.baud, args.timeout)
+        if args.save:
+            with open(args.save, 'wb') as f:
+                f.write(data)
+            print(f"💾 Saved {len(data)} bytes to {args.save}")
+    elif args.capture:
+        with open(args.capture, 'rb') as f:
+            data = f.read()
+    else:
+        parser.error("either a capture file or --port is required")
+
+    dumps = parse_dumps(data)
+    if not dumps:
+        print("❌ No span trace dumps found")
+        sys.exit(1)
+    events, count, unmatched = convert(dumps)
+    with open(args.output, 'w') as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, f)
+    print(f"✅ {count} events → {args.output}" + (f" ({unmatched} unmatched begin/end dropped)" if unmatched else ""))
+
+
+if __name__ == '__main__':
+    main()